@@ -8,6 +8,7 @@
 #pragma once
 
 #include <math.h>
+#include "dsf_phasor.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846f
@@ -38,16 +39,25 @@ public:
         throughZero_ = false;
         phaseReversed_ = false;
         currentAmplitude_ = 0.0f;
+        recursive_ = false;
+        usePhasors_ = false;
+        lastPhaseInc_ = 0.0f;
+        lastHarmonics_ = 0;
     }
     
     void Init(float sampleRate) {
         sampleRate_ = sampleRate;
         phase_ = 0.0f;
         UpdatePhaseIncrement();
+        phasors_.Invalidate();
     }
     
     float Process() {
         float output = 0.0f;
+
+        if (recursive_) {
+            UpdatePhasors();
+        }
         
         switch(algorithm_) {
             case CLASSIC_DSF:
@@ -81,6 +91,9 @@ public:
         if (phase_ < 0.0f) {
             phase_ += M_TWOPI;
         }
+        if (usePhasors_) {
+            phasors_.Rotate();
+        }
         
         return output;
     }
@@ -113,6 +126,18 @@ public:
         algorithm_ = alg;
     }
     
+    // Recursive evaluation: the DSF kernels read rotating phasors instead of
+    // calling sinf/cosf while the frequency holds (see dsf_phasor.h).
+    // Samples where the frequency just changed, as under audio-rate FM, are
+    // evaluated directly.
+    void SetRecursive(bool enable) {
+        recursive_ = enable;
+        if (!enable) {
+            usePhasors_ = false;
+            phasors_.Invalidate();
+        }
+    }
+
     void SetThroughZero(bool enable) {
         throughZero_ = enable;
         if (!enable) {
@@ -128,6 +153,7 @@ public:
     float GetPhase() const { return phase_; }
     float GetCurrentAmplitude() const { return currentAmplitude_; }
     Algorithm GetCurrentAlgorithm() const { return algorithm_; }
+    bool IsRecursive() const { return recursive_; }
     
 private:
     float phase_;
@@ -141,10 +167,36 @@ private:
     bool throughZero_;
     bool phaseReversed_;
     float currentAmplitude_;
+
+    // Recursive evaluation state
+    DSFPhasors phasors_;
+    bool recursive_;
+    bool usePhasors_;   // Phasors hold this sample's phase
+    float lastPhaseInc_;
+    int lastHarmonics_;
     
     void UpdatePhaseIncrement() {
         phaseInc_ = (M_TWOPI * freq_) / sampleRate_;
     }
+
+    /**
+     * Keeps the phasors rotating while the increment and N hold, resyncs
+     * them on schedule, and drops to direct evaluation for a sample when
+     * either just changed.
+     */
+    void UpdatePhasors() {
+        if (phasors_.InSync(phaseInc_, numHarmonics_)) {
+            usePhasors_ = true;
+        } else if (phaseInc_ == lastPhaseInc_ && numHarmonics_ == lastHarmonics_) {
+            phasors_.Sync(phase_, phaseInc_, numHarmonics_);
+            usePhasors_ = true;
+        } else {
+            phasors_.Invalidate();
+            usePhasors_ = false;
+        }
+        lastPhaseInc_ = phaseInc_;
+        lastHarmonics_ = numHarmonics_;
+    }
     
     /**
      * Classic DSF - Moorer 1976
@@ -154,13 +206,24 @@ private:
         float N = (float)numHarmonics_;
         float a = alpha_;
         
+        float sinPhase, cosNPhase, sinDiff;
+        if (usePhasors_) {
+            sinPhase = phasors_.Sin1();
+            cosNPhase = phasors_.CosN();
+            sinDiff = phasors_.SinDifference();
+        } else {
+            sinPhase = sinf(phase_);
+            cosNPhase = cosf(N * phase_);
+            sinDiff = sinf(phase_ - N * phase_);
+        }
+        
         // Avoid division by zero
-        float denominator = 1.0f + a*a - 2.0f*a*cosf(N * phase_);
+        float denominator = 1.0f + a*a - 2.0f*a*cosNPhase;
         if (fabsf(denominator) < 1e-10f) {
             return 0.0f;
         }
         
-        float numerator = sinf(phase_) - a * sinf(phase_ - N * phase_);
+        float numerator = sinPhase - a * sinDiff;
         
         return numerator / denominator;
     }
@@ -175,16 +238,32 @@ private:
         
         // Carrier and modulator phases
         float modPhase = phase_ * N;
-        float modulated = phase_ + beta * sinf(modPhase);
+        float sinMod, cosMod;
+        if (usePhasors_) {
+            sinMod = phasors_.SinN();
+            cosMod = phasors_.CosN();
+        } else {
+            sinMod = sinf(modPhase);
+            cosMod = cosf(modPhase);
+        }
+        float modulated = phase_ + beta * sinMod;
         
         float a = alpha_;
-        float denominator = 1.0f + a*a - 2.0f*a*cosf(modPhase);
+        float denominator = 1.0f + a*a - 2.0f*a*cosMod;
         
         if (fabsf(denominator) < 1e-10f) {
             return 0.0f;
         }
         
-        float numerator = sinf(modulated) - a * sinf(modulated - modPhase);
+        float sinModulated = sinf(modulated);
+        float sinDiff;
+        if (usePhasors_) {
+            // sin(modulated - modPhase) from the modulator phasor
+            sinDiff = sinModulated * cosMod - cosf(modulated) * sinMod;
+        } else {
+            sinDiff = sinf(modulated - modPhase);
+        }
+        float numerator = sinModulated - a * sinDiff;
         
         return numerator / denominator;
     }
@@ -210,6 +289,10 @@ private:
         float N = (float)numHarmonics_;
         float a = alpha_;
         
+        if (usePhasors_) {
+            return ComplexDSFFromPhasors(a);
+        }
+        
         // First term (fundamental)
         float denom1 = 1.0f + a*a - 2.0f*a*cosf(N * phase_);
         float term1 = 0.0f;
@@ -229,6 +312,30 @@ private:
         return term1 + 0.5f * term2;
     }
     
+    /**
+     * Complex DSF from the phasors: both terms share cos(N * phase), and
+     * the second harmonic is z1 squared.
+     */
+    float ComplexDSFFromPhasors(float a) {
+        const float s1 = phasors_.Sin1();
+        const float c1 = phasors_.Cos1();
+        const float sN = phasors_.SinN();
+        const float cN = phasors_.CosN();
+        
+        float denom = 1.0f + a*a - 2.0f*a*cN;
+        if (fabsf(denom) <= 1e-10f) {
+            return 0.0f;
+        }
+        
+        float term1 = (s1 - a * phasors_.SinDifference()) / denom;
+        
+        float s2 = 2.0f * s1 * c1;
+        float c2 = c1 * c1 - s1 * s1;
+        float term2 = (s2 - a * (s2 * cN - c2 * sN)) / denom;
+        
+        return term1 + 0.5f * term2;
+    }
+    
     /**
      * Soft clipping waveshaper
      */
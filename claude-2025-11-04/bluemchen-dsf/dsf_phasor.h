@@ -0,0 +1,98 @@
+/**
+ * Recursive phasors for the DSF kernels
+ *
+ * The DSF formulas need sin and cos of phase and of N * phase every sample.
+ * While the phase increment stays fixed these are two unit phasors,
+ * z1 = e^(i phase) and zN = e^(i N phase), each rotated by a constant
+ * every sample, so a sample costs a few multiplies instead of several
+ * trig calls. Anything built from them (sin(phase - N phase), the second
+ * harmonic) comes from complex products.
+ *
+ * Drift is bounded two ways. Every rotation pulls the phasor lengths back
+ * to one with a first-order correction, so amplitude error cannot build up.
+ * Every kResyncInterval samples both phasors are rebuilt from the owner's
+ * phase, so angle error cannot grow past what that many samples gather.
+ * In practice that is dominated by the float phase accumulator's own
+ * rounding (the phasors rotate by the exact increment), about 1e-4 of
+ * full scale for typical settings. The owner also resyncs whenever the
+ * increment or N changes.
+ */
+
+#pragma once
+
+#include <math.h>
+
+class DSFPhasors {
+public:
+    static constexpr int kResyncInterval = 32;
+
+    DSFPhasors()
+        : valid_(false), increment_(0.0f), harmonics_(0), count_(0),
+          c1_(1.0f), s1_(0.0f), cN_(1.0f), sN_(0.0f),
+          rc1_(1.0f), rs1_(0.0f), rcN_(1.0f), rsN_(0.0f) {}
+
+    // Forces a Sync() before the next rotation.
+    void Invalidate() {
+        valid_ = false;
+    }
+
+    // True while the phasors can be rotated for this increment and N.
+    bool InSync(float increment, int harmonics) const {
+        return valid_ && count_ < kResyncInterval && increment == increment_ && harmonics == harmonics_;
+    }
+
+    // Rebuilds both phasors at phase, and the rotations when the increment
+    // or N changed.
+    void Sync(float phase, float increment, int harmonics) {
+        const float n = (float)harmonics;
+        c1_ = cosf(phase);
+        s1_ = sinf(phase);
+        cN_ = cosf(n * phase);
+        sN_ = sinf(n * phase);
+        if (!valid_ || increment != increment_ || harmonics != harmonics_) {
+            rc1_ = cosf(increment);
+            rs1_ = sinf(increment);
+            rcN_ = cosf(n * increment);
+            rsN_ = sinf(n * increment);
+            increment_ = increment;
+            harmonics_ = harmonics;
+        }
+        count_ = 0;
+        valid_ = true;
+    }
+
+    // Advances both phasors by one increment.
+    void Rotate() {
+        RotateOne(c1_, s1_, rc1_, rs1_);
+        RotateOne(cN_, sN_, rcN_, rsN_);
+        ++count_;
+    }
+
+    float Cos1() const { return c1_; }
+    float Sin1() const { return s1_; }
+    float CosN() const { return cN_; }
+    float SinN() const { return sN_; }
+
+    // sin(phase - N * phase)
+    float SinDifference() const { return s1_ * cN_ - c1_ * sN_; }
+
+private:
+    static void RotateOne(float& c, float& s, float rc, float rs) {
+        const float nc = c * rc - s * rs;
+        const float ns = s * rc + c * rs;
+        // One Newton step towards |z| = 1; exact enough since |z| stays
+        // within a few ulps of one.
+        const float g = 1.5f - 0.5f * (nc * nc + ns * ns);
+        c = nc * g;
+        s = ns * g;
+    }
+
+    bool valid_;
+    float increment_;
+    int harmonics_;
+    int count_;
+    float c1_, s1_;
+    float cN_, sN_;
+    float rc1_, rs1_;
+    float rcN_, rsN_;
+};
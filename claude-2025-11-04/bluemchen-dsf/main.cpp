@@ -326,12 +326,14 @@ int main(void) {
     osc1.SetNumHarmonics(20);
     osc1.SetAlpha(0.5f);
     osc1.SetAlgorithm(DSFOscillator::CLASSIC_DSF);
+    osc1.SetRecursive(true);  // Falls back to direct trig under TZ-FM
     
     osc2.Init(sampleRate);
     osc2.SetBaseFreq(440.0f * 1.005f);  // Slight detune for default stereo
     osc2.SetNumHarmonics(20);
     osc2.SetAlpha(0.5f);
     osc2.SetAlgorithm(DSFOscillator::CLASSIC_DSF);
+    osc2.SetRecursive(true);
     
     // Initialize smoothing filters
     freqSmooth.Init();
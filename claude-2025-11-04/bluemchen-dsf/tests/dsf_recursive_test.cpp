@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+#include "dsf_oscillator.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kLongRender = 48000 * 600; // Ten minutes
+constexpr size_t kWindow = 48000;            // Error is also tracked over the first and last second
+constexpr size_t kBenchSamples = 48000;
+constexpr int kPasses = 5;
+// Recursive error against a double-precision reference, relative to peak.
+// Most of it is the float phase accumulator's rounding between resyncs,
+// which the phasors do not follow; what matters is that it stays put.
+constexpr double kMaxRelativeError = 1.0e-3;
+constexpr double kMaxGrowth = 1.5; // Last second against the first
+
+using Clock = std::chrono::steady_clock;
+
+struct Case
+{
+    const char *name;
+    DSFOscillator::Algorithm algorithm;
+    float freq;
+    int harmonics;
+    float alpha;
+};
+
+const Case kCases[] = {
+    {"classic", DSFOscillator::CLASSIC_DSF, 110.0f, 20, 0.5f},
+    {"classic", DSFOscillator::CLASSIC_DSF, 1234.5f, 7, 0.9f},
+    {"classic", DSFOscillator::CLASSIC_DSF, 31.7f, 100, 0.7f},
+    {"mod fm", DSFOscillator::MODIFIED_FM, 220.0f, 5, 0.3f},
+    {"shape", DSFOscillator::WAVESHAPE, 440.0f, 12, 0.6f},
+    {"complex", DSFOscillator::COMPLEX_DSF, 330.0f, 9, 0.8f},
+};
+
+void Configure(DSFOscillator &osc, const Case &c, bool recursive)
+{
+    osc.Init(kSampleRate);
+    osc.SetAlgorithm(c.algorithm);
+    osc.SetNumHarmonics(c.harmonics);
+    osc.SetAlpha(c.alpha);
+    osc.SetFreq(c.freq);
+    osc.SetRecursive(recursive);
+}
+
+// The kernels in double, at the oscillator's own float phase.
+double DSFTerm(double phase, double n, double a)
+{
+    return (std::sin(phase) - a * std::sin(phase - n * phase)) / (1.0 + a * a - 2.0 * a * std::cos(n * phase));
+}
+
+double Reference(const Case &c, double phase)
+{
+    const double n = c.harmonics;
+    const double a = c.alpha;
+    switch (c.algorithm)
+    {
+    case DSFOscillator::MODIFIED_FM:
+    {
+        const double modPhase = phase * n;
+        const double modulated = phase + a * 10.0 * std::sin(modPhase);
+        return (std::sin(modulated) - a * std::sin(modulated - modPhase)) / (1.0 + a * a - 2.0 * a * std::cos(modPhase));
+    }
+    case DSFOscillator::WAVESHAPE:
+    {
+        const double x = DSFTerm(phase, n, a) * a * 5.0;
+        if (x > 1.0)
+            return 2.0 / 3.0 + (x - 1.0) / 3.0;
+        if (x < -1.0)
+            return -2.0 / 3.0 + (x + 1.0) / 3.0;
+        return x - x * x * x / 3.0;
+    }
+    case DSFOscillator::COMPLEX_DSF:
+        return DSFTerm(phase, n, a) + 0.5 * (std::sin(2.0 * phase) - a * std::sin(2.0 * phase - n * phase)) /
+                                          (1.0 + a * a - 2.0 * a * std::cos(n * phase));
+    default:
+        return DSFTerm(phase, n, a);
+    }
+}
+
+struct Errors
+{
+    double direct;
+    double recursive;
+    double recursiveFirst; // Over the first and last second, to show drift
+    double recursiveLast;  // does not build up
+};
+
+// Both modes against the reference over a long render with a fixed
+// frequency, relative to the reference peak.
+Errors LongRenderErrors(const Case &c)
+{
+    DSFOscillator direct;
+    DSFOscillator recursive;
+    Configure(direct, c, false);
+    Configure(recursive, c, true);
+    double peak = 0.0;
+    Errors e = {0.0, 0.0, 0.0, 0.0};
+    for (size_t n = 0; n < kLongRender; ++n)
+    {
+        const double ref = Reference(c, direct.GetPhase());
+        const double errDirect = std::fabs(direct.Process() - ref);
+        const double errRecursive = std::fabs(recursive.Process() - ref);
+        peak = std::max(peak, std::fabs(ref));
+        e.direct = std::max(e.direct, errDirect);
+        e.recursive = std::max(e.recursive, errRecursive);
+        if (n < kWindow)
+            e.recursiveFirst = std::max(e.recursiveFirst, errRecursive);
+        if (n >= kLongRender - kWindow)
+            e.recursiveLast = std::max(e.recursiveLast, errRecursive);
+    }
+    e.direct /= peak;
+    e.recursive /= peak;
+    e.recursiveFirst /= peak;
+    e.recursiveLast /= peak;
+    return e;
+}
+
+// With the frequency moving every sample (audio-rate FM) the recursive
+// mode must fall back to the direct formula exactly.
+bool FmMatchesDirect(const Case &c)
+{
+    DSFOscillator direct;
+    DSFOscillator recursive;
+    Configure(direct, c, false);
+    Configure(recursive, c, true);
+    for (size_t n = 0; n < kWindow; ++n)
+    {
+        const float wobble = 1.0f + 0.1f * std::sin(0.001f * static_cast<float>(n));
+        const float freq = c.freq * wobble * ((n & 1) ? 1.2f : 0.8f);
+        direct.SetFreq(freq);
+        recursive.SetFreq(freq);
+        if (direct.Process() != recursive.Process())
+            return false;
+    }
+    return true;
+}
+
+double NsPerSample(const Case &c, bool recursive)
+{
+    DSFOscillator osc;
+    double best = 1.0e30;
+    volatile float sink = 0.0f;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        Configure(osc, c, recursive);
+        float acc = 0.0f;
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kBenchSamples; ++n)
+            acc += osc.Process();
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        sink = acc;
+    }
+    (void)sink;
+    return best / kBenchSamples;
+}
+} // namespace
+
+int main()
+{
+    std::printf("DSF error vs double reference over %zu s, relative to peak; ns/sample\n", kLongRender / 48000);
+    std::printf("%8s%9s%5s%6s%11s%11s%11s%11s%5s%9s%9s\n", "algo", "freq", "N", "a", "direct", "recursive",
+                "first s", "last s", "fm", "direct", "recurs");
+
+    bool ok = true;
+    for (const Case &c : kCases)
+    {
+        const Errors e = LongRenderErrors(c);
+        const bool fm = FmMatchesDirect(c);
+        const double directNs = NsPerSample(c, false);
+        const double recursiveNs = NsPerSample(c, true);
+        const bool pass = e.recursive <= kMaxRelativeError && e.recursiveLast <= kMaxGrowth * e.recursiveFirst && fm;
+        ok = ok && pass;
+        std::printf("%8s%9.1f%5d%6.2f%11.2e%11.2e%11.2e%11.2e%5s%9.2f%9.2f%s\n", c.name,
+                    static_cast<double>(c.freq), c.harmonics, static_cast<double>(c.alpha), e.direct, e.recursive,
+                    e.recursiveFirst, e.recursiveLast, fm ? "ok" : "no", directNs, recursiveNs, pass ? "" : "  FAIL");
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "Recursive DSF test failed (drift or FM fallback mismatch).\n");
+        return 1;
+    }
+    return 0;
+}
@@ -2,6 +2,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+
+#include "disyn_phase.h"
 
 namespace disyn {
 
@@ -12,43 +15,50 @@ namespace disyn {
 constexpr float kTwoPi = 2.0f * static_cast<float>(M_PI);
 constexpr float kEpsilon = 1e-8f;
 
-inline float StepPhase(float currentPhase, float frequency, float sampleRate) {
-    const float next = currentPhase + frequency / sampleRate;
+inline float AdvancePhase(float currentPhase, float increment) {
+    const float next = currentPhase + increment;
     return next - std::floor(next);
 }
 
+inline float StepPhase(float currentPhase, float frequency, float sampleRate) {
+    return AdvancePhase(currentPhase, frequency / sampleRate);
+}
+
 inline float ExpoMap(float value, float min, float max) {
     const float clamped = std::clamp(value, 0.0f, 1.0f);
     return min * std::pow(max / min, clamped);
 }
 
-inline float ComputeDSFComponent(float w, float t, float decay) {
-    const float denominator = 1.0f - 2.0f * decay * std::cos(t) + decay * decay;
+// DSF term for phases w and t. normalise is sqrt(1 - decay^2), passed in so
+// block renders compute it once.
+inline float ComputeDSFComponent(uint32_t w, uint32_t t, float decay, float normalise) {
+    const float denominator = 1.0f - 2.0f * decay * CosineLookup(t) + decay * decay;
     if (std::abs(denominator) < kEpsilon) {
         return 0.0f;
     }
 
-    const float numerator = std::sin(w) - decay * std::sin(w - t);
-    const float normalise = std::sqrt(1.0f - decay * decay);
+    const float numerator = SineLookup(w) - decay * SineLookup(w - t);
     return (numerator / denominator) * normalise;
 }
 
-inline float ProcessAsymmetricFM(float param1, float param2, float frequency,
-                                 float sampleRate, float& carrierPhaseRef, float& modPhaseRef) {
-    const float k = ExpoMap(param1, 0.01f, 10.0f);
-    const float r = ExpoMap(param2, 0.5f, 2.0f);
-    const float modFreq = frequency;
-
-    carrierPhaseRef = StepPhase(carrierPhaseRef, frequency, sampleRate);
-    modPhaseRef = StepPhase(modPhaseRef, modFreq, sampleRate);
+// Asymmetric FM from mapped values: k is the index and rSpread is r - 1/r.
+inline float ProcessAsymmetricFM(float k, float rSpread, uint32_t increment,
+                                 uint32_t& carrierPhaseRef, uint32_t& modPhaseRef) {
+    carrierPhaseRef += increment;
+    modPhaseRef += increment;
 
-    const float modulator = std::sin(kTwoPi * modPhaseRef);
-    const float asymmetry = std::exp(k * (r - 1.0f / r) * std::cos(kTwoPi * modPhaseRef) / 2.0f);
-    const float carrier = std::cos(kTwoPi * carrierPhaseRef + k * modulator);
+    const float modulator = SineLookup(modPhaseRef);
+    const float asymmetry = std::exp(k * rSpread * CosineLookup(modPhaseRef) / 2.0f);
+    const float carrier = CosineLookup(carrierPhaseRef + RadiansToPhase(k * modulator));
 
     return carrier * asymmetry * 0.5f;
 }
 
+inline float AsymmetricFMSpread(float param2) {
+    const float r = ExpoMap(param2, 0.5f, 2.0f);
+    return r - 1.0f / r;
+}
+
 inline float WrapAngle(float x) {
     float wrapped = x;
     while (wrapped > static_cast<float>(M_PI)) {
@@ -6,6 +6,7 @@
 
 #include "disyn_algorithm_output.h"
 #include "disyn_algorithm_utils.h"
+#include "disyn_shape_cache.h"
 
 namespace disyn {
 
@@ -31,486 +32,702 @@ enum class AlgorithmType : int {
     TRAJECTORY = 18
 };
 
+// Each algorithm (except Trajectory) splits its work in two:
+// ComputeControls() maps pitch and the normalised params to everything that
+// does not depend on the running phase (ExpoMap, pow, exp, phase
+// increments), and Render() produces one sample from those. Process() does
+// both per sample; DisynOscillator::ProcessBlock() computes the controls
+// once per block and ramps them. Controls hold only floats so they can be
+// interpolated; integer settings are stored as whole numbers and rounded
+// back in Render(). Phases are 32-bit accumulators read through the shared
+// sine table (disyn_phase.h), and increments travel as phase units.
+//
+// Combination3 and Novel1 can read their exp/tanh terms from a ShapeCache
+// (disyn_shape_cache.h) once SetShapeCache(true) is called. The cache is
+// static, one per algorithm, since every oscillator and voice shares the
+// params; BuildShapeCache() fills it outside the audio callback.
+
 class DirichletPulseAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float harmonics;
+        float tiltFactor;
+        float shape;
+        float drive;
+    };
+
     explicit DirichletPulseAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u) {}
 
-    void Reset() { phase = 0.0f; }
+    void Reset() { phase = 0u; }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const int harmonics = std::max(1, static_cast<int>(std::round(1.0f + param1 * 63.0f)));
         const float tilt = -3.0f + param2 * 18.0f;
         const float shape = std::clamp(param3, 0.0f, 1.0f);
+        return {PhaseIncrement(pitch, sampleRate), static_cast<float>(harmonics), std::pow(10.0f, tilt / 20.0f),
+                shape, 1.0f + shape * 4.0f};
+    }
+
+    AlgorithmOutput Render(const Controls& c) {
+        const int harmonics = static_cast<int>(c.harmonics + 0.5f);
 
-        phase = StepPhase(phase, pitch, sampleRate);
-        const float theta = phase * kTwoPi;
+        phase += PhaseStep(c.increment);
 
-        const float numerator = std::sin((2.0f * harmonics + 1.0f) * theta * 0.5f);
-        const float denominator = std::sin(theta * 0.5f);
+        // sin((2N + 1) theta / 2) / sin(theta / 2) on half-angle phases; the
+        // product is taken in 64 bits so it wraps like the angle does.
+        const uint64_t multiple = static_cast<uint64_t>(2 * harmonics + 1);
+        const float numerator = SineLookup(static_cast<uint32_t>((static_cast<uint64_t>(phase) * multiple) >> 1));
+        const float denominator = SineLookup(phase >> 1);
 
         float value = 1.0f;
         if (std::abs(denominator) >= kEpsilon) {
             value = (numerator / denominator) - 1.0f;
         }
 
-        const float tiltFactor = std::pow(10.0f, tilt / 20.0f);
-        const float base = (value / static_cast<float>(harmonics)) * tiltFactor;
-        const float shaped = std::tanh(base * (1.0f + shape * 4.0f));
-        const float output = base * (1.0f - shape) + shaped * shape;
+        const float base = (value / static_cast<float>(harmonics)) * c.tiltFactor;
+        const float shaped = std::tanh(base * c.drive);
+        const float output = base * (1.0f - c.shape) + shaped * c.shape;
         return {output, base};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
+    uint32_t phase;
 };
 
 class DSFSingleAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float secondaryIncrement;
+        float decay;
+        float normalise;
+        float mix;
+    };
+
     explicit DSFSingleAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), secondaryPhase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), secondaryPhase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        secondaryPhase = 0.0f;
+        phase = 0u;
+        secondaryPhase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float decay = std::min(param1 * 0.98f, 0.98f);
         const float ratio = ExpoMap(param2, 0.5f, 4.0f);
-        const float mix = std::clamp(param3, 0.0f, 1.0f);
-
-        phase = StepPhase(phase, pitch, sampleRate);
-        secondaryPhase = StepPhase(secondaryPhase, pitch * ratio, sampleRate);
+        return {PhaseIncrement(pitch, sampleRate), PhaseIncrement(pitch * ratio, sampleRate), decay,
+                std::sqrt(1.0f - decay * decay), std::clamp(param3, 0.0f, 1.0f)};
+    }
 
-        const float w = phase * kTwoPi;
-        const float t = secondaryPhase * kTwoPi;
+    AlgorithmOutput Render(const Controls& c) {
+        phase += PhaseStep(c.increment);
+        secondaryPhase += PhaseStep(c.secondaryIncrement);
 
-        const float dsf = ComputeDSFComponent(w, t, decay) * 0.5f;
-        const float sine = std::sin(w) * 0.5f;
-        const float output = dsf * (1.0f - mix) + sine * mix;
+        const float dsf = ComputeDSFComponent(phase, secondaryPhase, c.decay, c.normalise) * 0.5f;
+        const float sine = SineLookup(phase) * 0.5f;
+        const float output = dsf * (1.0f - c.mix) + sine * c.mix;
         return {output, dsf};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
-    float secondaryPhase;
+    uint32_t phase;
+    uint32_t secondaryPhase;
 };
 
 class DSFDoubleAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float secondaryIncrement;
+        float decay;
+        float normalise;
+        float weightPos;
+        float weightNeg;
+    };
+
     explicit DSFDoubleAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), secondaryPhase(0.0f), secondaryPhaseNeg(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), secondaryPhase(0u), secondaryPhaseNeg(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        secondaryPhase = 0.0f;
-        secondaryPhaseNeg = 0.0f;
+        phase = 0u;
+        secondaryPhase = 0u;
+        secondaryPhaseNeg = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float decay = std::min(param1 * 0.96f, 0.96f);
         const float ratio = ExpoMap(param2, 0.5f, 4.5f);
         const float balance = std::clamp(param3, 0.0f, 1.0f) * 2.0f - 1.0f;
         const float weightPos = 0.5f + balance * 0.5f;
-        const float weightNeg = 1.0f - weightPos;
-
-        phase = StepPhase(phase, pitch, sampleRate);
-        secondaryPhase = StepPhase(secondaryPhase, pitch * ratio, sampleRate);
-        secondaryPhaseNeg = StepPhase(secondaryPhaseNeg, pitch * ratio, sampleRate);
+        return {PhaseIncrement(pitch, sampleRate), PhaseIncrement(pitch * ratio, sampleRate), decay,
+                std::sqrt(1.0f - decay * decay), weightPos, 1.0f - weightPos};
+    }
 
-        const float w = phase * kTwoPi;
-        const float tPos = secondaryPhase * kTwoPi;
-        const float tNeg = -secondaryPhaseNeg * kTwoPi;
+    AlgorithmOutput Render(const Controls& c) {
+        phase += PhaseStep(c.increment);
+        secondaryPhase += PhaseStep(c.secondaryIncrement);
+        secondaryPhaseNeg += PhaseStep(c.secondaryIncrement);
 
-        const float positive = ComputeDSFComponent(w, tPos, decay);
-        const float negative = ComputeDSFComponent(w, tNeg, decay);
+        const float positive = ComputeDSFComponent(phase, secondaryPhase, c.decay, c.normalise);
+        const float negative = ComputeDSFComponent(phase, 0u - secondaryPhaseNeg, c.decay, c.normalise);
 
-        const float output = 0.5f * (positive * weightPos + negative * weightNeg);
+        const float output = 0.5f * (positive * c.weightPos + negative * c.weightNeg);
         const float secondary = 0.5f * (positive - negative);
         return {output, secondary};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
-    float secondaryPhase;
-    float secondaryPhaseNeg;
+    uint32_t phase;
+    uint32_t secondaryPhase;
+    uint32_t secondaryPhaseNeg;
 };
 
 class TanhSquareAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float drive;
+        float trim;
+        float bias;
+    };
+
     explicit TanhSquareAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u) {}
 
-    void Reset() { phase = 0.0f; }
+    void Reset() { phase = 0u; }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
-        const float drive = ExpoMap(param1, 0.05f, 5.0f);
-        const float trim = ExpoMap(param2, 0.2f, 1.2f);
-        const float bias = (std::clamp(param3, 0.0f, 1.0f) - 0.5f) * 0.8f;
-
-        phase = StepPhase(phase, pitch, sampleRate);
-        const float carrier = std::sin(phase * kTwoPi) + bias;
-        const float output = std::tanh(carrier * drive) * trim;
-        const float secondary = std::tanh(std::sin(phase * kTwoPi) * drive) * trim;
+    void SetSampleRate(float rate) { sampleRate = rate; }
+
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
+        return {PhaseIncrement(pitch, sampleRate), ExpoMap(param1, 0.05f, 5.0f), ExpoMap(param2, 0.2f, 1.2f),
+                (std::clamp(param3, 0.0f, 1.0f) - 0.5f) * 0.8f};
+    }
+
+    AlgorithmOutput Render(const Controls& c) {
+        phase += PhaseStep(c.increment);
+        const float sine = SineLookup(phase);
+        const float output = std::tanh((sine + c.bias) * c.drive) * c.trim;
+        const float secondary = std::tanh(sine * c.drive) * c.trim;
         return {output, secondary};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
+    uint32_t phase;
 };
 
 class TanhSawAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float drive;
+        float blend;
+        float edge;
+    };
+
     explicit TanhSawAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), secondaryPhase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), secondaryPhase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        secondaryPhase = 0.0f;
+        phase = 0u;
+        secondaryPhase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
-        const float drive = ExpoMap(param1, 0.05f, 4.5f);
-        const float blend = std::clamp(param2, 0.0f, 1.0f);
-        const float edge = 0.5f + std::clamp(param3, 0.0f, 1.0f) * 1.5f;
+    void SetSampleRate(float rate) { sampleRate = rate; }
+
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
+        return {PhaseIncrement(pitch, sampleRate), ExpoMap(param1, 0.05f, 4.5f), std::clamp(param2, 0.0f, 1.0f),
+                0.5f + std::clamp(param3, 0.0f, 1.0f) * 1.5f};
+    }
 
-        phase = StepPhase(phase, pitch, sampleRate);
-        const float sine = std::sin(phase * kTwoPi);
-        const float square = std::tanh(sine * drive);
+    AlgorithmOutput Render(const Controls& c) {
+        const uint32_t step = PhaseStep(c.increment);
+        phase += step;
+        const float square = std::tanh(SineLookup(phase) * c.drive);
 
-        secondaryPhase = StepPhase(secondaryPhase, pitch, sampleRate);
-        const float cosine = std::cos(secondaryPhase * kTwoPi);
-        const float saw = square + cosine * (1.0f - square * square) * edge;
+        secondaryPhase += step;
+        const float cosine = CosineLookup(secondaryPhase);
+        const float saw = square + cosine * (1.0f - square * square) * c.edge;
 
-        const float output = square * (1.0f - blend) + saw * blend;
+        const float output = square * (1.0f - c.blend) + saw * c.blend;
         return {output, square};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
-    float secondaryPhase;
+    uint32_t phase;
+    uint32_t secondaryPhase;
 };
 
 class PAFAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float secondaryIncrement;
+        float decay;
+        float depth;
+    };
+
     explicit PAFAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), secondaryPhase(0.0f), modPhase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), secondaryPhase(0u), modPhase(0.0f) {}
 
     void Reset() {
-        phase = 0.0f;
-        secondaryPhase = 0.0f;
+        phase = 0u;
+        secondaryPhase = 0u;
         modPhase = 0.0f;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float ratio = ExpoMap(param1, 0.5f, 6.0f);
         const float bandwidth = ExpoMap(param2, 50.0f, 3000.0f);
-        const float depth = 0.2f + std::clamp(param3, 0.0f, 1.0f) * 0.8f;
+        return {PhaseIncrement(pitch, sampleRate), PhaseIncrement(pitch * ratio, sampleRate),
+                std::exp(-bandwidth / sampleRate), 0.2f + std::clamp(param3, 0.0f, 1.0f) * 0.8f};
+    }
 
-        phase = StepPhase(phase, pitch, sampleRate);
-        secondaryPhase = StepPhase(secondaryPhase, pitch * ratio, sampleRate);
+    AlgorithmOutput Render(const Controls& c) {
+        phase += PhaseStep(c.increment);
+        secondaryPhase += PhaseStep(c.secondaryIncrement);
 
-        const float carrier = std::sin(secondaryPhase * kTwoPi);
-        const float mod = std::sin(phase * kTwoPi);
-        const float decay = std::exp(-bandwidth / sampleRate);
-        modPhase = decay * modPhase + (1.0f - decay) * mod;
+        const float carrier = SineLookup(secondaryPhase);
+        const float mod = SineLookup(phase);
+        modPhase = c.decay * modPhase + (1.0f - c.decay) * mod;
 
-        const float output = carrier * ((1.0f - depth) + depth * modPhase) * 0.5f;
+        const float output = carrier * ((1.0f - c.depth) + c.depth * modPhase) * 0.5f;
         const float secondary = carrier * (0.5f + 0.5f * modPhase) * 0.5f;
         return {output, secondary};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
-    float secondaryPhase;
+    uint32_t phase;
+    uint32_t secondaryPhase;
     float modPhase;
 };
 
 class ModFMAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float modIncrement;
+        float index;
+        float feedback;
+        float envelope;
+    };
+
     explicit ModFMAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), modPhase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), modPhase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        modPhase = 0.0f;
+        phase = 0u;
+        modPhase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float index = ExpoMap(param1, 0.01f, 8.0f);
         const float ratio = ExpoMap(param2, 0.25f, 6.0f);
-        const float feedback = std::clamp(param3, 0.0f, 1.0f) * 0.8f;
+        return {PhaseIncrement(pitch, sampleRate), PhaseIncrement(pitch * ratio, sampleRate), index,
+                std::clamp(param3, 0.0f, 1.0f) * 0.8f, std::exp(-index)};
+    }
 
-        phase = StepPhase(phase, pitch, sampleRate);
-        modPhase = StepPhase(modPhase, pitch * ratio, sampleRate);
+    AlgorithmOutput Render(const Controls& c) {
+        phase += PhaseStep(c.increment);
+        modPhase += PhaseStep(c.modIncrement);
 
-        const float carrier = std::cos(phase * kTwoPi);
-        const float modPhaseRad = modPhase * kTwoPi;
-        const float modulator = std::cos(modPhaseRad + feedback * std::sin(modPhaseRad));
-        const float envelope = std::exp(-index);
+        const float carrier = CosineLookup(phase);
+        // The feedback swing is under 0.8 rad, so it converts without wrapping.
+        const float swing = c.feedback * SineLookup(modPhase) * kPhaseUnitsPerRadian;
+        const float modulator = CosineLookup(modPhase + PhaseStep(swing));
 
-        const float output = carrier * std::exp(index * (modulator - 1.0f)) * envelope * 0.6f;
-        const float secondary = carrier * modulator * envelope * 0.6f;
+        const float output = carrier * std::exp(c.index * (modulator - 1.0f)) * c.envelope * 0.6f;
+        const float secondary = carrier * modulator * c.envelope * 0.6f;
         return {output, secondary};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
-    float modPhase;
+    uint32_t phase;
+    uint32_t modPhase;
 };
 
 class Combination1HybridFormantAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float modfmIndex;
+        float formant1Increment;
+        float formant2Increment;
+        float formant3Increment;
+    };
+
     explicit Combination1HybridFormantAlgorithm(float sampleRate)
         : sampleRate(sampleRate),
-          phase(0.0f),
-          modPhase(0.0f),
-          formant1Phase(0.0f),
-          formant2Phase(0.0f),
-          formant3Phase(0.0f) {}
+          phase(0u),
+          modPhase(0u),
+          formant1Phase(0u),
+          formant2Phase(0u),
+          formant3Phase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        modPhase = 0.0f;
-        formant1Phase = 0.0f;
-        formant2Phase = 0.0f;
-        formant3Phase = 0.0f;
+        phase = 0u;
+        modPhase = 0u;
+        formant1Phase = 0u;
+        formant2Phase = 0u;
+        formant3Phase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         (void)param2;
-        const float modfmIndex = ExpoMap(param1, 0.01f, 3.0f);
         const float formantSpacing = 0.8f + param3 * 0.4f;
+        return {PhaseIncrement(pitch, sampleRate), ExpoMap(param1, 0.01f, 3.0f),
+                PhaseIncrement(800.0f * formantSpacing, sampleRate),
+                PhaseIncrement(1200.0f * formantSpacing, sampleRate),
+                PhaseIncrement(2400.0f * formantSpacing, sampleRate)};
+    }
 
-        phase = StepPhase(phase, pitch, sampleRate);
-        modPhase = StepPhase(modPhase, pitch, sampleRate);
-        const float modulator = std::sin(kTwoPi * modPhase);
-        const float carrier = std::sin(kTwoPi * phase);
-        const float base = carrier * std::exp(-modfmIndex * (std::abs(modulator) - 1.0f)) * 0.4f;
+    AlgorithmOutput Render(const Controls& c) {
+        const uint32_t step = PhaseStep(c.increment);
+        phase += step;
+        modPhase += step;
+        formant1Phase += PhaseStep(c.formant1Increment);
+        formant2Phase += PhaseStep(c.formant2Increment);
+        formant3Phase += PhaseStep(c.formant3Increment);
 
-        formant1Phase = StepPhase(formant1Phase, 800.0f * formantSpacing, sampleRate);
-        formant2Phase = StepPhase(formant2Phase, 1200.0f * formantSpacing, sampleRate);
-        formant3Phase = StepPhase(formant3Phase, 2400.0f * formantSpacing, sampleRate);
+        const uint32_t phases[5] = {phase, modPhase, formant1Phase, formant2Phase, formant3Phase};
+        float sines[5];
+        SineLookup(phases, sines, 5);
 
-        const float formant1 = std::sin(kTwoPi * formant1Phase) * 0.5f;
-        const float formant2 = std::sin(kTwoPi * formant2Phase) * 0.5f;
-        const float formant3 = std::sin(kTwoPi * formant3Phase) * 0.5f;
+        const float base = sines[0] * std::exp(-c.modfmIndex * (std::abs(sines[1]) - 1.0f)) * 0.4f;
+        const float formants = (sines[2] + sines[3] + sines[4]) * 0.5f;
 
-        const float output = (base + formant1 + formant2 + formant3) * 0.25f;
+        const float output = (base + formants) * 0.25f;
         return {output, base * 0.5f};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
-    float modPhase;
-    float formant1Phase;
-    float formant2Phase;
-    float formant3Phase;
+    uint32_t phase;
+    uint32_t modPhase;
+    uint32_t formant1Phase;
+    uint32_t formant2Phase;
+    uint32_t formant3Phase;
 };
 
 class Combination2CascadedAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float dsfDecay;
+        float denom;
+        float asymSpread;
+        float tanhDrive;
+    };
+
     explicit Combination2CascadedAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), cascade1Phase(0.0f), cascade2Phase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), cascade1Phase(0u), cascade2Phase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        cascade1Phase = 0.0f;
-        cascade2Phase = 0.0f;
+        phase = 0u;
+        cascade1Phase = 0u;
+        cascade2Phase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float dsfDecay = 0.5f + param1 * 0.45f;
-        const float asymRatio = param2;
-        const float tanhDrive = param3 * 5.0f;
+        const float denom = 1.0f - 2.0f * dsfDecay * CosineLookup(kTheta) + dsfDecay * dsfDecay;
+        return {PhaseIncrement(pitch, sampleRate), dsfDecay, denom, AsymmetricFMSpread(param2), param3 * 5.0f};
+    }
 
-        phase = StepPhase(phase, pitch, sampleRate);
-        const float theta = kTwoPi * 1.5f;
-        const float denom = 1.0f - 2.0f * dsfDecay * std::cos(theta) + dsfDecay * dsfDecay;
-        const float stage1 = (std::sin(kTwoPi * phase) - dsfDecay * std::sin(kTwoPi * phase - theta))
-            / (denom + kEpsilon);
+    AlgorithmOutput Render(const Controls& c) {
+        const uint32_t step = PhaseStep(c.increment);
+        phase += step;
+        const float stage1 = (SineLookup(phase) - c.dsfDecay * SineLookup(phase - kTheta)) / (c.denom + kEpsilon);
 
-        const float stage2 = ProcessAsymmetricFM(std::abs(stage1), asymRatio, pitch, sampleRate,
+        // The index follows the DSF stage every sample, so only the ratio is
+        // precomputed.
+        const float stage2 = ProcessAsymmetricFM(ExpoMap(std::abs(stage1), 0.01f, 10.0f), c.asymSpread, step,
                                                  cascade1Phase, cascade2Phase);
 
-        const float stage3 = std::tanh(stage2 * tanhDrive);
+        const float stage3 = std::tanh(stage2 * c.tanhDrive);
         return {stage3 * 0.6f, stage2 * 0.6f};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
+    static constexpr uint32_t kTheta = kHalfTurn; // 1.5 turns
+
     float sampleRate;
-    float phase;
-    float cascade1Phase;
-    float cascade2Phase;
+    uint32_t phase;
+    uint32_t cascade1Phase;
+    uint32_t cascade2Phase;
 };
 
 class Combination3ParallelBankAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float increment15;
+        float increment1333;
+        float formant2Increment;
+        float formant3Increment;
+        float modfmIndex;
+        float mixBalance;
+    };
+
     explicit Combination3ParallelBankAlgorithm(float sampleRate)
         : sampleRate(sampleRate),
-          parallel1Phase(0.0f),
-          parallel2Phase(0.0f),
-          parallel3Phase(0.0f),
-          parallel4Phase(0.0f),
-          parallel5Phase(0.0f),
-          formant1Phase(0.0f),
-          formant2Phase(0.0f),
-          formant3Phase(0.0f) {}
+          useCache(false),
+          parallel1Phase(0u),
+          parallel2Phase(0u),
+          parallel3Phase(0u),
+          parallel4Phase(0u),
+          parallel5Phase(0u),
+          formant1Phase(0u),
+          formant2Phase(0u),
+          formant3Phase(0u) {}
 
     void Reset() {
-        parallel1Phase = 0.0f;
-        parallel2Phase = 0.0f;
-        parallel3Phase = 0.0f;
-        parallel4Phase = 0.0f;
-        parallel5Phase = 0.0f;
-        formant1Phase = 0.0f;
-        formant2Phase = 0.0f;
-        formant3Phase = 0.0f;
+        parallel1Phase = 0u;
+        parallel2Phase = 0u;
+        parallel3Phase = 0u;
+        parallel4Phase = 0u;
+        parallel5Phase = 0u;
+        formant1Phase = 0u;
+        formant2Phase = 0u;
+        formant3Phase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
-        (void)param2;
-        const float modfmIndex = ExpoMap(param1, 0.01f, 8.0f);
-        const float mixBalance = param3;
+    void SetShapeCache(bool enabled) { useCache = enabled; }
 
-        parallel1Phase = StepPhase(parallel1Phase, pitch, sampleRate);
-        parallel2Phase = StepPhase(parallel2Phase, pitch * 1.0f, sampleRate);
-        const float mod1 = std::cos(kTwoPi * parallel2Phase);
-        const float modfm1 = std::cos(kTwoPi * parallel1Phase) * std::exp(modfmIndex * (mod1 - 1.0f));
+    static void BuildShapeCache(size_t entries) { expCache.Build(entries); }
 
-        parallel3Phase = StepPhase(parallel3Phase, pitch, sampleRate);
-        parallel4Phase = StepPhase(parallel4Phase, pitch * 1.5f, sampleRate);
-        const float mod2 = std::cos(kTwoPi * parallel4Phase);
-        const float modfm2 = std::cos(kTwoPi * parallel3Phase) * std::exp(modfmIndex * (mod2 - 1.0f));
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
+        (void)param2;
+        return {PhaseIncrement(pitch, sampleRate), PhaseIncrement(pitch * 1.5f, sampleRate),
+                PhaseIncrement(pitch * 1.333f, sampleRate), PhaseIncrement(800.0f, sampleRate),
+                PhaseIncrement(2400.0f, sampleRate), ExpoMap(param1, 0.01f, 8.0f), param3};
+    }
 
-        parallel5Phase = StepPhase(parallel5Phase, pitch, sampleRate);
-        formant1Phase = StepPhase(formant1Phase, pitch * 1.333f, sampleRate);
-        const float mod3 = std::cos(kTwoPi * formant1Phase);
-        const float modfm3 = std::cos(kTwoPi * parallel5Phase) * std::exp(modfmIndex * (mod3 - 1.0f));
+    AlgorithmOutput Render(const Controls& c) {
+        const uint32_t step = PhaseStep(c.increment);
+        parallel1Phase += step;
+        parallel2Phase += step;
+        parallel3Phase += step;
+        parallel4Phase += PhaseStep(c.increment15);
+        parallel5Phase += step;
+        formant1Phase += PhaseStep(c.increment1333);
+        formant2Phase += PhaseStep(c.formant2Increment);
+        formant3Phase += PhaseStep(c.formant3Increment);
+
+        float modfm1;
+        float modfm2;
+        float modfm3;
+        if (useCache && expCache.Ready(c.modfmIndex, 0.0f)) {
+            // The modulators' exp(index * (cos - 1)) from the table.
+            const uint32_t carrierPhases[3] = {parallel1Phase, parallel3Phase, parallel5Phase};
+            float carriers[3];
+            CosineLookup(carrierPhases, carriers, 3);
+            modfm1 = carriers[0] * expCache.Read(parallel2Phase);
+            modfm2 = carriers[1] * expCache.Read(parallel4Phase);
+            modfm3 = carriers[2] * expCache.Read(formant1Phase);
+        } else {
+            // Carriers 1, 3, 5 and modulators 2, 4, 6 of the three ModFM pairs.
+            const uint32_t cosinePhases[6] = {parallel1Phase, parallel2Phase, parallel3Phase,
+                                              parallel4Phase, parallel5Phase, formant1Phase};
+            float cosines[6];
+            CosineLookup(cosinePhases, cosines, 6);
+            modfm1 = cosines[0] * std::exp(c.modfmIndex * (cosines[1] - 1.0f));
+            modfm2 = cosines[2] * std::exp(c.modfmIndex * (cosines[3] - 1.0f));
+            modfm3 = cosines[4] * std::exp(c.modfmIndex * (cosines[5] - 1.0f));
+        }
 
-        formant2Phase = StepPhase(formant2Phase, 800.0f, sampleRate);
-        formant3Phase = StepPhase(formant3Phase, 2400.0f, sampleRate);
-        const float paf1 = std::sin(kTwoPi * formant2Phase) * 0.5f;
-        const float paf2 = std::sin(kTwoPi * formant3Phase) * 0.5f;
+        const uint32_t sinePhases[2] = {formant2Phase, formant3Phase};
+        float sines[2];
+        SineLookup(sinePhases, sines, 2);
+        const float paf1 = sines[0] * 0.5f;
+        const float paf2 = sines[1] * 0.5f;
 
         const float modfmMix = (modfm1 + modfm2 + modfm3) / 3.0f;
         const float pafMix = (paf1 + paf2) / 2.0f;
-        const float output = (modfmMix * (1.0f - mixBalance) + pafMix * mixBalance) * 0.5f;
+        const float output = (modfmMix * (1.0f - c.mixBalance) + pafMix * c.mixBalance) * 0.5f;
         const float secondary = (pafMix - modfmMix) * 0.5f;
         return {output, secondary};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
+    struct ExpCosineShape {
+        float operator()(float index, float, uint32_t phase) const {
+            return std::exp(index * (CosineLookup(phase) - 1.0f));
+        }
+    };
+
+    static inline ShapeCache<ExpCosineShape> expCache;
+
     float sampleRate;
-    float parallel1Phase;
-    float parallel2Phase;
-    float parallel3Phase;
-    float parallel4Phase;
-    float parallel5Phase;
-    float formant1Phase;
-    float formant2Phase;
-    float formant3Phase;
+    bool useCache;
+    uint32_t parallel1Phase;
+    uint32_t parallel2Phase;
+    uint32_t parallel3Phase;
+    uint32_t parallel4Phase;
+    uint32_t parallel5Phase;
+    uint32_t formant1Phase;
+    uint32_t formant2Phase;
+    uint32_t formant3Phase;
 };
 
 class Combination4FeedbackAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float modfmIndex;
+        float feedbackGain;
+        float drive;
+    };
+
     explicit Combination4FeedbackAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), modPhase(0.0f), feedbackSample(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), modPhase(0u), feedbackSample(0.0f) {}
 
     void Reset() {
-        phase = 0.0f;
-        modPhase = 0.0f;
+        phase = 0u;
+        modPhase = 0u;
         feedbackSample = 0.0f;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
-        const float modfmIndex = ExpoMap(param1, 0.01f, 8.0f);
-        const float feedbackGain = param2 * 0.95f;
-        const float drive = 1.0f + std::clamp(param3, 0.0f, 1.0f) * 4.0f;
+    void SetSampleRate(float rate) { sampleRate = rate; }
+
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
+        return {PhaseIncrement(pitch, sampleRate), ExpoMap(param1, 0.01f, 8.0f), param2 * 0.95f,
+                1.0f + std::clamp(param3, 0.0f, 1.0f) * 4.0f};
+    }
 
-        const float modifiedFreq = pitch + feedbackSample * feedbackGain * pitch;
+    AlgorithmOutput Render(const Controls& c) {
+        // The frequency follows the last output, so the step is per sample.
+        const uint32_t step = PhaseStep(c.increment * (1.0f + feedbackSample * c.feedbackGain));
 
-        phase = StepPhase(phase, modifiedFreq, sampleRate);
-        modPhase = StepPhase(modPhase, modifiedFreq, sampleRate);
-        const float modulator = std::cos(kTwoPi * modPhase);
-        const float carrier = std::cos(kTwoPi * phase);
-        const float output = carrier * std::exp(modfmIndex * (modulator - 1.0f));
+        phase += step;
+        modPhase += step;
+        const float modulator = CosineLookup(modPhase);
+        const float carrier = CosineLookup(phase);
+        const float output = carrier * std::exp(c.modfmIndex * (modulator - 1.0f));
 
         feedbackSample = output;
 
-        const float shaped = std::tanh(output * drive);
+        const float shaped = std::tanh(output * c.drive);
         return {shaped * 0.5f, output * 0.5f};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
-    float modPhase;
+    uint32_t phase;
+    uint32_t modPhase;
     float feedbackSample;
 };
 
 class Combination5MorphingAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float doubleIncrement;
+        float morphPos;
+        float dsfDecay;
+        float denom;
+        float modfmIndex;
+    };
+
     explicit Combination5MorphingAlgorithm(float sampleRate)
         : sampleRate(sampleRate),
-          phase(0.0f),
-          modPhase(0.0f),
-          secondaryPhase(0.0f),
-          formant1Phase(0.0f) {}
+          phase(0u),
+          modPhase(0u),
+          secondaryPhase(0u),
+          formant1Phase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        modPhase = 0.0f;
-        secondaryPhase = 0.0f;
-        formant1Phase = 0.0f;
+        phase = 0u;
+        modPhase = 0u;
+        secondaryPhase = 0u;
+        formant1Phase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float morphCurve = 0.5f + std::clamp(param3, 0.0f, 1.0f) * 1.5f;
-        const float morphPos = std::pow(std::clamp(param1, 0.0f, 1.0f), morphCurve);
         const float character = param2;
+        const float dsfDecay = 0.5f + character * 0.4f;
+        const float denom = 1.0f - 2.0f * dsfDecay * CosineLookup(kTheta) + dsfDecay * dsfDecay;
+        return {PhaseIncrement(pitch, sampleRate), PhaseIncrement(pitch * 2.0f, sampleRate),
+                std::pow(std::clamp(param1, 0.0f, 1.0f), morphCurve), dsfDecay, denom,
+                ExpoMap(character, 0.01f, 8.0f)};
+    }
 
+    AlgorithmOutput Render(const Controls& c) {
+        const uint32_t step = PhaseStep(c.increment);
         float output = 0.0f;
         float secondary = 0.0f;
 
-        if (morphPos < 0.5f) {
-            const float alpha = morphPos * 2.0f;
+        modPhase += step;
+        secondaryPhase += step;
+        const float mod = CosineLookup(secondaryPhase);
+        const float modfm = CosineLookup(modPhase) * std::exp(c.modfmIndex * (mod - 1.0f));
 
-            phase = StepPhase(phase, pitch, sampleRate);
-            const float dsfDecay = 0.5f + character * 0.4f;
-            const float theta = kTwoPi * 1.5f;
-            const float denom = 1.0f - 2.0f * dsfDecay * std::cos(theta) + dsfDecay * dsfDecay;
-            const float dsf = (std::sin(kTwoPi * phase) - dsfDecay * std::sin(kTwoPi * phase - theta))
-                / (denom + kEpsilon);
+        if (c.morphPos < 0.5f) {
+            const float alpha = c.morphPos * 2.0f;
 
-            modPhase = StepPhase(modPhase, pitch, sampleRate);
-            secondaryPhase = StepPhase(secondaryPhase, pitch, sampleRate);
-            const float modfmIndex = ExpoMap(character, 0.01f, 8.0f);
-            const float mod = std::cos(kTwoPi * secondaryPhase);
-            const float modfm = std::cos(kTwoPi * modPhase) * std::exp(modfmIndex * (mod - 1.0f));
+            phase += step;
+            const float dsf = (SineLookup(phase) - c.dsfDecay * SineLookup(phase - kTheta)) / (c.denom + kEpsilon);
 
             output = dsf * (1.0f - alpha) + modfm * alpha;
             secondary = modfm;
         } else {
-            const float alpha = (morphPos - 0.5f) * 2.0f;
+            const float alpha = (c.morphPos - 0.5f) * 2.0f;
 
-            modPhase = StepPhase(modPhase, pitch, sampleRate);
-            secondaryPhase = StepPhase(secondaryPhase, pitch, sampleRate);
-            const float modfmIndex = ExpoMap(character, 0.01f, 8.0f);
-            const float mod = std::cos(kTwoPi * secondaryPhase);
-            const float modfm = std::cos(kTwoPi * modPhase) * std::exp(modfmIndex * (mod - 1.0f));
-
-            formant1Phase = StepPhase(formant1Phase, pitch * 2.0f, sampleRate);
-            const float paf = std::sin(kTwoPi * formant1Phase) * 0.5f;
+            formant1Phase += PhaseStep(c.doubleIncrement);
+            const float paf = SineLookup(formant1Phase) * 0.5f;
 
             output = modfm * (1.0f - alpha) + paf * alpha;
             secondary = paf;
@@ -519,135 +736,212 @@ public:
         return {output * 0.6f, secondary * 0.6f};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
+    static constexpr uint32_t kTheta = kHalfTurn; // 1.5 turns
+
     float sampleRate;
-    float phase;
-    float modPhase;
-    float secondaryPhase;
-    float formant1Phase;
+    uint32_t phase;
+    uint32_t modPhase;
+    uint32_t secondaryPhase;
+    uint32_t formant1Phase;
 };
 
 class Combination6InharmonicAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float formantIncrement;
+        float dsfDecay;
+        float denom;
+        float mix;
+    };
+
     explicit Combination6InharmonicAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), formant1Phase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), formant1Phase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        formant1Phase = 0.0f;
+        phase = 0u;
+        formant1Phase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
-        const float phiRatio = 1.618034f;
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float pafShift = ExpoMap(param2, 5.0f, 50.0f);
         const float dsfDecay = 0.5f + param1 * 0.4f;
-        const float mix = std::clamp(param3, 0.0f, 1.0f);
+        const float denom = 1.0f - 2.0f * dsfDecay * CosineLookup(kTheta) + dsfDecay * dsfDecay;
+        const float formantFreq = pitch * 2.0f + pafShift;
+        return {PhaseIncrement(pitch, sampleRate), PhaseIncrement(formantFreq, sampleRate), dsfDecay, denom,
+                std::clamp(param3, 0.0f, 1.0f)};
+    }
 
-        phase = StepPhase(phase, pitch, sampleRate);
-        const float theta = kTwoPi * phiRatio;
-        const float denom = 1.0f - 2.0f * dsfDecay * std::cos(theta) + dsfDecay * dsfDecay;
-        const float dsf = (std::sin(kTwoPi * phase) - dsfDecay * std::sin(kTwoPi * phase - theta))
-            / (denom + kEpsilon);
+    AlgorithmOutput Render(const Controls& c) {
+        phase += PhaseStep(c.increment);
+        const float dsf = (SineLookup(phase) - c.dsfDecay * SineLookup(phase - kTheta)) / (c.denom + kEpsilon);
 
-        const float formantFreq = pitch * 2.0f + pafShift;
-        formant1Phase = StepPhase(formant1Phase, formantFreq, sampleRate);
-        const float paf = std::sin(kTwoPi * formant1Phase) * 0.5f;
+        formant1Phase += PhaseStep(c.formantIncrement);
+        const float paf = SineLookup(formant1Phase) * 0.5f;
 
-        const float output = dsf * (1.0f - mix) + paf * mix;
+        const float output = dsf * (1.0f - c.mix) + paf * c.mix;
         return {output, dsf};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
+    // Golden ratio of a turn; the whole turn drops out.
+    static constexpr uint32_t kTheta = static_cast<uint32_t>(0.618034 * 4294967296.0);
+
     float sampleRate;
-    float phase;
-    float formant1Phase;
+    uint32_t phase;
+    uint32_t formant1Phase;
 };
 
 class Combination7AdaptiveFilterAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float dsfDecay;
+        float theta;
+        float denom;
+        float modfmIndex;
+        float mix;
+    };
+
     explicit Combination7AdaptiveFilterAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), modPhase(0.0f), secondaryPhase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), modPhase(0u), secondaryPhase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        modPhase = 0.0f;
-        secondaryPhase = 0.0f;
+        phase = 0u;
+        modPhase = 0u;
+        secondaryPhase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float cutoff = param1;
         const float resonance = param2;
-        const float mix = std::clamp(param3, 0.0f, 1.0f);
-
         const float dsfDecay = 0.5f + resonance * 0.49f;
-        phase = StepPhase(phase, pitch, sampleRate);
-        const float theta = kTwoPi * (1.0f + cutoff * 2.0f);
-        const float denom = 1.0f - 2.0f * dsfDecay * std::cos(theta) + dsfDecay * dsfDecay;
-        const float dsf = (std::sin(kTwoPi * phase) - dsfDecay * std::sin(kTwoPi * phase - theta))
-            / (denom + kEpsilon);
-
-        const float modfmIndex = ExpoMap(cutoff, 0.01f, 2.0f);
-        modPhase = StepPhase(modPhase, pitch, sampleRate);
-        secondaryPhase = StepPhase(secondaryPhase, pitch, sampleRate);
-        const float mod = std::cos(kTwoPi * secondaryPhase);
-        const float modfm = std::cos(kTwoPi * modPhase) * std::exp(modfmIndex * (mod - 1.0f));
-
-        const float output = (dsf * (1.0f - mix) + modfm * mix) * 0.3f;
+        const float theta = PhaseUnits(1.0f + cutoff * 2.0f);
+        const float denom = 1.0f - 2.0f * dsfDecay * CosineLookup(PhaseStep(theta)) + dsfDecay * dsfDecay;
+        return {PhaseIncrement(pitch, sampleRate), dsfDecay, theta, denom, ExpoMap(cutoff, 0.01f, 2.0f),
+                std::clamp(param3, 0.0f, 1.0f)};
+    }
+
+    AlgorithmOutput Render(const Controls& c) {
+        const uint32_t step = PhaseStep(c.increment);
+        phase += step;
+        const float dsf = (SineLookup(phase) - c.dsfDecay * SineLookup(phase - PhaseStep(c.theta)))
+            / (c.denom + kEpsilon);
+
+        modPhase += step;
+        secondaryPhase += step;
+        const float mod = CosineLookup(secondaryPhase);
+        const float modfm = CosineLookup(modPhase) * std::exp(c.modfmIndex * (mod - 1.0f));
+
+        const float output = (dsf * (1.0f - c.mix) + modfm * c.mix) * 0.3f;
         return {output, modfm * 0.3f};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
-    float modPhase;
-    float secondaryPhase;
+    uint32_t phase;
+    uint32_t modPhase;
+    uint32_t secondaryPhase;
 };
 
 class Novel1MultistageAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float ringIncrement;
+        float tanhDrive;
+        float expDepth;
+    };
+
     explicit Novel1MultistageAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), modPhase(0.0f) {}
+        : sampleRate(sampleRate), useCache(false), phase(0u), modPhase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        modPhase = 0.0f;
+        phase = 0u;
+        modPhase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
-        const float tanhDrive = ExpoMap(param1, 0.1f, 10.0f);
-        const float expDepth = ExpoMap(param2, 0.1f, 1.5f);
+    void SetSampleRate(float rate) { sampleRate = rate; }
+
+    void SetShapeCache(bool enabled) { useCache = enabled; }
+
+    static void BuildShapeCache(size_t entries) { stageCache.Build(entries); }
+
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float ringCarrierMult = 0.5f + param3 * 4.5f;
+        return {PhaseIncrement(pitch, sampleRate), PhaseIncrement(pitch * ringCarrierMult, sampleRate),
+                ExpoMap(param1, 0.1f, 10.0f), ExpoMap(param2, 0.1f, 1.5f)};
+    }
 
-        phase = StepPhase(phase, pitch, sampleRate);
-        const float input = std::sin(kTwoPi * phase);
+    AlgorithmOutput Render(const Controls& c) {
+        phase += PhaseStep(c.increment);
 
-        const float stage1 = std::tanh(tanhDrive * input);
-        const float stage2 = stage1 * std::exp(expDepth * stage1);
+        float stage2;
+        if (useCache && stageCache.Ready(c.tanhDrive, c.expDepth)) {
+            stage2 = stageCache.Read(phase);
+        } else {
+            stage2 = TanhExpShape()(c.tanhDrive, c.expDepth, phase);
+        }
 
-        modPhase = StepPhase(modPhase, pitch * ringCarrierMult, sampleRate);
-        const float carrier = std::sin(kTwoPi * modPhase);
+        modPhase += PhaseStep(c.ringIncrement);
+        const float carrier = SineLookup(modPhase);
         const float stage3 = stage2 * (1.0f + carrier);
 
         return {stage3 * 0.25f, stage2 * 0.25f};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
+    // Stages 1 and 2: tanh drive, then exp shaping.
+    struct TanhExpShape {
+        float operator()(float drive, float depth, uint32_t phase) const {
+            const float stage1 = std::tanh(drive * SineLookup(phase));
+            return stage1 * std::exp(depth * stage1);
+        }
+    };
+
+    static inline ShapeCache<TanhExpShape> stageCache;
+
     float sampleRate;
-    float phase;
-    float modPhase;
+    bool useCache;
+    uint32_t phase;
+    uint32_t modPhase;
 };
 
 class Novel2FreqAsymmetryAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float index;
+        float k;
+        float rSpread;
+    };
+
     explicit Novel2FreqAsymmetryAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), modPhase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), modPhase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        modPhase = 0.0f;
+        phase = 0u;
+        modPhase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float lowR = 0.5f + param1 * 0.5f;
         const float highR = 1.0f + param2 * 1.0f;
         const float index = 0.2f + std::clamp(param3, 0.0f, 1.0f) * 0.8f;
@@ -660,91 +954,133 @@ public:
             r = lowR * (1.0f - alpha) + highR * alpha;
         }
 
-        const float output = ProcessAsymmetricFM(index, r / 2.0f, pitch, sampleRate, phase, modPhase);
-        const float mod = std::sin(kTwoPi * modPhase);
-        const float secondary = std::cos(kTwoPi * phase + index * mod) * 0.5f;
+        return {PhaseIncrement(pitch, sampleRate), index, ExpoMap(index, 0.01f, 10.0f), AsymmetricFMSpread(r / 2.0f)};
+    }
+
+    AlgorithmOutput Render(const Controls& c) {
+        const float output = ProcessAsymmetricFM(c.k, c.rSpread, PhaseStep(c.increment), phase, modPhase);
+        // index is at most 1 rad, so it converts without wrapping.
+        const float mod = SineLookup(modPhase);
+        const float secondary = CosineLookup(phase + PhaseStep(c.index * mod * kPhaseUnitsPerRadian)) * 0.5f;
         return {output, secondary};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
-    float modPhase;
+    uint32_t phase;
+    uint32_t modPhase;
 };
 
 class Novel3CrossModAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float theta;
+        float denom;
+        float modfmIndex;
+        float mix;
+    };
+
     explicit Novel3CrossModAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f), modPhase(0.0f), secondaryPhase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u), modPhase(0u), secondaryPhase(0u) {}
 
     void Reset() {
-        phase = 0.0f;
-        modPhase = 0.0f;
-        secondaryPhase = 0.0f;
+        phase = 0u;
+        modPhase = 0u;
+        secondaryPhase = 0u;
     }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const float mod1Depth = param1;
         const float mod2Depth = param2;
-        const float mix = std::clamp(param3, 0.0f, 1.0f);
 
-        const float baseDsfDecay = 0.7f;
-        const float baseDsfRatio = 1.5f;
-        const float baseModfmIndex = 0.25f;
+        const float dsfRatio = kBaseDsfRatio + mod2Depth * kBaseModfmIndex * 0.5f;
+        const float modfmIndex = kBaseModfmIndex + mod1Depth * kBaseDsfDecay * 1.0f;
 
-        const float dsfRatio = baseDsfRatio + mod2Depth * baseModfmIndex * 0.5f;
-        const float modfmIndex = baseModfmIndex + mod1Depth * baseDsfDecay * 1.0f;
+        const float theta = PhaseUnits(dsfRatio);
+        const float denom =
+            1.0f - 2.0f * kBaseDsfDecay * CosineLookup(PhaseStep(theta)) + kBaseDsfDecay * kBaseDsfDecay;
+        return {PhaseIncrement(pitch, sampleRate), theta, denom, modfmIndex, std::clamp(param3, 0.0f, 1.0f)};
+    }
 
-        phase = StepPhase(phase, pitch, sampleRate);
-        const float theta = kTwoPi * dsfRatio;
-        const float denom = 1.0f - 2.0f * baseDsfDecay * std::cos(theta) + baseDsfDecay * baseDsfDecay;
-        const float dsf = (std::sin(kTwoPi * phase) - baseDsfDecay * std::sin(kTwoPi * phase - theta))
-            / (denom + kEpsilon);
+    AlgorithmOutput Render(const Controls& c) {
+        const uint32_t step = PhaseStep(c.increment);
+        phase += step;
+        const float dsf = (SineLookup(phase) - kBaseDsfDecay * SineLookup(phase - PhaseStep(c.theta)))
+            / (c.denom + kEpsilon);
 
-        modPhase = StepPhase(modPhase, pitch, sampleRate);
-        secondaryPhase = StepPhase(secondaryPhase, pitch, sampleRate);
-        const float mod = std::cos(kTwoPi * secondaryPhase);
-        const float modfm = std::cos(kTwoPi * modPhase) * std::exp(modfmIndex * (mod - 1.0f));
+        modPhase += step;
+        secondaryPhase += step;
+        const float mod = CosineLookup(secondaryPhase);
+        const float modfm = CosineLookup(modPhase) * std::exp(c.modfmIndex * (mod - 1.0f));
 
-        const float output = (dsf * (1.0f - mix) + modfm * mix) * 0.7f;
+        const float output = (dsf * (1.0f - c.mix) + modfm * c.mix) * 0.7f;
         const float secondary = (dsf - modfm) * 0.7f;
         return {output, secondary};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
+    static constexpr float kBaseDsfDecay = 0.7f;
+    static constexpr float kBaseDsfRatio = 1.5f;
+    static constexpr float kBaseModfmIndex = 0.25f;
+
     float sampleRate;
-    float phase;
-    float modPhase;
-    float secondaryPhase;
+    uint32_t phase;
+    uint32_t modPhase;
+    uint32_t secondaryPhase;
 };
 
 class Novel4TaylorAlgorithm {
 public:
+    struct Controls {
+        float increment;
+        float firstTerms;
+        float secondTerms;
+        float blend;
+    };
+
     explicit Novel4TaylorAlgorithm(float sampleRate)
-        : sampleRate(sampleRate), phase(0.0f) {}
+        : sampleRate(sampleRate), phase(0u) {}
 
-    void Reset() { phase = 0.0f; }
+    void Reset() { phase = 0u; }
 
-    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
         const int firstTerms = std::max(1, static_cast<int>(std::round(1.0f + param1 * 9.0f)));
         const int secondTerms = std::max(1, static_cast<int>(std::round(1.0f + param2 * 9.0f)));
-        const float blend = std::clamp(param3, 0.0f, 1.0f);
+        return {PhaseIncrement(pitch, sampleRate), static_cast<float>(firstTerms), static_cast<float>(secondTerms),
+                std::clamp(param3, 0.0f, 1.0f)};
+    }
 
-        phase = StepPhase(phase, pitch, sampleRate);
-        const float theta = phase * kTwoPi;
+    AlgorithmOutput Render(const Controls& c) {
+        // The truncated series is the sound here, so this one stays on
+        // radians rather than the table.
+        phase += PhaseStep(c.increment);
+        const float theta = PhaseToTurns(phase) * kTwoPi;
 
-        const float fundamental = ComputeTaylorSine(theta, firstTerms);
-        const float secondHarmonic = ComputeTaylorSine(2.0f * theta, secondTerms);
+        const float fundamental = ComputeTaylorSine(theta, static_cast<int>(c.firstTerms + 0.5f));
+        const float secondHarmonic = ComputeTaylorSine(2.0f * theta, static_cast<int>(c.secondTerms + 0.5f));
 
-        const float output = fundamental * (1.0f - blend) + secondHarmonic * blend;
+        const float output = fundamental * (1.0f - c.blend) + secondHarmonic * c.blend;
         const float clamped = std::clamp(output, -1.0f, 1.0f);
         const float secondary = std::clamp(secondHarmonic, -1.0f, 1.0f);
         return {clamped, secondary};
     }
 
+    AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
+        return Render(ComputeControls(pitch, param1, param2, param3));
+    }
+
 private:
     float sampleRate;
-    float phase;
+    uint32_t phase;
 };
 
 class TrajectoryAlgorithm {
@@ -757,11 +1093,15 @@ public:
           bounceJitter(0.0f),
           frequency(440.0f),
           speed(ComputeSpeed(440.0f)),
+          vertexCount(0),
+          edgeCount(0),
           position({0.0f, 0.0f}),
           velocity({speed, 0.0f}),
           rngState(0x12345678u),
-          vertexCount(0),
-          edgeCount(0) {
+          eventDriven(true),
+          samplesToHit(0.0f),
+          hitEdge(0),
+          pending({0.0f, 0.0f}) {
         RebuildPolygon();
         Reset();
     }
@@ -769,6 +1109,18 @@ public:
     void Reset() {
         ResetPosition();
         UpdateVelocity();
+        pending = position;
+    }
+
+    // Event-driven stepping (the default) works out when the point next
+    // meets a wall once per bounce and moves in a straight line until then,
+    // with a band-limited corner at each bounce; the output is one sample
+    // late so the corner can reach back. Off, every sample is tested against
+    // every edge and the corners are left sharp.
+    void SetEventDriven(bool enabled) {
+        eventDriven = enabled;
+        ScheduleHit();
+        pending = position;
     }
 
     AlgorithmOutput Process(float pitch, float param1, float param2, float param3) {
@@ -777,6 +1129,9 @@ public:
         if (edgeCount == 0) {
             return {0.0f, 0.0f};
         }
+        if (eventDriven) {
+            return Advance();
+        }
 
         Vec2 current = position;
         Vec2 currentVelocity = velocity;
@@ -821,6 +1176,7 @@ private:
         Vec2 start;
         Vec2 end;
         Vec2 normal;
+        float offset; // Distance of the wall from the centre along normal
     };
 
     struct PenetrationHit {
@@ -836,6 +1192,64 @@ private:
     };
 
     static constexpr int kMaxSides = 12;
+    // Bounces handled within one sample, as in the per-sample path; more
+    // only happen deep in a corner at extreme pitch.
+    static constexpr int kMaxBouncesPerSample = 2;
+    static constexpr float kNoHit = 1.0e9f;
+
+    // One sample of straight-line motion, bouncing where ScheduleHit() said.
+    // A bounce is a corner in both outputs: a step of `change` in their
+    // slope, `elapsed` samples after the previous output. The two-point
+    // polyBLAMP spreads it over the outputs either side, (1 - elapsed)^3 / 6
+    // of it into the held one and elapsed^3 / 6 into this one.
+    AlgorithmOutput Advance() {
+        float elapsed = 0.0f;
+        Vec2 correction = {0.0f, 0.0f};
+        for (int bounce = 0; bounce < kMaxBouncesPerSample && samplesToHit < 1.0f - elapsed; ++bounce) {
+            const float step = std::max(samplesToHit, 0.0f);
+            position = {position.x + velocity.x * step, position.y + velocity.y * step};
+            elapsed += step;
+
+            const Vec2 bounced = Bounce(velocity, edges[hitEdge].normal);
+            const Vec2 change = {bounced.x - velocity.x, bounced.y - velocity.y};
+            const float before = 1.0f - elapsed;
+            const float held = before * before * before * (1.0f / 6.0f);
+            const float current = elapsed * elapsed * elapsed * (1.0f / 6.0f);
+            pending = {pending.x + change.x * held, pending.y + change.y * held};
+            correction = {correction.x + change.x * current, correction.y + change.y * current};
+
+            velocity = bounced;
+            ScheduleHit();
+        }
+
+        const float rest = 1.0f - elapsed;
+        position = {position.x + velocity.x * rest, position.y + velocity.y * rest};
+        samplesToHit -= rest;
+
+        const AlgorithmOutput out = {pending.x, pending.y};
+        pending = {position.x + correction.x, position.y + correction.y};
+        return out;
+    }
+
+    // Samples until the point reaches the first wall it is moving towards:
+    // its gap to each wall over its speed towards it.
+    void ScheduleHit() {
+        samplesToHit = kNoHit;
+        hitEdge = 0;
+        for (int i = 0; i < edgeCount; ++i) {
+            const Edge& edge = edges[i];
+            const float approach = Dot(velocity, edge.normal);
+            if (approach <= 0.0f) {
+                continue;
+            }
+            const float gap = std::max(edge.offset - Dot(position, edge.normal), 0.0f);
+            const float time = gap / approach;
+            if (time < samplesToHit) {
+                samplesToHit = time;
+                hitEdge = i;
+            }
+        }
+    }
 
     float ComputeSpeed(float freq) const {
         return (freq * 4.0f) / sampleRate;
@@ -895,7 +1309,7 @@ private:
             const Vec2 end = vertices[(i + 1) % vertexCount];
             const Vec2 edge = {end.x - start.x, end.y - start.y};
             const Vec2 normal = Normalize({edge.y, -edge.x});
-            edges[i] = {start, end, normal};
+            edges[i] = {start, end, normal, Dot(start, normal)};
         }
         edgeCount = vertexCount;
     }
@@ -913,6 +1327,7 @@ private:
     void UpdateVelocity() {
         const Vec2 dir = {std::cos(startAngle), std::sin(startAngle)};
         velocity = {dir.x * speed, dir.y * speed};
+        ScheduleHit();
     }
 
     RayHit FindRayIntersection(const Vec2& direction) const {
@@ -980,14 +1395,23 @@ private:
         return {vector.x - 2.0f * dot * normal.x, vector.y - 2.0f * dot * normal.y};
     }
 
+    // Reflection off a wall, jittered unless that would leave it pointing
+    // out through the wall (a grazing hit).
+    Vec2 Bounce(const Vec2& vector, const Vec2& normal) {
+        const Vec2 reflected = Reflect(vector, normal);
+        const Vec2 jittered = ApplyBounceJitter(reflected);
+        return Dot(jittered, normal) < 0.0f ? jittered : reflected;
+    }
+
     Vec2 ApplyBounceJitter(const Vec2& vector) {
         if (bounceJitter <= 0.0f) {
             return vector;
         }
         const float randValue = RandomUnit();
-        const float angle = (randValue * 2.0f - 1.0f) * bounceJitter;
-        const float cosAngle = std::cos(angle);
-        const float sinAngle = std::sin(angle);
+        // At most 10 degrees, so well inside PhaseStep's range.
+        const uint32_t angle = PhaseStep((randValue * 2.0f - 1.0f) * bounceJitter * kPhaseUnitsPerRadian);
+        const float cosAngle = CosineLookup(angle);
+        const float sinAngle = SineLookup(angle);
         return {
             vector.x * cosAngle - vector.y * sinAngle,
             vector.x * sinAngle + vector.y * cosAngle
@@ -1020,6 +1444,10 @@ private:
         return a.x * b.y - a.y * b.x;
     }
 
+    float Dot(const Vec2& a, const Vec2& b) const {
+        return a.x * b.x + a.y * b.y;
+    }
+
     float RandomUnit() {
         rngState = rngState * 1664525u + 1013904223u;
         return static_cast<float>((rngState >> 8) & 0xFFFFFF) / 16777216.0f;
@@ -1041,6 +1469,11 @@ private:
     Vec2 position;
     Vec2 velocity;
     uint32_t rngState;
+
+    bool eventDriven;
+    float samplesToHit;
+    int hitEdge;
+    Vec2 pending; // Last sample's output, open to its bounce corrections
 };
 
 } // namespace disyn
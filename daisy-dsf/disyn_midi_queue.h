@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace disyn {
+
+// Sample-accurate MIDI: notes are stamped with the audio sample clock where
+// they arrive (the UART receive interrupt), pass to the audio callback
+// through a lock-free single-producer/single-consumer queue, and are applied
+// at their offset within the block exactly one block after they arrived. A
+// fixed delay of one block keeps the spacing between notes as it was on the
+// wire, whatever the main loop or the display is doing.
+
+struct MidiNoteEvent {
+    uint32_t time;    // Sample clock at arrival
+    uint8_t note;
+    uint8_t velocity;
+    bool noteOn;      // Note On (velocity 0 included) or Note Off
+};
+
+// Fixed-capacity ring between one producer context and one consumer
+// context; neither side ever waits. Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class SpscQueue {
+public:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    SpscQueue() : head(0), tail(0) {}
+
+    // Producer side. False (and the item dropped) when the queue is full.
+    bool Push(const T& item) {
+        const uint32_t write = tail.load(std::memory_order_relaxed);
+        if (write - head.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        items[write & kMask] = item;
+        tail.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: the oldest item, or nullptr when empty. Stays valid
+    // until Pop().
+    const T* Front() const {
+        const uint32_t read = head.load(std::memory_order_relaxed);
+        if (read == tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &items[read & kMask];
+    }
+
+    void Pop() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    size_t Size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr uint32_t kMask = static_cast<uint32_t>(Capacity - 1);
+
+    T items[Capacity];
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+};
+
+// The sample clock as seen from outside the audio callback. The callback
+// marks where each block starts, in samples and in timer ticks; any other
+// context turns a tick reading into a sample time by counting on from the
+// last mark. Marks alternate between two slots, so a reader that interrupts
+// the callback, or is interrupted by it, still reads a consistent pair.
+class SampleClock {
+public:
+    SampleClock() : samplesPerTick(0.0f), blockSize(1), marks{}, current(0) {}
+
+    void Init(float sampleRate, uint32_t tickFrequency, size_t blockSizeIn) {
+        samplesPerTick = sampleRate / static_cast<float>(tickFrequency);
+        blockSize = blockSizeIn > 0 ? static_cast<uint32_t>(blockSizeIn) : 1;
+        marks[0] = Mark{};
+        marks[1] = Mark{};
+        current.store(0, std::memory_order_release);
+    }
+
+    // Audio callback, at the start of each block.
+    void MarkBlock(uint32_t sample, uint32_t tick) {
+        const uint32_t next = current.load(std::memory_order_relaxed) ^ 1u;
+        marks[next] = Mark{sample, tick};
+        current.store(next, std::memory_order_release);
+    }
+
+    // Any context. Held within the block after the last mark: until audio
+    // starts, or while a callback is overdue, stamps do not run ahead of
+    // the blocks that will play them. A tick read just before a newer mark
+    // counts as that mark's start.
+    uint32_t Now(uint32_t tick) const {
+        const Mark mark = marks[current.load(std::memory_order_acquire)];
+        const int32_t ticks = static_cast<int32_t>(tick - mark.tick);
+        if (ticks <= 0) {
+            return mark.sample;
+        }
+        float elapsed = static_cast<float>(ticks) * samplesPerTick;
+        const float limit = static_cast<float>(blockSize - 1);
+        if (elapsed > limit) {
+            elapsed = limit;
+        }
+        return mark.sample + static_cast<uint32_t>(elapsed);
+    }
+
+private:
+    struct Mark {
+        uint32_t sample;
+        uint32_t tick;
+    };
+
+    float samplesPerTick;
+    uint32_t blockSize;
+    Mark marks[2];
+    std::atomic<uint32_t> current;
+};
+
+// Notes on their way from the receive interrupt to the audio callback.
+// The callback calls Next() with each block's start; every note due in the
+// block comes back in arrival order with its sample offset, and notes that
+// are already late (after an overrun) play at offset 0.
+class MidiNoteQueue {
+public:
+    static constexpr size_t kCapacity = 64;
+
+    MidiNoteQueue() : latency(0), dropped(0) {}
+
+    void Init(uint32_t latencySamples) {
+        latency = latencySamples;
+    }
+
+    // Producer side.
+    void Push(const MidiNoteEvent& event) {
+        if (!events.Push(event)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer side.
+    bool Next(uint32_t blockStart, size_t blockSize, MidiNoteEvent& event, size_t& offset) {
+        const MidiNoteEvent* front = events.Front();
+        if (front == nullptr) {
+            return false;
+        }
+        const int32_t due = static_cast<int32_t>(front->time + latency - blockStart);
+        if (due >= static_cast<int32_t>(blockSize)) {
+            return false;
+        }
+        offset = due > 0 ? static_cast<size_t>(due) : 0;
+        event = *front;
+        events.Pop();
+        return true;
+    }
+
+    uint32_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    SpscQueue<MidiNoteEvent, kCapacity> events;
+    uint32_t latency;
+    std::atomic<uint32_t> dropped;
+};
+
+} // namespace disyn
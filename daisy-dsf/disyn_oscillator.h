@@ -1,11 +1,20 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+
 #include "disyn_algorithms.h"
+#include "disyn_oversampling.h"
 
 namespace disyn {
 
 class DisynOscillator {
 public:
+    static constexpr int kMaxOversampling = 4;
+    // While the settings move, ProcessBlock() recomputes the controls every
+    // this many samples.
+    static constexpr size_t kRampStep = 8;
+
     explicit DisynOscillator(float sampleRate = 48000.0f)
         : sampleRate(sampleRate),
           algorithmType(AlgorithmType::TANH_SQUARE),
@@ -32,14 +41,20 @@ public:
           novel3(sampleRate),
           novel4(sampleRate),
           trajectory(sampleRate),
-          fallbackPhase(0.0f) {}
+          fallbackPhase(0u),
+          rampStart{},
+          rampAlgorithm(-1),
+          oversampling(1),
+          appliedOversampling(1),
+          decimators{} {}
 
     void Init(float sampleRateIn) {
         *this = DisynOscillator(sampleRateIn);
     }
 
     void Reset() {
-        fallbackPhase = 0.0f;
+        fallbackPhase = 0u;
+        rampAlgorithm = -1;
         dirichlet.Reset();
         dsfSingle.Reset();
         dsfDouble.Reset();
@@ -59,6 +74,7 @@ public:
         novel3.Reset();
         novel4.Reset();
         trajectory.Reset();
+        ResetDecimators();
     }
 
     void SetAlgorithm(int type) {
@@ -72,11 +88,53 @@ public:
         frequency = std::max(freq, 0.0f);
     }
 
+    // The next block starts on the current settings instead of ramping to
+    // them, for changes that belong on one sample (a MIDI note).
+    void SkipRamp() { rampAlgorithm = -1; }
+
+    // Lets Combination3 and Novel1 read their exp/tanh terms from the
+    // shared tables once BuildShapeCaches() has filled them for the
+    // current params. Off by default.
+    void SetShapeCache(bool enabled) {
+        combination3.SetShapeCache(enabled);
+        novel1.SetShapeCache(enabled);
+    }
+
+    // Fills up to `entries` points of each shared table; call it often
+    // from outside the audio callback.
+    static void BuildShapeCaches(size_t entries) {
+        Combination3ParallelBankAlgorithm::BuildShapeCache(entries);
+        Novel1MultistageAlgorithm::BuildShapeCache(entries);
+    }
+
+    // Quality tier: 1, 2 or 4 times the sample rate for the algorithms
+    // where SupportsOversampling() is true (their waveshapers alias at
+    // higher pitches); the rest ignore it. Each step down to the output rate
+    // is a halfband decimator (disyn_oversampling.h). The phases carry on
+    // across a change, and it takes effect at the next render, so the
+    // firmware can set it from outside the audio callback.
+    void SetOversampling(int factor) {
+        if (factor == 1 || factor == 2 || factor == kMaxOversampling) {
+            oversampling = factor;
+        }
+    }
+
+    int GetOversampling() const { return oversampling; }
+
+    static constexpr bool SupportsOversampling(int type) {
+        return type == static_cast<int>(AlgorithmType::TANH_SQUARE)
+            || type == static_cast<int>(AlgorithmType::TANH_SAW)
+            || type == static_cast<int>(AlgorithmType::COMBINATION_4_FEEDBACK)
+            || type == static_cast<int>(AlgorithmType::NOVEL_1_MULTISTAGE);
+    }
+
     void SetParam1(float value) { param1 = std::clamp(value, 0.0f, 1.0f); }
     void SetParam2(float value) { param2 = std::clamp(value, 0.0f, 1.0f); }
     void SetParam3(float value) { param3 = std::clamp(value, 0.0f, 1.0f); }
 
     AlgorithmOutput Process() {
+        ApplyOversampling();
+        rampAlgorithm = -1;
         switch (algorithmType) {
             case AlgorithmType::DIRICHLET_PULSE:
                 return dirichlet.Process(frequency, param1, param2, param3);
@@ -85,9 +143,9 @@ public:
             case AlgorithmType::DSF_DOUBLE:
                 return dsfDouble.Process(frequency, param1, param2, param3);
             case AlgorithmType::TANH_SQUARE:
-                return tanhSquare.Process(frequency, param1, param2, param3);
+                return ProcessOversampled(tanhSquare);
             case AlgorithmType::TANH_SAW:
-                return tanhSaw.Process(frequency, param1, param2, param3);
+                return ProcessOversampled(tanhSaw);
             case AlgorithmType::PAF:
                 return paf.Process(frequency, param1, param2, param3);
             case AlgorithmType::MOD_FM:
@@ -99,7 +157,7 @@ public:
             case AlgorithmType::COMBINATION_3_PARALLEL_BANK:
                 return combination3.Process(frequency, param1, param2, param3);
             case AlgorithmType::COMBINATION_4_FEEDBACK:
-                return combination4.Process(frequency, param1, param2, param3);
+                return ProcessOversampled(combination4);
             case AlgorithmType::COMBINATION_5_MORPHING:
                 return combination5.Process(frequency, param1, param2, param3);
             case AlgorithmType::COMBINATION_6_INHARMONIC:
@@ -107,7 +165,7 @@ public:
             case AlgorithmType::COMBINATION_7_ADAPTIVE_FILTER:
                 return combination7.Process(frequency, param1, param2, param3);
             case AlgorithmType::NOVEL_1_MULTISTAGE:
-                return novel1.Process(frequency, param1, param2, param3);
+                return ProcessOversampled(novel1);
             case AlgorithmType::NOVEL_2_FREQ_ASYMMETRY:
                 return novel2.Process(frequency, param1, param2, param3);
             case AlgorithmType::NOVEL_3_CROSS_MOD:
@@ -121,10 +179,199 @@ public:
         }
     }
 
+    // Renders n samples with one switch per block. When the settings have
+    // not changed since the previous block the controls are computed once
+    // and held, so the output matches calling Process() n times. When they
+    // have, frequency and params ramp linearly from the previous block's
+    // values, reaching the new ones on the last sample, and the controls are
+    // recomputed every kRampStep samples. The first block after Reset(), an
+    // algorithm change or a per-sample Process() starts on the new values.
+    // At 2x and 4x the ramp runs over the oversampled samples, in chunks of
+    // kOversampledChunk outputs.
+    void ProcessBlock(float* primary, float* secondary, size_t n) {
+        if (n == 0) {
+            return;
+        }
+        ApplyOversampling();
+        switch (algorithmType) {
+            case AlgorithmType::DIRICHLET_PULSE:
+                return RenderBlock(dirichlet, primary, secondary, n);
+            case AlgorithmType::DSF_SINGLE:
+                return RenderBlock(dsfSingle, primary, secondary, n);
+            case AlgorithmType::DSF_DOUBLE:
+                return RenderBlock(dsfDouble, primary, secondary, n);
+            case AlgorithmType::TANH_SQUARE:
+                return RenderOversampled(tanhSquare, primary, secondary, n);
+            case AlgorithmType::TANH_SAW:
+                return RenderOversampled(tanhSaw, primary, secondary, n);
+            case AlgorithmType::PAF:
+                return RenderBlock(paf, primary, secondary, n);
+            case AlgorithmType::MOD_FM:
+                return RenderBlock(modfm, primary, secondary, n);
+            case AlgorithmType::COMBINATION_1_HYBRID_FORMANT:
+                return RenderBlock(combination1, primary, secondary, n);
+            case AlgorithmType::COMBINATION_2_CASCADED:
+                return RenderBlock(combination2, primary, secondary, n);
+            case AlgorithmType::COMBINATION_3_PARALLEL_BANK:
+                return RenderBlock(combination3, primary, secondary, n);
+            case AlgorithmType::COMBINATION_4_FEEDBACK:
+                return RenderOversampled(combination4, primary, secondary, n);
+            case AlgorithmType::COMBINATION_5_MORPHING:
+                return RenderBlock(combination5, primary, secondary, n);
+            case AlgorithmType::COMBINATION_6_INHARMONIC:
+                return RenderBlock(combination6, primary, secondary, n);
+            case AlgorithmType::COMBINATION_7_ADAPTIVE_FILTER:
+                return RenderBlock(combination7, primary, secondary, n);
+            case AlgorithmType::NOVEL_1_MULTISTAGE:
+                return RenderOversampled(novel1, primary, secondary, n);
+            case AlgorithmType::NOVEL_2_FREQ_ASYMMETRY:
+                return RenderBlock(novel2, primary, secondary, n);
+            case AlgorithmType::NOVEL_3_CROSS_MOD:
+                return RenderBlock(novel3, primary, secondary, n);
+            case AlgorithmType::NOVEL_4_TAYLOR:
+                return RenderBlock(novel4, primary, secondary, n);
+            case AlgorithmType::TRAJECTORY:
+                // Its parameters rebuild the polygon, so there is nothing
+                // to hold.
+                return RenderPerSample(trajectory, primary, secondary, n);
+            default:
+                for (size_t i = 0; i < n; ++i) {
+                    const AlgorithmOutput out = ProcessSine();
+                    primary[i] = out.primary;
+                    secondary[i] = out.secondary;
+                }
+                rampAlgorithm = -1;
+                return;
+        }
+    }
+
 private:
+    static constexpr size_t kRampedSettings = 4; // frequency, param1-3
+    static constexpr size_t kOversampledChunk = 48;
+
+    template <typename Algorithm>
+    void RenderBlock(Algorithm& algorithm, float* primary, float* secondary, size_t n) {
+        const float from[kRampedSettings] = {rampStart[0], rampStart[1], rampStart[2], rampStart[3]};
+        const bool ramp = rampAlgorithm == static_cast<int>(algorithmType)
+            && (from[0] != frequency || from[1] != param1 || from[2] != param2 || from[3] != param3);
+        rampStart[0] = frequency;
+        rampStart[1] = param1;
+        rampStart[2] = param2;
+        rampStart[3] = param3;
+        rampAlgorithm = static_cast<int>(algorithmType);
+
+        if (!ramp) {
+            const typename Algorithm::Controls controls = algorithm.ComputeControls(frequency, param1, param2, param3);
+            RenderHeld(algorithm, controls, primary, secondary, n);
+            return;
+        }
+
+        // The settings moved: step them from where the previous block left
+        // them in kRampStep-sample runs, recomputing the controls (and what
+        // they derive, such as a decay's normalisation) for each run.
+        for (size_t start = 0; start < n; start += kRampStep) {
+            const size_t count = std::min(kRampStep, n - start);
+            const float t = static_cast<float>(start + count) / static_cast<float>(n);
+            const typename Algorithm::Controls controls = algorithm.ComputeControls(
+                from[0] + (frequency - from[0]) * t, from[1] + (param1 - from[1]) * t,
+                from[2] + (param2 - from[2]) * t, from[3] + (param3 - from[3]) * t);
+            RenderHeld(algorithm, controls, primary + start, secondary + start, count);
+        }
+    }
+
+    template <typename Algorithm>
+    static void RenderHeld(Algorithm& algorithm, const typename Algorithm::Controls& controls, float* primary,
+                           float* secondary, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const AlgorithmOutput out = algorithm.Render(controls);
+            primary[i] = out.primary;
+            secondary[i] = out.secondary;
+        }
+    }
+
+    // For an algorithm with no controls to hold (see disyn-block-bench
+    // before adding another): one Process() per sample on the current
+    // settings, with the switch still hoisted.
+    template <typename Algorithm>
+    void RenderPerSample(Algorithm& algorithm, float* primary, float* secondary, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const AlgorithmOutput out = algorithm.Process(frequency, param1, param2, param3);
+            primary[i] = out.primary;
+            secondary[i] = out.secondary;
+        }
+        rampAlgorithm = -1;
+    }
+
+    // Moves the oversampled algorithms to the requested rate. Their phases
+    // are fractions of a turn, so they carry on; the decimators start again
+    // from the next sample.
+    void ApplyOversampling() {
+        if (oversampling == appliedOversampling) {
+            return;
+        }
+        appliedOversampling = oversampling;
+        const float rate = sampleRate * static_cast<float>(oversampling);
+        tanhSquare.SetSampleRate(rate);
+        tanhSaw.SetSampleRate(rate);
+        combination4.SetSampleRate(rate);
+        novel1.SetSampleRate(rate);
+        ResetDecimators();
+        rampAlgorithm = -1;
+    }
+
+    void ResetDecimators() {
+        for (auto& stage : decimators) {
+            for (HalfbandDecimator& decimator : stage) {
+                decimator.Reset();
+            }
+        }
+    }
+
+    template <typename Algorithm>
+    void RenderOversampled(Algorithm& algorithm, float* primary, float* secondary, size_t n) {
+        if (appliedOversampling == 1) {
+            return RenderBlock(algorithm, primary, secondary, n);
+        }
+        const size_t factor = static_cast<size_t>(appliedOversampling);
+        for (size_t start = 0; start < n; start += kOversampledChunk) {
+            const size_t count = std::min(kOversampledChunk, n - start);
+            RenderBlock(algorithm, oversampledPrimary, oversampledSecondary, count * factor);
+            Decimate(oversampledPrimary, primary + start, count, 0);
+            Decimate(oversampledSecondary, secondary + start, count, 1);
+        }
+    }
+
+    template <typename Algorithm>
+    AlgorithmOutput ProcessOversampled(Algorithm& algorithm) {
+        if (appliedOversampling == 1) {
+            return algorithm.Process(frequency, param1, param2, param3);
+        }
+        const typename Algorithm::Controls controls = algorithm.ComputeControls(frequency, param1, param2, param3);
+        float primary[kMaxOversampling] = {};
+        float secondary[kMaxOversampling] = {};
+        for (int i = 0; i < appliedOversampling; ++i) {
+            const AlgorithmOutput out = algorithm.Render(controls);
+            primary[i] = out.primary;
+            secondary[i] = out.secondary;
+        }
+        AlgorithmOutput out;
+        Decimate(primary, &out.primary, 1, 0);
+        Decimate(secondary, &out.secondary, 1, 1);
+        return out;
+    }
+
+    // count * appliedOversampling samples in, count out; overwrites the
+    // input when it takes two stages.
+    void Decimate(float* input, float* output, size_t count, size_t channel) {
+        if (appliedOversampling == kMaxOversampling) {
+            decimators[1][channel].Process(input, input, count * 2);
+        }
+        decimators[0][channel].Process(input, output, count);
+    }
+
     AlgorithmOutput ProcessSine() {
-        fallbackPhase = StepPhase(fallbackPhase, frequency, sampleRate);
-        const float output = std::sin(fallbackPhase * kTwoPi);
+        fallbackPhase += PhaseStep(PhaseIncrement(frequency, sampleRate));
+        const float output = SineLookup(fallbackPhase);
         return {output, output};
     }
 
@@ -155,7 +402,25 @@ private:
     Novel4TaylorAlgorithm novel4;
     TrajectoryAlgorithm trajectory;
 
-    float fallbackPhase;
+    uint32_t fallbackPhase;
+
+    // Settings the last ProcessBlock() reached, and which algorithm they
+    // belong to (-1 when the next block should not ramp).
+    float rampStart[kRampedSettings];
+    int rampAlgorithm;
+
+    // Requested tier, and the one the algorithms run at (set on the audio
+    // side by ApplyOversampling()).
+    int oversampling;
+    int appliedOversampling;
+    // [stage][channel]: stage 0 takes 2x to the output rate, stage 1 takes
+    // 4x to 2x.
+    HalfbandDecimator decimators[2][2];
+
+    // Oversampled render scratch. Only used within one call, so every
+    // oscillator shares it.
+    static inline float oversampledPrimary[kMaxOversampling * kOversampledChunk];
+    static inline float oversampledSecondary[kMaxOversampling * kOversampledChunk];
 };
 
 } // namespace disyn
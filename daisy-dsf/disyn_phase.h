@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace disyn {
+
+// Shared oscillator core. A phase is an unsigned 32-bit fraction of a turn,
+// so accumulators wrap for free and offsets (cosine, "phase - theta") are
+// plain integer adds. Sine and cosine come from one 1024-segment table with
+// linear interpolation: the worst error is (2 pi / 1024)^2 / 8, about
+// 4.7e-6 or -106 dB. The table is built at compile time, so it lives in
+// flash and needs no Init().
+//
+// Increments and offsets that depend on the params travel in an
+// algorithm's Controls as floats in phase units (turns * 2^32, wrapped to
+// half a turn either way) so block renders can ramp them; PhaseStep()
+// turns them back into integers.
+
+constexpr int kSineTableBits = 10;
+constexpr size_t kSineTableSize = size_t{1} << kSineTableBits;
+constexpr uint32_t kQuarterTurn = 0x40000000u;
+constexpr uint32_t kHalfTurn = 0x80000000u;
+constexpr float kPhaseUnitsPerTurn = 4294967296.0f;
+constexpr float kTurnsPerRadian = 1.0f / 6.28318530717958647692f;
+constexpr float kPhaseUnitsPerRadian = kPhaseUnitsPerTurn * kTurnsPerRadian;
+constexpr float kTurnsPerPhaseUnit = 1.0f / kPhaseUnitsPerTurn;
+// Largest float below 2^31, so the int32 conversion in PhaseStep is defined.
+constexpr float kMaxPhaseStep = 2147483520.0f;
+
+struct SineTable {
+    float values[kSineTableSize + 1];
+};
+
+// sin(x) for x in [-pi, pi] by the Taylor series, in double so the table is
+// exact to float precision.
+constexpr double SineSeries(double x) {
+    const double x2 = x * x;
+    double term = x;
+    double sum = x;
+    for (int k = 1; k < 20; ++k) {
+        term *= -x2 / ((2.0 * k) * (2.0 * k + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr SineTable MakeSineTable() {
+    constexpr double kPi = 3.14159265358979323846;
+    SineTable table{};
+    for (size_t i = 0; i <= kSineTableSize; ++i) {
+        double x = 2.0 * kPi * static_cast<double>(i) / kSineTableSize;
+        if (x > kPi) {
+            x -= 2.0 * kPi;
+        }
+        table.values[i] = static_cast<float>(SineSeries(x));
+    }
+    return table;
+}
+
+inline constexpr SineTable kSineTable = MakeSineTable();
+
+// Wraps turns to [-0.5, 0.5) and scales to phase units.
+inline float PhaseUnits(float turns) {
+    return (turns - std::floor(turns + 0.5f)) * kPhaseUnitsPerTurn;
+}
+
+inline float PhaseIncrement(float frequency, float sampleRate) {
+    return PhaseUnits(frequency / sampleRate);
+}
+
+// Converts phase units (a ramped Controls value, or radians times
+// kPhaseUnitsPerRadian for |x| < pi) to an integer step or offset.
+inline uint32_t PhaseStep(float units) {
+    return static_cast<uint32_t>(static_cast<int32_t>(std::clamp(units, -kMaxPhaseStep, kMaxPhaseStep)));
+}
+
+// Any angle in radians, wrapped.
+inline uint32_t RadiansToPhase(float radians) {
+    return PhaseStep(PhaseUnits(radians * kTurnsPerRadian));
+}
+
+inline float PhaseToTurns(uint32_t phase) {
+    return static_cast<float>(phase) * kTurnsPerPhaseUnit;
+}
+
+inline float SineLookup(uint32_t phase) {
+    constexpr int kFractionBits = 32 - kSineTableBits;
+    constexpr float kFractionScale = 1.0f / static_cast<float>(1u << kFractionBits);
+    const uint32_t index = phase >> kFractionBits;
+    const float fraction = static_cast<float>(phase & ((1u << kFractionBits) - 1u)) * kFractionScale;
+    const float a = kSineTable.values[index];
+    const float b = kSineTable.values[index + 1];
+    return a + (b - a) * fraction;
+}
+
+inline float CosineLookup(uint32_t phase) {
+    return SineLookup(phase + kQuarterTurn);
+}
+
+// Several phases in one call; the loop has no dependencies between lanes,
+// so the compiler can interleave the table loads.
+inline void SineLookup(const uint32_t* phases, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = SineLookup(phases[i]);
+    }
+}
+
+inline void CosineLookup(const uint32_t* phases, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = SineLookup(phases[i] + kQuarterTurn);
+    }
+}
+
+} // namespace disyn
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "disyn_phase.h"
+
+namespace disyn {
+
+// Cached period of a shaping function of one phase, for algorithms whose
+// costliest term (exp, tanh) depends only on that phase and on settings that
+// rarely move. Shape is a functor float(a, b, phase) for settings a and b.
+//
+// The audio side calls Ready() every sample. While the table holds the shape
+// for (close enough to) the current settings it reads the table with linear
+// interpolation; otherwise it renders directly and Ready() records the
+// settings it wanted. Build() fills the table for the latest request a slice
+// at a time. The firmware calls it from the main loop, so a rebuild never
+// adds to the audio callback, and playback moves to the table only once the
+// whole period is in.
+//
+// The table holds the shaping function, not the output, so it is exact at
+// its points and aliases no differently from direct synthesis. 2048
+// segments keep the interpolation error under -80 dB for the shapes here.
+constexpr int kShapeCacheBits = 11;
+constexpr size_t kShapeCacheSize = size_t{1} << kShapeCacheBits;
+
+template <typename Shape>
+class ShapeCache {
+public:
+    // Settings within this fraction of the table's are served from it, so
+    // ADC jitter on a knob does not keep the table rebuilding.
+    static constexpr float kTolerance = 1.0f / 256.0f;
+
+    constexpr ShapeCache()
+        : values{}, keyA(0.0f), keyB(0.0f), requestA(0.0f), requestB(0.0f), filled(0), ready(false) {}
+
+    // True when the table can stand in for the shape at these settings;
+    // otherwise asks Build() for them.
+    bool Ready(float a, float b) {
+        if (ready.load(std::memory_order_acquire) && Near(a, keyA) && Near(b, keyB)) {
+            return true;
+        }
+        requestA = a;
+        requestB = b;
+        return false;
+    }
+
+    float Read(uint32_t phase) const {
+        constexpr int kFractionBits = 32 - kShapeCacheBits;
+        constexpr float kFractionScale = 1.0f / static_cast<float>(1u << kFractionBits);
+        const uint32_t index = phase >> kFractionBits;
+        const float fraction = static_cast<float>(phase & ((1u << kFractionBits) - 1u)) * kFractionScale;
+        const float a = values[index];
+        const float b = values[index + 1];
+        return a + (b - a) * fraction;
+    }
+
+    // Computes up to `entries` table points for the latest request,
+    // starting over when the request has moved since the last call.
+    void Build(size_t entries) {
+        const float a = requestA;
+        const float b = requestB;
+        if (!Near(a, keyA) || !Near(b, keyB)) {
+            // Readers check the flag before the key, so it drops first.
+            // A release store alone would let the plain writes below move
+            // above it; the reader is the audio interrupt on this core, so
+            // a signal fence is enough to keep them after.
+            ready.store(false, std::memory_order_seq_cst);
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            keyA = a;
+            keyB = b;
+            filled = 0;
+        }
+        if (filled > kShapeCacheSize) {
+            return;
+        }
+
+        constexpr int kIndexShift = 32 - kShapeCacheBits;
+        const size_t end = std::min(filled + entries, kShapeCacheSize + 1);
+        for (size_t i = filled; i < end; ++i) {
+            // The last point wraps to phase 0, closing the period.
+            values[i] = shape(keyA, keyB, static_cast<uint32_t>(i << kIndexShift));
+        }
+        filled = end;
+        if (filled > kShapeCacheSize) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            ready.store(true, std::memory_order_release);
+        }
+    }
+
+private:
+    static bool Near(float value, float key) {
+        return std::abs(value - key) <= kTolerance * std::abs(key);
+    }
+
+    Shape shape;
+    float values[kShapeCacheSize + 1];
+    float keyA;
+    float keyB;
+    float requestA;
+    float requestB;
+    size_t filled;
+    std::atomic<bool> ready;
+};
+
+} // namespace disyn
@@ -0,0 +1,414 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "disyn_oscillator.h"
+#include "disyn_voice_lanes.h"
+
+namespace disyn {
+
+// Polyphonic voice engine: up to kMaxVoices notes of the current algorithm,
+// each with its own attack/release envelope and velocity gain, summed into
+// one primary and one secondary output.
+//
+// Voices are packed into groups of kVoiceLanes. The allocator hands out the
+// lowest free voice, so a chord fills as few groups as possible, and only
+// groups with a sounding voice are rendered. Only Tanh Square, Tanh Saw, DSF
+// Single and ModFM have a packed kernel (disyn_voice_lanes.h), which renders
+// a whole group per sample and holds or ramps each voice's settings as
+// DisynOscillator::ProcessBlock() does. The rest render voice by voice
+// through a DisynOscillator each, so they cost about N mono blocks. When every voice is taken a new note
+// steals the quietest released voice, or failing that the oldest held one.
+class PolyVoiceEngine {
+public:
+    static constexpr size_t kMaxVoices = 16;
+    static constexpr size_t kGroups = kMaxVoices / kVoiceLanes;
+    static constexpr size_t kMaxBlock = 48;
+
+    explicit PolyVoiceEngine(float sampleRate = 48000.0f) {
+        Init(sampleRate);
+    }
+
+    // Sets everything in place: the engine is too big to build a copy on
+    // the stack and assign it.
+    void Init(float sampleRateIn) {
+        sampleRate = sampleRateIn;
+        algorithmType = AlgorithmType::TANH_SQUARE;
+        requestedAlgorithm = static_cast<int>(algorithmType);
+        voiceCount = 8;
+        pitchScale = 1.0f;
+        param1 = 0.5f;
+        param2 = 0.5f;
+        param3 = 0.5f;
+        noteCounter = 0u;
+        for (size_t v = 0; v < kMaxVoices; ++v) {
+            frequency[v] = 0.0f;
+            gain[v] = 0.0f;
+            level[v] = 0.0f;
+            stage[v] = IDLE;
+            note[v] = 0;
+            age[v] = 0u;
+            rampValid[v] = false;
+            voices[v].Init(sampleRate);
+            voices[v].SetShapeCache(true);
+        }
+        for (size_t g = 0; g < kGroups; ++g) {
+            tanhSquare[g].Init(sampleRate);
+            tanhSaw[g].Init(sampleRate);
+            dsfSingle[g].Init(sampleRate);
+            modfm[g].Init(sampleRate);
+        }
+        SetAttack(0.005f);
+        SetRelease(0.2f);
+    }
+
+    // Silences every voice at once.
+    void Reset() {
+        for (size_t v = 0; v < kMaxVoices; ++v) {
+            stage[v] = IDLE;
+            level[v] = 0.0f;
+            ResetVoice(v);
+        }
+    }
+
+    // Takes effect at the next render, so the firmware can set it from
+    // outside the audio callback.
+    void SetAlgorithm(int type) {
+        if (type < 0 || type > 18) {
+            return;
+        }
+        requestedAlgorithm = type;
+    }
+
+    // Voices beyond a lowered count are released, not cut.
+    void SetVoiceCount(size_t count) {
+        voiceCount = std::clamp(count, size_t{1}, kMaxVoices);
+        for (size_t v = voiceCount; v < kMaxVoices; ++v) {
+            if (stage[v] == ATTACK || stage[v] == HOLD) {
+                stage[v] = RELEASE;
+            }
+        }
+    }
+
+    // Pitch multiplier applied to every note (CV, calibration).
+    void SetPitchScale(float scale) { pitchScale = std::max(scale, 0.0f); }
+
+    void SetParam1(float value) { param1 = std::clamp(value, 0.0f, 1.0f); }
+    void SetParam2(float value) { param2 = std::clamp(value, 0.0f, 1.0f); }
+    void SetParam3(float value) { param3 = std::clamp(value, 0.0f, 1.0f); }
+
+    // Linear rise to full level; zero seconds starts at full level.
+    void SetAttack(float seconds) {
+        const float samples = seconds * sampleRate;
+        attackStep = samples > 1.0f ? 1.0f / samples : 1.0f;
+    }
+
+    // Exponential fall to -60 dB over the given time.
+    void SetRelease(float seconds) {
+        const float samples = std::max(seconds * sampleRate, 1.0f);
+        releaseCoeff = std::exp(-6.9077553f / samples);
+    }
+
+    void NoteOn(uint8_t noteNumber, uint8_t velocity) {
+        if (velocity == 0) {
+            NoteOff(noteNumber);
+            return;
+        }
+        const size_t v = AllocateVoice(noteNumber);
+        if (stage[v] == IDLE) {
+            // A fresh voice starts its phases from zero; a stolen one keeps
+            // running so the takeover does not click.
+            ResetVoice(v);
+        }
+        note[v] = noteNumber;
+        frequency[v] = 440.0f * std::pow(2.0f, (static_cast<float>(noteNumber) - 69.0f) / 12.0f);
+        gain[v] = static_cast<float>(velocity) / 127.0f;
+        stage[v] = ATTACK;
+        age[v] = ++noteCounter;
+        rampValid[v] = false;
+    }
+
+    void NoteOff(uint8_t noteNumber) {
+        for (size_t v = 0; v < kMaxVoices; ++v) {
+            if (note[v] == noteNumber && (stage[v] == ATTACK || stage[v] == HOLD)) {
+                stage[v] = RELEASE;
+            }
+        }
+    }
+
+    void AllNotesOff() {
+        for (size_t v = 0; v < kMaxVoices; ++v) {
+            if (stage[v] != IDLE) {
+                stage[v] = RELEASE;
+            }
+        }
+    }
+
+    size_t ActiveVoices() const {
+        size_t count = 0;
+        for (size_t v = 0; v < kMaxVoices; ++v) {
+            count += stage[v] != IDLE ? 1 : 0;
+        }
+        return count;
+    }
+
+    // Renders and sums every sounding voice into primary and secondary
+    // (overwritten), kMaxBlock samples at a time.
+    void ProcessBlock(float* primary, float* secondary, size_t n) {
+        ApplyAlgorithm();
+        for (size_t start = 0; start < n; start += kMaxBlock) {
+            RenderChunk(primary + start, secondary + start, std::min(kMaxBlock, n - start));
+        }
+    }
+
+private:
+    enum Stage : uint8_t { IDLE, ATTACK, HOLD, RELEASE };
+
+    static constexpr size_t kMaxControls = 8;
+    static constexpr size_t kRampedSettings = 4; // frequency, param1-3
+    static constexpr size_t kRampStep = DisynOscillator::kRampStep;
+    // Released voices below this level (-80 dB) are freed.
+    static constexpr float kSilence = 1.0e-4f;
+
+    // Moves every voice to the requested algorithm, with its phases
+    // starting over.
+    void ApplyAlgorithm() {
+        if (requestedAlgorithm == static_cast<int>(algorithmType)) {
+            return;
+        }
+        algorithmType = static_cast<AlgorithmType>(requestedAlgorithm);
+        for (size_t v = 0; v < kMaxVoices; ++v) {
+            voices[v].SetAlgorithm(requestedAlgorithm);
+            ResetVoice(v);
+        }
+    }
+
+    void ResetVoice(size_t v) {
+        voices[v].Reset();
+        const size_t group = v / kVoiceLanes;
+        const size_t lane = v % kVoiceLanes;
+        tanhSquare[group].Reset(lane);
+        tanhSaw[group].Reset(lane);
+        dsfSingle[group].Reset(lane);
+        modfm[group].Reset(lane);
+        rampValid[v] = false;
+    }
+
+    size_t AllocateVoice(uint8_t noteNumber) {
+        // Retrigger a voice already on this note.
+        for (size_t v = 0; v < voiceCount; ++v) {
+            if (stage[v] != IDLE && note[v] == noteNumber) {
+                return v;
+            }
+        }
+        for (size_t v = 0; v < voiceCount; ++v) {
+            if (stage[v] == IDLE) {
+                return v;
+            }
+        }
+        size_t quietest = kMaxVoices;
+        size_t oldest = 0;
+        for (size_t v = 0; v < voiceCount; ++v) {
+            if (stage[v] == RELEASE && (quietest == kMaxVoices || level[v] < level[quietest])) {
+                quietest = v;
+            }
+            if (age[v] < age[oldest]) {
+                oldest = v;
+            }
+        }
+        return quietest != kMaxVoices ? quietest : oldest;
+    }
+
+    // Advances voice v's envelope over n samples, times its velocity gain.
+    void RenderEnvelope(size_t v, float* out, size_t n) {
+        float value = level[v];
+        for (size_t i = 0; i < n; ++i) {
+            switch (stage[v]) {
+                case ATTACK:
+                    value += attackStep;
+                    if (value >= 1.0f) {
+                        value = 1.0f;
+                        stage[v] = HOLD;
+                    }
+                    break;
+                case RELEASE:
+                    value *= releaseCoeff;
+                    if (value < kSilence) {
+                        value = 0.0f;
+                        stage[v] = IDLE;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            out[i] = value * gain[v];
+        }
+        level[v] = value;
+    }
+
+    bool GroupSounding(size_t group) const {
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            if (stage[group * kVoiceLanes + l] != IDLE) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void RenderChunk(float* primary, float* secondary, size_t n) {
+        std::fill(primary, primary + n, 0.0f);
+        std::fill(secondary, secondary + n, 0.0f);
+        if (n == 0) {
+            return;
+        }
+        switch (algorithmType) {
+            case AlgorithmType::TANH_SQUARE:
+                return RenderPacked(tanhSquare, primary, secondary, n);
+            case AlgorithmType::TANH_SAW:
+                return RenderPacked(tanhSaw, primary, secondary, n);
+            case AlgorithmType::DSF_SINGLE:
+                return RenderPacked(dsfSingle, primary, secondary, n);
+            case AlgorithmType::MOD_FM:
+                return RenderPacked(modfm, primary, secondary, n);
+            default:
+                return RenderVoices(primary, secondary, n);
+        }
+    }
+
+    template <typename Lanes>
+    void RenderPacked(Lanes* groups, float* primary, float* secondary, size_t n) {
+        using Controls = typename Lanes::Controls;
+        using LaneControls = typename Lanes::LaneControls;
+        constexpr size_t count = sizeof(Controls) / sizeof(float);
+        static_assert(sizeof(Controls) == count * sizeof(float), "Controls must hold only floats");
+        static_assert(count <= kMaxControls, "Controls do not fit a lane");
+        static_assert(sizeof(LaneControls) == sizeof(Controls) * kVoiceLanes,
+                      "LaneControls must hold every control once per lane");
+
+        for (size_t g = 0; g < kGroups; ++g) {
+            if (!GroupSounding(g)) {
+                continue;
+            }
+            Lanes& lanes = groups[g];
+
+            // As DisynOscillator::ProcessBlock(): a lane whose settings have
+            // not moved holds its controls, and one whose have ramps them
+            // from the previous chunk's, with the controls recomputed every
+            // kRampStep samples. Idle lanes render too, silenced by their
+            // zero envelope, so the lane loops stay free of branches.
+            float from[kVoiceLanes][kRampedSettings];
+            float to[kVoiceLanes][kRampedSettings];
+            bool ramp = false;
+            for (size_t l = 0; l < kVoiceLanes; ++l) {
+                const size_t v = g * kVoiceLanes + l;
+                RenderEnvelope(v, envelope[l], n);
+
+                to[l][0] = frequency[v] * pitchScale;
+                to[l][1] = param1;
+                to[l][2] = param2;
+                to[l][3] = param3;
+                for (size_t k = 0; k < kRampedSettings; ++k) {
+                    from[l][k] = rampValid[v] ? rampStart[v][k] : to[l][k];
+                    ramp = ramp || from[l][k] != to[l][k];
+                    rampStart[v][k] = to[l][k];
+                }
+                rampValid[v] = true;
+            }
+
+            const size_t step = ramp ? kRampStep : n;
+            LaneControls controls;
+            for (size_t start = 0; start < n; start += step) {
+                const size_t run = std::min(step, n - start);
+                const float t = static_cast<float>(start + run) / static_cast<float>(n);
+                // Control-major, [control][lane], the layout of LaneControls.
+                float packed[count][kVoiceLanes];
+                for (size_t l = 0; l < kVoiceLanes; ++l) {
+                    const Controls laneControls = lanes.ComputeControls(
+                        from[l][0] + (to[l][0] - from[l][0]) * t, from[l][1] + (to[l][1] - from[l][1]) * t,
+                        from[l][2] + (to[l][2] - from[l][2]) * t, from[l][3] + (to[l][3] - from[l][3]) * t);
+                    float values[count];
+                    std::memcpy(values, &laneControls, sizeof(Controls));
+                    for (size_t k = 0; k < count; ++k) {
+                        packed[k][l] = values[k];
+                    }
+                }
+                std::memcpy(&controls, packed, sizeof(LaneControls));
+                RenderHeld(lanes, controls, primary, secondary, start, start + run);
+            }
+        }
+    }
+
+    // Samples [begin, end) of the chunk on fixed controls.
+    template <typename Lanes>
+    void RenderHeld(Lanes& lanes, const typename Lanes::LaneControls& controls, float* primary, float* secondary,
+                    size_t begin, size_t end) {
+        float lanePrimary[kVoiceLanes];
+        float laneSecondary[kVoiceLanes];
+        for (size_t i = begin; i < end; ++i) {
+            lanes.Render(controls, lanePrimary, laneSecondary);
+            for (size_t l = 0; l < kVoiceLanes; ++l) {
+                primary[i] += lanePrimary[l] * envelope[l][i];
+                secondary[i] += laneSecondary[l] * envelope[l][i];
+            }
+        }
+    }
+
+    void RenderVoices(float* primary, float* secondary, size_t n) {
+        for (size_t v = 0; v < kMaxVoices; ++v) {
+            if (stage[v] == IDLE) {
+                continue;
+            }
+            RenderEnvelope(v, envelope[0], n);
+            DisynOscillator& osc = voices[v];
+            osc.SetFrequency(frequency[v] * pitchScale);
+            osc.SetParam1(param1);
+            osc.SetParam2(param2);
+            osc.SetParam3(param3);
+            osc.ProcessBlock(voicePrimary, voiceSecondary, n);
+            for (size_t i = 0; i < n; ++i) {
+                primary[i] += voicePrimary[i] * envelope[0][i];
+                secondary[i] += voiceSecondary[i] * envelope[0][i];
+            }
+        }
+    }
+
+    float sampleRate;
+    AlgorithmType algorithmType;
+    // Set from outside the audio callback, applied by the next render.
+    int requestedAlgorithm;
+    size_t voiceCount;
+    float pitchScale;
+    float param1;
+    float param2;
+    float param3;
+    float attackStep;
+    float releaseCoeff;
+    uint32_t noteCounter;
+
+    // Per-voice state, one entry per voice.
+    float frequency[kMaxVoices];
+    float gain[kMaxVoices];
+    float level[kMaxVoices];
+    Stage stage[kMaxVoices];
+    uint8_t note[kMaxVoices];
+    uint32_t age[kMaxVoices];
+    bool rampValid[kMaxVoices];
+    float rampStart[kMaxVoices][kRampedSettings];
+
+    DisynOscillator voices[kMaxVoices];
+    TanhSquareLanes tanhSquare[kGroups];
+    TanhSawLanes tanhSaw[kGroups];
+    DSFSingleLanes dsfSingle[kGroups];
+    ModFMLanes modfm[kGroups];
+
+    // Scratch for one chunk.
+    float envelope[kVoiceLanes][kMaxBlock];
+    float voicePrimary[kMaxBlock];
+    float voiceSecondary[kMaxBlock];
+};
+
+} // namespace disyn
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "disyn_algorithms.h"
+
+namespace disyn {
+
+// Packed voice kernels for the polyphonic engine. A kernel holds the running
+// state of kVoiceLanes voices of one algorithm as arrays (one entry per
+// lane) and renders one sample for all of them per Render() call. The lanes
+// have no dependencies on each other, so the compiler can vectorise the
+// arithmetic where the target has SIMD and otherwise interleave the lanes'
+// table loads and FPU work, which is where an in-order core gains.
+//
+// Each kernel reuses its algorithm's ComputeControls() and repeats its
+// Render() maths operation for operation, so a lane produces exactly what a
+// DisynOscillator would. Algorithms without a kernel are rendered voice by
+// voice (see PolyVoiceEngine).
+
+constexpr size_t kVoiceLanes = 4;
+
+class TanhSquareLanes {
+public:
+    using Algorithm = TanhSquareAlgorithm;
+    using Controls = Algorithm::Controls;
+
+    struct LaneControls {
+        float increment[kVoiceLanes];
+        float drive[kVoiceLanes];
+        float trim[kVoiceLanes];
+        float bias[kVoiceLanes];
+    };
+
+    explicit TanhSquareLanes(float sampleRate = 48000.0f)
+        : mapper(sampleRate), phase{} {}
+
+    void Reset(size_t lane) { phase[lane] = 0u; }
+
+    // Back to a fresh kernel at this rate, in place.
+    void Init(float sampleRate) {
+        mapper = Algorithm(sampleRate);
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            Reset(l);
+        }
+    }
+
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
+        return mapper.ComputeControls(pitch, param1, param2, param3);
+    }
+
+    void Render(const LaneControls& c, float* primary, float* secondary) {
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            phase[l] += PhaseStep(c.increment[l]);
+        }
+        float sine[kVoiceLanes];
+        SineLookup(phase, sine, kVoiceLanes);
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            primary[l] = std::tanh((sine[l] + c.bias[l]) * c.drive[l]) * c.trim[l];
+            secondary[l] = std::tanh(sine[l] * c.drive[l]) * c.trim[l];
+        }
+    }
+
+private:
+    Algorithm mapper;
+    uint32_t phase[kVoiceLanes];
+};
+
+class TanhSawLanes {
+public:
+    using Algorithm = TanhSawAlgorithm;
+    using Controls = Algorithm::Controls;
+
+    struct LaneControls {
+        float increment[kVoiceLanes];
+        float drive[kVoiceLanes];
+        float blend[kVoiceLanes];
+        float edge[kVoiceLanes];
+    };
+
+    explicit TanhSawLanes(float sampleRate = 48000.0f)
+        : mapper(sampleRate), phase{}, secondaryPhase{} {}
+
+    void Reset(size_t lane) {
+        phase[lane] = 0u;
+        secondaryPhase[lane] = 0u;
+    }
+
+    // Back to a fresh kernel at this rate, in place.
+    void Init(float sampleRate) {
+        mapper = Algorithm(sampleRate);
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            Reset(l);
+        }
+    }
+
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
+        return mapper.ComputeControls(pitch, param1, param2, param3);
+    }
+
+    void Render(const LaneControls& c, float* primary, float* secondary) {
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            const uint32_t step = PhaseStep(c.increment[l]);
+            phase[l] += step;
+            secondaryPhase[l] += step;
+        }
+        float sine[kVoiceLanes];
+        float cosine[kVoiceLanes];
+        SineLookup(phase, sine, kVoiceLanes);
+        CosineLookup(secondaryPhase, cosine, kVoiceLanes);
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            const float square = std::tanh(sine[l] * c.drive[l]);
+            const float saw = square + cosine[l] * (1.0f - square * square) * c.edge[l];
+            primary[l] = square * (1.0f - c.blend[l]) + saw * c.blend[l];
+            secondary[l] = square;
+        }
+    }
+
+private:
+    Algorithm mapper;
+    uint32_t phase[kVoiceLanes];
+    uint32_t secondaryPhase[kVoiceLanes];
+};
+
+class DSFSingleLanes {
+public:
+    using Algorithm = DSFSingleAlgorithm;
+    using Controls = Algorithm::Controls;
+
+    struct LaneControls {
+        float increment[kVoiceLanes];
+        float secondaryIncrement[kVoiceLanes];
+        float decay[kVoiceLanes];
+        float normalise[kVoiceLanes];
+        float mix[kVoiceLanes];
+    };
+
+    explicit DSFSingleLanes(float sampleRate = 48000.0f)
+        : mapper(sampleRate), phase{}, secondaryPhase{} {}
+
+    void Reset(size_t lane) {
+        phase[lane] = 0u;
+        secondaryPhase[lane] = 0u;
+    }
+
+    // Back to a fresh kernel at this rate, in place.
+    void Init(float sampleRate) {
+        mapper = Algorithm(sampleRate);
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            Reset(l);
+        }
+    }
+
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
+        return mapper.ComputeControls(pitch, param1, param2, param3);
+    }
+
+    void Render(const LaneControls& c, float* primary, float* secondary) {
+        uint32_t difference[kVoiceLanes];
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            phase[l] += PhaseStep(c.increment[l]);
+            secondaryPhase[l] += PhaseStep(c.secondaryIncrement[l]);
+            difference[l] = phase[l] - secondaryPhase[l];
+        }
+        float sine[kVoiceLanes];
+        float sineDifference[kVoiceLanes];
+        float cosine[kVoiceLanes];
+        SineLookup(phase, sine, kVoiceLanes);
+        SineLookup(difference, sineDifference, kVoiceLanes);
+        CosineLookup(secondaryPhase, cosine, kVoiceLanes);
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            // ComputeDSFComponent() on the looked-up values.
+            const float decay = c.decay[l];
+            const float denominator = 1.0f - 2.0f * decay * cosine[l] + decay * decay;
+            float dsf = 0.0f;
+            if (std::abs(denominator) >= kEpsilon) {
+                dsf = ((sine[l] - decay * sineDifference[l]) / denominator) * c.normalise[l];
+            }
+            dsf *= 0.5f;
+            const float half = sine[l] * 0.5f;
+            primary[l] = dsf * (1.0f - c.mix[l]) + half * c.mix[l];
+            secondary[l] = dsf;
+        }
+    }
+
+private:
+    Algorithm mapper;
+    uint32_t phase[kVoiceLanes];
+    uint32_t secondaryPhase[kVoiceLanes];
+};
+
+class ModFMLanes {
+public:
+    using Algorithm = ModFMAlgorithm;
+    using Controls = Algorithm::Controls;
+
+    struct LaneControls {
+        float increment[kVoiceLanes];
+        float modIncrement[kVoiceLanes];
+        float index[kVoiceLanes];
+        float feedback[kVoiceLanes];
+        float envelope[kVoiceLanes];
+    };
+
+    explicit ModFMLanes(float sampleRate = 48000.0f)
+        : mapper(sampleRate), phase{}, modPhase{} {}
+
+    void Reset(size_t lane) {
+        phase[lane] = 0u;
+        modPhase[lane] = 0u;
+    }
+
+    // Back to a fresh kernel at this rate, in place.
+    void Init(float sampleRate) {
+        mapper = Algorithm(sampleRate);
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            Reset(l);
+        }
+    }
+
+    Controls ComputeControls(float pitch, float param1, float param2, float param3) const {
+        return mapper.ComputeControls(pitch, param1, param2, param3);
+    }
+
+    void Render(const LaneControls& c, float* primary, float* secondary) {
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            phase[l] += PhaseStep(c.increment[l]);
+            modPhase[l] += PhaseStep(c.modIncrement[l]);
+        }
+        float carrier[kVoiceLanes];
+        float modSine[kVoiceLanes];
+        CosineLookup(phase, carrier, kVoiceLanes);
+        SineLookup(modPhase, modSine, kVoiceLanes);
+
+        uint32_t swung[kVoiceLanes];
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            const float swing = c.feedback[l] * modSine[l] * kPhaseUnitsPerRadian;
+            swung[l] = modPhase[l] + PhaseStep(swing);
+        }
+        float modulator[kVoiceLanes];
+        CosineLookup(swung, modulator, kVoiceLanes);
+
+        for (size_t l = 0; l < kVoiceLanes; ++l) {
+            primary[l] = carrier[l] * std::exp(c.index[l] * (modulator[l] - 1.0f)) * c.envelope[l] * 0.6f;
+            secondary[l] = carrier[l] * modulator[l] * c.envelope[l] * 0.6f;
+        }
+    }
+
+private:
+    Algorithm mapper;
+    uint32_t phase[kVoiceLanes];
+    uint32_t modPhase[kVoiceLanes];
+};
+
+} // namespace disyn
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <math.h>
+#include "dsf_phasor.h"
 #include "Utility/delayline.h"
 
 using namespace daisysp;
@@ -42,6 +43,10 @@ public:
         throughZero_ = false;
         phaseReversed_ = false;
         currentAmplitude_ = 0.0f;
+        recursive_ = false;
+        usePhasors_ = false;
+        lastPhaseInc_ = 0.0f;
+        lastHarmonics_ = 0;
         delayTime1_ = 100.0f;  // 100ms default
         delayTime2_ = 100.0f;
         audioInput1_ = 0.0f;
@@ -52,12 +57,17 @@ public:
         sampleRate_ = sampleRate;
         phase_ = 0.0f;
         UpdatePhaseIncrement();
+        phasors_.Invalidate();
         delayLine1_.Init();
         delayLine2_.Init();
     }
     
     float Process() {
         float output = 0.0f;
+
+        if (recursive_) {
+            UpdatePhasors();
+        }
         
         switch(algorithm_) {
             case CLASSIC_DSF:
@@ -94,6 +104,9 @@ public:
         if (phase_ < 0.0f) {
             phase_ += M_TWOPI;
         }
+        if (usePhasors_) {
+            phasors_.Rotate();
+        }
         
         return output;
     }
@@ -126,6 +139,18 @@ public:
         algorithm_ = alg;
     }
     
+    // Recursive evaluation: the DSF kernels read rotating phasors instead of
+    // calling sinf/cosf while the frequency holds (see dsf_phasor.h).
+    // Samples where the frequency just changed, as under audio-rate FM, are
+    // evaluated directly.
+    void SetRecursive(bool enable) {
+        recursive_ = enable;
+        if (!enable) {
+            usePhasors_ = false;
+            phasors_.Invalidate();
+        }
+    }
+
     void SetThroughZero(bool enable) {
         throughZero_ = enable;
         if (!enable) {
@@ -164,6 +189,7 @@ public:
     float GetPhase() const { return phase_; }
     float GetCurrentAmplitude() const { return currentAmplitude_; }
     Algorithm GetCurrentAlgorithm() const { return algorithm_; }
+    bool IsRecursive() const { return recursive_; }
     
 private:
     float phase_;
@@ -178,6 +204,13 @@ private:
     bool phaseReversed_;
     float currentAmplitude_;
 
+    // Recursive evaluation state
+    DSFPhasors phasors_;
+    bool recursive_;
+    bool usePhasors_;   // Phasors hold this sample's phase
+    float lastPhaseInc_;
+    int lastHarmonics_;
+
     // Resonator delay members
     DelayLine<float, 12000> delayLine1_;  // 250ms max delay for channel 1 (@ 48kHz)
     DelayLine<float, 12000> delayLine2_;  // 250ms max delay for channel 2
@@ -189,6 +222,25 @@ private:
     void UpdatePhaseIncrement() {
         phaseInc_ = (M_TWOPI * freq_) / sampleRate_;
     }
+
+    /**
+     * Keeps the phasors rotating while the increment and N hold, resyncs
+     * them on schedule, and drops to direct evaluation for a sample when
+     * either just changed.
+     */
+    void UpdatePhasors() {
+        if (phasors_.InSync(phaseInc_, numHarmonics_)) {
+            usePhasors_ = true;
+        } else if (phaseInc_ == lastPhaseInc_ && numHarmonics_ == lastHarmonics_) {
+            phasors_.Sync(phase_, phaseInc_, numHarmonics_);
+            usePhasors_ = true;
+        } else {
+            phasors_.Invalidate();
+            usePhasors_ = false;
+        }
+        lastPhaseInc_ = phaseInc_;
+        lastHarmonics_ = numHarmonics_;
+    }
     
     /**
      * Classic DSF - Moorer 1976
@@ -198,13 +250,24 @@ private:
         float N = (float)numHarmonics_;
         float a = alpha_;
         
+        float sinPhase, cosNPhase, sinDiff;
+        if (usePhasors_) {
+            sinPhase = phasors_.Sin1();
+            cosNPhase = phasors_.CosN();
+            sinDiff = phasors_.SinDifference();
+        } else {
+            sinPhase = sinf(phase_);
+            cosNPhase = cosf(N * phase_);
+            sinDiff = sinf(phase_ - N * phase_);
+        }
+        
         // Avoid division by zero
-        float denominator = 1.0f + a*a - 2.0f*a*cosf(N * phase_);
+        float denominator = 1.0f + a*a - 2.0f*a*cosNPhase;
         if (fabsf(denominator) < 1e-10f) {
             return 0.0f;
         }
         
-        float numerator = sinf(phase_) - a * sinf(phase_ - N * phase_);
+        float numerator = sinPhase - a * sinDiff;
         
         return numerator / denominator;
     }
@@ -219,16 +282,32 @@ private:
         
         // Carrier and modulator phases
         float modPhase = phase_ * N;
-        float modulated = phase_ + beta * sinf(modPhase);
+        float sinMod, cosMod;
+        if (usePhasors_) {
+            sinMod = phasors_.SinN();
+            cosMod = phasors_.CosN();
+        } else {
+            sinMod = sinf(modPhase);
+            cosMod = cosf(modPhase);
+        }
+        float modulated = phase_ + beta * sinMod;
         
         float a = alpha_;
-        float denominator = 1.0f + a*a - 2.0f*a*cosf(modPhase);
+        float denominator = 1.0f + a*a - 2.0f*a*cosMod;
         
         if (fabsf(denominator) < 1e-10f) {
             return 0.0f;
         }
         
-        float numerator = sinf(modulated) - a * sinf(modulated - modPhase);
+        float sinModulated = sinf(modulated);
+        float sinDiff;
+        if (usePhasors_) {
+            // sin(modulated - modPhase) from the modulator phasor
+            sinDiff = sinModulated * cosMod - cosf(modulated) * sinMod;
+        } else {
+            sinDiff = sinf(modulated - modPhase);
+        }
+        float numerator = sinModulated - a * sinDiff;
         
         return numerator / denominator;
     }
@@ -254,6 +333,10 @@ private:
         float N = (float)numHarmonics_;
         float a = alpha_;
         
+        if (usePhasors_) {
+            return ComplexDSFFromPhasors(a);
+        }
+        
         // First term (fundamental)
         float denom1 = 1.0f + a*a - 2.0f*a*cosf(N * phase_);
         float term1 = 0.0f;
@@ -273,6 +356,30 @@ private:
         return term1 + 0.5f * term2;
     }
     
+    /**
+     * Complex DSF from the phasors: both terms share cos(N * phase), and
+     * the second harmonic is z1 squared.
+     */
+    float ComplexDSFFromPhasors(float a) {
+        const float s1 = phasors_.Sin1();
+        const float c1 = phasors_.Cos1();
+        const float sN = phasors_.SinN();
+        const float cN = phasors_.CosN();
+        
+        float denom = 1.0f + a*a - 2.0f*a*cN;
+        if (fabsf(denom) <= 1e-10f) {
+            return 0.0f;
+        }
+        
+        float term1 = (s1 - a * phasors_.SinDifference()) / denom;
+        
+        float s2 = 2.0f * s1 * c1;
+        float c2 = c1 * c1 - s1 * s1;
+        float term2 = (s2 - a * (s2 * cN - c2 * sN)) / denom;
+        
+        return term1 + 0.5f * term2;
+    }
+    
     /**
      * Soft clipping waveshaper
      */
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// Parallel bank of bandpass formants for one or two channels. Each band is a
+// double-sampled Chamberlin state-variable filter doing the same arithmetic
+// as daisysp::Svf's band output, so a bank can stand in for a set of Svfs.
+//
+// Everything is stored structure-of-arrays, one lane per (formant, channel)
+// with each formant's channels side by side, and Process() steps the lanes
+// in pairs. The two lanes of a pair are independent dependency chains: the
+// Cortex-M7's FPU has no float SIMD but overlaps them instead of waiting out
+// one filter at a time, and a host compiler can pack them into vector lanes.
+// Frequency and resonance targets glide once per block in Prepare(), which
+// also does the sinf and powf that Svf::SetFreq costs per call, so nothing
+// per sample touches trig.
+class FormantBank
+{
+public:
+    static constexpr int kMaxFormants = 8;
+    static constexpr int kMaxChannels = 2;
+    static constexpr int kMaxLanes = kMaxFormants * kMaxChannels;
+
+    void Init(float sampleRate, int formants, int channels)
+    {
+        sampleRate_ = sampleRate;
+        formants_ = std::clamp(formants, 1, kMaxFormants);
+        channels_ = std::clamp(channels, 1, kMaxChannels);
+        std::fill(targetFreq_, targetFreq_ + kMaxLanes, 1000.0f);
+        std::fill(targetRes_, targetRes_ + kMaxLanes, 0.5f);
+        std::fill(gain_, gain_ + kMaxLanes, 1.0f);
+        drive_ = 0.5f;
+        smoothing_ = 0.0f;
+        Reset();
+    }
+
+    // Clears the filters. The next Prepare() starts on the targets rather
+    // than gliding to them.
+    void Reset()
+    {
+        std::fill(low_, low_ + kMaxLanes, 0.0f);
+        std::fill(band_, band_ + kMaxLanes, 0.0f);
+        primed_ = false;
+    }
+
+    // Time constant of the glide towards new targets; 0 jumps each block.
+    void SetSmoothing(float seconds)
+    {
+        smoothing_ = std::max(seconds, 0.0f);
+    }
+
+    // The cubic term that bounds the band at high resonance is drive * res,
+    // as in Svf, where Init leaves the pre-drive at 0.5.
+    void SetDrive(float drive)
+    {
+        drive_ = drive;
+    }
+
+    void SetFormant(int channel, int formant, float freqHz, float res, float gain)
+    {
+        const int lane = Lane(channel, formant);
+        targetFreq_[lane] = freqHz;
+        targetRes_[lane] = std::clamp(res, 0.0f, 1.0f);
+        gain_[lane] = gain;
+    }
+
+    // Once per block, before that block's Process() calls.
+    void Prepare(size_t blockSize)
+    {
+        const int lanes = formants_ * channels_;
+        if (!primed_ || smoothing_ <= 0.0f)
+        {
+            std::copy(targetFreq_, targetFreq_ + lanes, freqHz_);
+            std::copy(targetRes_, targetRes_ + lanes, res_);
+            primed_ = true;
+        }
+        else
+        {
+            const float alpha = 1.0f - std::exp(-static_cast<float>(blockSize) / (smoothing_ * sampleRate_));
+            for (int i = 0; i < lanes; ++i)
+            {
+                freqHz_[i] += (targetFreq_[i] - freqHz_[i]) * alpha;
+                res_[i] += (targetRes_[i] - res_[i]) * alpha;
+            }
+        }
+
+        // Svf::SetFreq and SetRes: the cutoff is held below a third of the
+        // rate, and damping is capped where the double-sampled loop would
+        // otherwise go unstable.
+        const float maxFreq = sampleRate_ / 3.0f;
+        for (int i = 0; i < lanes; ++i)
+        {
+            const float fc = std::clamp(freqHz_[i], 1.0e-6f, maxFreq);
+            const float f = 2.0f * std::sin(kPi * std::min(0.25f, fc / (sampleRate_ * 2.0f)));
+            freq_[i] = f;
+            damp_[i] = std::min(2.0f * (1.0f - std::pow(res_[i], 0.25f)), std::min(2.0f, 2.0f / f - f * 0.5f));
+            laneDrive_[i] = drive_ * res_[i];
+        }
+    }
+
+    // One sample per channel in, each channel's gain-weighted sum of its
+    // bands out.
+    void Process(const float *in, float *out)
+    {
+        if (channels_ == 2)
+            Run<2>(in, out);
+        else
+            Run<1>(in, out);
+    }
+
+    // Mono in and out; a stereo bank feeds both channels and returns the left.
+    float Process(float in)
+    {
+        const float input[kMaxChannels] = {in, in};
+        float out[kMaxChannels] = {};
+        Process(input, out);
+        return out[0];
+    }
+
+    void Process(float inL, float inR, float &outL, float &outR)
+    {
+        const float in[kMaxChannels] = {inL, inR};
+        float out[kMaxChannels] = {};
+        Process(in, out);
+        outL = out[0];
+        outR = out[1];
+    }
+
+    int Formants() const
+    {
+        return formants_;
+    }
+
+    int Channels() const
+    {
+        return channels_;
+    }
+
+private:
+    static constexpr float kPi = 3.14159265358979323846f;
+
+    // Lanes are formant-major with the channels side by side, so each
+    // formant's left and right filters run as a pair.
+    int Lane(int channel, int formant) const
+    {
+        return std::clamp(formant, 0, formants_ - 1) * channels_ + std::clamp(channel, 0, channels_ - 1);
+    }
+
+    // One double-sampled step of lane i; returns its band output.
+    float Step(int i, float x)
+    {
+        const float f = freq_[i];
+        const float d = damp_[i];
+        const float drive = laneDrive_[i];
+        float l = low_[i];
+        float b = band_[i];
+
+        float notch = x - d * b;
+        l = l + f * b;
+        float high = notch - l;
+        b = f * high + b - drive * b * b * b;
+        float out = 0.5f * b;
+
+        notch = x - d * b;
+        l = l + f * b;
+        high = notch - l;
+        b = f * high + b - drive * b * b * b;
+        out += 0.5f * b;
+
+        low_[i] = l;
+        band_[i] = b;
+        return out;
+    }
+
+    // Lanes go two at a time, a formant's left and right or two neighbouring
+    // formants of a mono bank, so there are always two chains in flight.
+    template <int Channels>
+    void Run(const float *in, float *out)
+    {
+        float x[Channels];
+        float sum[Channels];
+        for (int ch = 0; ch < Channels; ++ch)
+        {
+            x[ch] = in[ch];
+            sum[ch] = 0.0f;
+        }
+
+        const int lanes = formants_ * Channels;
+        int i = 0;
+        for (; i + 1 < lanes; i += 2)
+        {
+            const float a = Step(i, x[i % Channels]);
+            const float b = Step(i + 1, x[(i + 1) % Channels]);
+            sum[i % Channels] += gain_[i] * a;
+            sum[(i + 1) % Channels] += gain_[i + 1] * b;
+        }
+        if (i < lanes)
+            sum[i % Channels] += gain_[i] * Step(i, x[i % Channels]);
+
+        for (int ch = 0; ch < Channels; ++ch)
+            out[ch] = sum[ch];
+    }
+
+    float sampleRate_ = 48000.0f;
+    int formants_ = 1;
+    int channels_ = 1;
+    float drive_ = 0.5f;
+    float smoothing_ = 0.0f;
+    bool primed_ = false;
+
+    // Per lane: targets, the smoothed values, coefficients, then state.
+    float targetFreq_[kMaxLanes]{};
+    float targetRes_[kMaxLanes]{};
+    float gain_[kMaxLanes]{};
+    float freqHz_[kMaxLanes]{};
+    float res_[kMaxLanes]{};
+    float freq_[kMaxLanes]{};
+    float damp_[kMaxLanes]{};
+    float laneDrive_[kMaxLanes]{};
+    float low_[kMaxLanes]{};
+    float band_[kMaxLanes]{};
+};
@@ -1,14 +1,17 @@
 /**
  * Formant Synthesis Class
  *
- * Implements cascaded bandpass filter formant synthesis
- * for vowel-like vocal timbres, based on Chatterbox
+ * Implements parallel bandpass filter formant synthesis
+ * for vowel-like vocal timbres, based on Chatterbox.
+ * The four formants run side by side in a FormantBank;
+ * call Prepare() (or use ProcessBlock) once per block
+ * so formant changes take effect.
  */
 
 #pragma once
 
 #include <math.h>
-#include "Filters/svf.h"
+#include "formant_bank.h"
 #include "Synthesis/oscillator.h"
 #include "Noise/whitenoise.h"
 
@@ -42,11 +45,9 @@ public:
     void Init(float sampleRate) {
         sampleRate_ = sampleRate;
 
-        // Initialize all 4 formant filters
-        formant1_.Init(sampleRate);
-        formant2_.Init(sampleRate);
-        formant3_.Init(sampleRate);
-        formant4_.Init(sampleRate);
+        // Initialize the 4 formant filters, gliding between vowels
+        formants_.Init(sampleRate, NUM_FORMANTS, 1);
+        formants_.SetSmoothing(FORMANT_GLIDE_SECONDS);
 
         // Initialize excitation sources
         larynx_.Init(sampleRate);
@@ -57,6 +58,20 @@ public:
 
         // Set initial formant frequencies and bandwidths
         UpdateFormants();
+        formants_.Prepare(1);
+    }
+
+    // Glides the formants towards their targets and recomputes the filter
+    // coefficients; once per block of blockSize samples.
+    void Prepare(size_t blockSize) {
+        formants_.Prepare(blockSize);
+    }
+
+    void ProcessBlock(const float* in, float* out, size_t size) {
+        Prepare(size);
+        for (size_t i = 0; i < size; i++) {
+            out[i] = Process(in != nullptr ? in[i] : 0.0f);
+        }
     }
 
     float Process(float audioInput = 0.0f) {
@@ -71,21 +86,9 @@ public:
             excitation = 0.0f;
         }
 
-        // Cascade through 4 formants (bandpass filters)
-        formant1_.Process(excitation);
-        float sig = formant1_.Band();
-
-        formant2_.Process(sig);
-        sig = formant2_.Band();
-
-        formant3_.Process(sig);
-        sig = formant3_.Band();
-
-        formant4_.Process(sig);
-        sig = formant4_.Band();
-
-        // Apply makeup gain for cascade losses
-        return sig * CASCADE_MAKEUP_GAIN;
+        // 4 formants (bandpass filters) in parallel, summed with a
+        // falling spectral tilt
+        return formants_.Process(excitation);
     }
 
     // Formant frequency setters
@@ -168,8 +171,8 @@ public:
     bool IsUsingExternalInput() const { return useExternalInput_; }
 
 private:
-    // Formant filters (4 cascaded bandpass filters)
-    Svf formant1_, formant2_, formant3_, formant4_;
+    // Formant filters (4 parallel bandpass filters)
+    FormantBank formants_;
 
     // Excitation sources
     Oscillator larynx_;    // Sawtooth oscillator for pitched excitation
@@ -185,25 +188,22 @@ private:
     bool useExternalInput_;
 
     // Constants
-    static constexpr float CASCADE_MAKEUP_GAIN = 3.0f;
+    static constexpr int NUM_FORMANTS = 4;
+    static constexpr float FORMANT_GLIDE_SECONDS = 0.01f;
+    // Per-formant level, -4 dB per formant: the tilt a cascade gets from
+    // each band rolling off the ones above it
+    static constexpr float FORMANT_GAIN[NUM_FORMANTS] = {1.0f, 0.63f, 0.4f, 0.25f};
     static constexpr float BW1 = 80.0f;   // Bandwidth for F1
     static constexpr float BW2 = 120.0f;  // Bandwidth for F2
     static constexpr float BW3 = 150.0f;  // Bandwidth for F3
     static constexpr float BW4 = 200.0f;  // Bandwidth for F4
 
     void UpdateFormants() {
-        // Update filter frequencies and resonances
-        formant1_.SetFreq(f1_freq_);
-        formant1_.SetRes(CalculateRes(f1_freq_, BW1));
-
-        formant2_.SetFreq(f2_freq_);
-        formant2_.SetRes(CalculateRes(f2_freq_, BW2));
-
-        formant3_.SetFreq(f3_freq_);
-        formant3_.SetRes(CalculateRes(f3_freq_, BW3));
-
-        formant4_.SetFreq(f4_freq_);
-        formant4_.SetRes(CalculateRes(f4_freq_, BW4));
+        // Update filter frequency and resonance targets
+        formants_.SetFormant(0, 0, f1_freq_, CalculateRes(f1_freq_, BW1), FORMANT_GAIN[0]);
+        formants_.SetFormant(0, 1, f2_freq_, CalculateRes(f2_freq_, BW2), FORMANT_GAIN[1]);
+        formants_.SetFormant(0, 2, f3_freq_, CalculateRes(f3_freq_, BW3), FORMANT_GAIN[2]);
+        formants_.SetFormant(0, 3, f4_freq_, CalculateRes(f4_freq_, BW4), FORMANT_GAIN[3]);
     }
 
     /**
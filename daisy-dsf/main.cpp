@@ -17,6 +17,8 @@
  * Audio Outputs:
  * - OUT 1: Main DSF oscillator
  * - OUT 2: Secondary (sub-osc, processed, or independent)
+ *
+ * Poly output mode plays up to kPolyVoices MIDI notes at once.
  */
 
 #include <algorithm>
@@ -25,9 +27,13 @@
 #include "daisy_seed.h"
 #include "daisysp.h"
 #include "kxmx_bluemchen.h"
+#include "util/CpuLoadMeter.h"
 #include "util/PersistentStorage.h"
+#include "control_scheduler.h"
 #include "disyn_algorithm_info.h"
+#include "disyn_midi_queue.h"
 #include "disyn_oscillator.h"
+#include "disyn_voice_engine.h"
 
 using namespace daisy;
 using namespace daisysp;
@@ -35,6 +41,9 @@ using namespace kxmx;
 
 Bluemchen hw;
 disyn::DisynOscillator osc1, osc2;
+disyn::PolyVoiceEngine poly;
+CpuLoadMeter cpuLoad;
+ControlScheduler controlScheduler;
 OnePole freqSmooth;
 OnePole param1Smooth;
 OnePole param2Smooth;
@@ -43,6 +52,8 @@ OnePole param3Smooth;
 float param2 = 0.5f;
 float param3 = 0.5f;
 float currentFreq = 440.0f;
+float controlFreq = 440.0f;    // Knob/CV pitch, smoothed per control tick
+float midiPitchScale = 1.0f;   // CV 1 and calibration applied to MIDI notes
 float currentParam1 = 0.5f;
 float currentParam2 = 0.5f;
 float currentParam3 = 0.5f;
@@ -73,21 +84,42 @@ enum OutputMode
 {
     OUTPUT_MONO,
     OUTPUT_STEREO,
-    OUTPUT_DETUNE
+    OUTPUT_DETUNE,
+    OUTPUT_POLY
 };
 
 OutputMode outputMode = OUTPUT_STEREO;
-const int NUM_OUTPUT_MODES = 3;
+const int NUM_OUTPUT_MODES = 4;
 const char *outputModeNames[] = {
     "Mono",
     "Stereo",
-    "Detune"};
+    "Detune",
+    "Poly"};
+
+// Poly mode: MIDI notes held at once, and the level of each voice in the sum.
+constexpr size_t kPolyVoices = 8;
+constexpr float kPolyMixGain = 0.35f;
+// Knob, CV and menu params glide through a one-pole at this cutoff, run
+// once per control tick.
+constexpr float kControlSmoothingHz = 10.0f;
+// Shape cache points computed per main-loop pass; a table fills in 9 passes.
+constexpr size_t kShapeCacheBuildEntries = 256;
+// Oversampling: an algorithm steps up a tier while the callback's peak load
+// stays under the raise level (a tier costs 2-2.5x the oscillator's 1x
+// render), and drops one above the drop level, remembering it as its ceiling.
+constexpr float kOversamplingRaiseLoad = 0.35f;
+constexpr float kOversamplingDropLoad = 0.75f;
+constexpr uint32_t kOversamplingCheckMs = 500;
 
 // Algorithm selection
 int currentAlgorithm = 0;
 const int NUM_ALGORITHMS = static_cast<int>(disyn::kAlgorithmCount);
 const int CALIBRATION_ALGORITHM = NUM_ALGORITHMS - 1;
 
+// Per algorithm: the oversampling in use, and the highest that has fit.
+int oversamplingTier[NUM_ALGORITHMS];
+int oversamplingCeiling[NUM_ALGORITHMS];
+
 enum EncoderPage
 {
     PAGE_ALGO,
@@ -115,7 +147,15 @@ const char *inputModeNames[] = {
 bool encoderLongPress = false;
 uint32_t encoderPressTime = 0;
 
-// MIDI state tracking
+// MIDI: parsed and stamped in the UART receive interrupt, queued, and
+// applied by the audio callback one block later at the sample it arrived.
+MidiUartTransport midiTransport;
+MidiParser midiParser;
+disyn::SampleClock sampleClock;
+disyn::MidiNoteQueue midiQueue;
+uint32_t renderedSamples = 0; // Sample clock, advanced by the audio callback
+
+// MIDI state tracking, owned by the audio callback
 struct MidiNoteState
 {
     uint8_t note;     // MIDI note number (0-127)
@@ -132,42 +172,169 @@ float MidiNoteToFrequency(uint8_t note)
     return 440.0f * powf(2.0f, (note - 69) / 12.0f);
 }
 
-// MIDI message handler
-void HandleMidiMessage(MidiEvent m)
+// UART receive interrupt: stamp and queue channel 1 notes.
+void MidiRxCallback(uint8_t *data, size_t size, void *context)
 {
-    switch (m.type)
-    {
-    case NoteOn:
+    (void)context;
+    const uint32_t now = sampleClock.Now(System::GetTick());
+    for (size_t i = 0; i < size; i++)
     {
-        NoteOnEvent noteOn = m.AsNoteOn();
-        if (noteOn.channel == 0)
-        { // MIDI Channel 1
-            midiCh1.note = noteOn.note;
-            midiCh1.velocity = noteOn.velocity;
-            midiCh1.active = (noteOn.velocity > 0); // Velocity 0 = note off
-            gain1 = noteOn.velocity / 127.0f;
+        MidiEvent m;
+        if (!midiParser.Parse(data[i], &m) || m.channel != 0)
+            continue; // MIDI Channel 1 only
+        if (m.type == NoteOn)
+        {
+            const NoteOnEvent noteOn = m.AsNoteOn();
+            midiQueue.Push({now, noteOn.note, noteOn.velocity, true});
+        }
+        else if (m.type == NoteOff)
+        {
+            const NoteOffEvent noteOff = m.AsNoteOff();
+            midiQueue.Push({now, noteOff.note, noteOff.velocity, false});
         }
-        break;
     }
-    case NoteOff:
+}
+
+// MIDI note handler, called by the audio callback at the note's sample.
+void HandleMidiNote(const disyn::MidiNoteEvent &event)
+{
+    if (event.noteOn)
+    {
+        midiCh1.note = event.note;
+        midiCh1.velocity = event.velocity;
+        midiCh1.active = (event.velocity > 0); // Velocity 0 = note off
+        gain1 = event.velocity / 127.0f;
+        if (outputMode == OUTPUT_POLY)
+            poly.NoteOn(event.note, event.velocity);
+    }
+    else
+    {
+        midiCh1.active = false;
+        gain1 = 1.0f;
+        if (outputMode == OUTPUT_POLY)
+            poly.NoteOff(event.note);
+    }
+    // A new pitch starts on this sample rather than ramping across the block.
+    osc1.SkipRamp();
+    osc2.SkipRamp();
+}
+
+// The held MIDI note's pitch (transposed like Poly voices), else the
+// smoothed knob/CV pitch. Calibration always follows the knobs.
+void UpdateFrequency()
+{
+    if (midiCh1.active && currentAlgorithm != CALIBRATION_ALGORITHM)
+        currentFreq = MidiNoteToFrequency(midiCh1.note) * midiPitchScale;
+    else
+        currentFreq = controlFreq;
+    osc1.SetFrequency(currentFreq);
+    osc2.SetFrequency(currentFreq * 1.005f);
+}
+
+// Largest chunk rendered by one ProcessBlock() call.
+constexpr size_t kRenderBlockSize = 48;
+// REACTOR input peaks below this move the params by less than 1e-4.
+constexpr float kReactorInputThreshold = 2.5e-4f;
+
+// True when the inputs change osc1's settings sample by sample, which needs
+// the per-sample path.
+bool InputsModulateOscillator(AudioHandle::InputBuffer in, size_t size)
+{
+    if (currentAlgorithm == static_cast<int>(disyn::AlgorithmType::TRAJECTORY) || inputMode == INPUT_CROSSMOD)
+        return true;
+    if (inputMode != INPUT_REACTOR)
+        return false;
+
+    float peak = 0.0f;
+    for (size_t i = 0; i < size; i++)
+        peak = std::max(peak, std::max(fabsf(in[0][i]), fabsf(in[1][i])));
+    return peak >= kReactorInputThreshold;
+}
+
+// Block path: the algorithm switch runs once per chunk, and the control
+// maths once per chunk while the settings hold and every few samples while
+// a knob or CV ramps across it.
+void RenderBlocks(AudioHandle::InputBuffer in, AudioHandle::OutputBuffer out, size_t size)
+{
+    static float primary[kRenderBlockSize];
+    static float secondary[kRenderBlockSize];
+    static float detuned[kRenderBlockSize];
+    static float detunedSecondary[kRenderBlockSize];
+
+    osc1.SetParam2(currentParam2);
+    osc1.SetParam3(currentParam3);
+
+    for (size_t start = 0; start < size; start += kRenderBlockSize)
     {
-        NoteOffEvent noteOff = m.AsNoteOff();
-        if (noteOff.channel == 0)
-        { // MIDI Channel 1
-            midiCh1.active = false;
-            gain1 = 1.0f;
+        const size_t count = std::min(kRenderBlockSize, size - start);
+        osc1.ProcessBlock(primary, secondary, count);
+        if (outputMode == OUTPUT_DETUNE)
+            osc2.ProcessBlock(detuned, detunedSecondary, count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            float sig1 = primary[i];
+            float sig2 = secondary[i];
+            if (inputMode == INPUT_EXCITER)
+            {
+                sig1 += in[0][start + i] * 0.4f;
+                sig2 += in[1][start + i] * 0.4f;
+            }
+
+            if (outputMode == OUTPUT_MONO)
+                sig2 = sig1;
+            else if (outputMode == OUTPUT_DETUNE)
+                sig2 = detuned[i];
+
+            out[0][start + i] = sig1 * gain1;
+            out[1][start + i] = sig2 * gain1;
         }
-        break;
     }
-    default:
-        break;
+}
+
+// Poly path: every held MIDI note through the voice engine. Primary sums
+// on OUT 1 and secondary on OUT 2; the inputs only mix in for Exciter.
+void RenderPoly(AudioHandle::InputBuffer in, AudioHandle::OutputBuffer out, size_t size)
+{
+    static float primary[kRenderBlockSize];
+    static float secondary[kRenderBlockSize];
+
+    for (size_t start = 0; start < size; start += kRenderBlockSize)
+    {
+        const size_t count = std::min(kRenderBlockSize, size - start);
+        poly.ProcessBlock(primary, secondary, count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            float sig1 = primary[i] * kPolyMixGain;
+            float sig2 = secondary[i] * kPolyMixGain;
+            if (inputMode == INPUT_EXCITER)
+            {
+                sig1 += in[0][start + i] * 0.4f;
+                sig2 += in[1][start + i] * 0.4f;
+            }
+            out[0][start + i] = sig1;
+            out[1][start + i] = sig2;
+        }
     }
 }
 
-void AudioCallback(AudioHandle::InputBuffer in,
-                   AudioHandle::OutputBuffer out,
-                   size_t size)
+void RenderAudio(AudioHandle::InputBuffer in, AudioHandle::OutputBuffer out, size_t size)
 {
+    UpdateFrequency();
+
+    if (outputMode == OUTPUT_POLY && currentAlgorithm != CALIBRATION_ALGORITHM)
+    {
+        RenderPoly(in, out, size);
+        return;
+    }
+
+    if (currentAlgorithm != CALIBRATION_ALGORITHM && !InputsModulateOscillator(in, size))
+    {
+        RenderBlocks(in, out, size);
+        return;
+    }
+
     for (size_t i = 0; i < size; i++)
     {
         const float in1 = in[0][i];
@@ -246,9 +413,11 @@ void AudioCallback(AudioHandle::InputBuffer in,
     }
 }
 
-void UpdateControls()
+// Audio callback, at the control rate: knobs and CV, and every param's
+// glide towards its target.
+void UpdateAnalogControls()
 {
-    hw.ProcessAllControls();
+    hw.ProcessAnalogControls();
 
     const float pot1 = hw.GetKnobValue(Bluemchen::CTRL_1);
     const float pot2 = hw.GetKnobValue(Bluemchen::CTRL_2);
@@ -267,7 +436,131 @@ void UpdateControls()
         param1 = 0.5f;
         param2 = 0.5f;
         param3 = 0.5f;
+    }
+    else
+    {
+        const float baseFreq = 55.0f * powf(2.0f, pot1 * 7.0f);
+        const float cvMultiplier = powf(2.0f, cv1 * 5.0f * pitchScale);
+        targetFreq = baseFreq * cvMultiplier * powf(2.0f, pitchOffset);
+        param1 = std::clamp(pot2 + cv2 * 0.5f, 0.0f, 1.0f);
+        // MIDI notes, mono or Poly, take their pitch in the audio callback;
+        // CV 1 and calibration transpose them.
+        midiPitchScale = cvMultiplier * powf(2.0f, pitchOffset);
+        poly.SetPitchScale(midiPitchScale);
+    }
+
+    // Applied when the block after this tick starts rendering.
+    controlFreq = freqSmooth.Process(targetFreq);
 
+    currentParam1 = param1Smooth.Process(param1);
+    currentParam2 = param2Smooth.Process(param2);
+    currentParam3 = param3Smooth.Process(param3);
+
+    osc1.SetParam1(currentParam1);
+    osc1.SetParam2(currentParam2);
+    osc1.SetParam3(currentParam3);
+    osc2.SetParam1(currentParam1);
+    osc2.SetParam2(currentParam2);
+    osc2.SetParam3(currentParam3);
+    poly.SetParam1(currentParam1);
+    poly.SetParam2(currentParam2);
+    poly.SetParam3(currentParam3);
+}
+
+void AudioCallback(AudioHandle::InputBuffer in,
+                   AudioHandle::OutputBuffer out,
+                   size_t size)
+{
+    cpuLoad.OnBlockStart();
+    const uint32_t blockStart = renderedSamples;
+    const uint32_t tick = System::GetTick();
+    sampleClock.MarkBlock(blockStart, tick);
+    for (size_t ticks = controlScheduler.BeginBlock(size, tick); ticks > 0; --ticks)
+    {
+        UpdateAnalogControls();
+    }
+
+    // Render up to each due note, apply it, and carry on from its sample.
+    size_t done = 0;
+    disyn::MidiNoteEvent event;
+    size_t offset = 0;
+    while (midiQueue.Next(blockStart, size, event, offset))
+    {
+        if (offset > done)
+        {
+            const float *segmentIn[2] = {in[0] + done, in[1] + done};
+            float *segmentOut[2] = {out[0] + done, out[1] + done};
+            RenderAudio(segmentIn, segmentOut, offset - done);
+            done = offset;
+        }
+        HandleMidiNote(event);
+    }
+    if (done < size)
+    {
+        const float *segmentIn[2] = {in[0] + done, in[1] + done};
+        float *segmentOut[2] = {out[0] + done, out[1] + done};
+        RenderAudio(segmentIn, segmentOut, size - done);
+    }
+
+    renderedSamples = blockStart + static_cast<uint32_t>(size);
+    cpuLoad.OnBlockEnd();
+}
+
+void SetOversampling(int tier)
+{
+    osc1.SetOversampling(tier);
+    osc2.SetOversampling(tier);
+}
+
+// Moves the current algorithm's oversampling a tier at a time from the peak
+// callback load since the last check. Poly voices always run at 1x.
+void UpdateOversampling(uint32_t now)
+{
+    static uint32_t lastCheck = 0;
+    static int checkedAlgorithm = -1;
+    static OutputMode checkedMode = OUTPUT_STEREO;
+    if (now - lastCheck < kOversamplingCheckMs)
+        return;
+    lastCheck = now;
+
+    const float load = cpuLoad.GetMaxCpuLoad();
+    cpuLoad.Reset();
+    // The peak since an algorithm or mode change belongs to the old setup.
+    if (checkedAlgorithm != currentAlgorithm || checkedMode != outputMode)
+    {
+        checkedAlgorithm = currentAlgorithm;
+        checkedMode = outputMode;
+        return;
+    }
+    if (outputMode == OUTPUT_POLY || currentAlgorithm == CALIBRATION_ALGORITHM
+        || !disyn::DisynOscillator::SupportsOversampling(currentAlgorithm))
+        return;
+
+    int &tier = oversamplingTier[currentAlgorithm];
+    int &ceiling = oversamplingCeiling[currentAlgorithm];
+    if (load > kOversamplingDropLoad && tier > 1)
+    {
+        tier /= 2;
+        ceiling = tier;
+    }
+    else if (load < kOversamplingRaiseLoad && tier < ceiling)
+    {
+        tier *= 2;
+    }
+    else
+    {
+        return;
+    }
+    SetOversampling(tier);
+}
+
+// Main loop: encoder, menus, and saving the calibration.
+void UpdateControls()
+{
+    hw.ProcessDigitalControls();
+
+    if (currentAlgorithm == CALIBRATION_ALGORITHM)
+    {
         const uint32_t now = System::GetNow();
         if (fabsf(pitchScale - savedCalib.scale) > 0.0005f || fabsf(pitchOffset - savedCalib.offset) > 0.005f)
         {
@@ -284,26 +577,6 @@ void UpdateControls()
             calibDirty = false;
         }
     }
-    else
-    {
-        const float baseFreq = 55.0f * powf(2.0f, pot1 * 7.0f);
-        const float cvMultiplier = powf(2.0f, cv1 * 5.0f * pitchScale);
-        const float midiFreq = midiCh1.active ? MidiNoteToFrequency(midiCh1.note) : baseFreq;
-        targetFreq = midiFreq * cvMultiplier * powf(2.0f, pitchOffset);
-        param1 = std::clamp(pot2 + cv2 * 0.5f, 0.0f, 1.0f);
-    }
-
-    const float smoothedFreq = freqSmooth.Process(targetFreq);
-    currentFreq = smoothedFreq;
-
-    osc1.SetFrequency(currentFreq);
-    osc2.SetFrequency(currentFreq * 1.005f);
-
-    param1 = param1Smooth.Process(param1);
-    currentParam1 = param1;
-
-    osc1.SetParam1(currentParam1);
-    osc2.SetParam1(currentParam1);
 
     int encInc = hw.encoder.Increment();
     if (encInc != 0)
@@ -322,6 +595,9 @@ void UpdateControls()
                 osc2.SetAlgorithm(currentAlgorithm);
                 osc1.Reset();
                 osc2.Reset();
+                SetOversampling(oversamplingTier[currentAlgorithm]);
+                // Taken up by the voices at the callback's next render.
+                poly.SetAlgorithm(currentAlgorithm);
             }
             break;
         case PAGE_PARAM2:
@@ -333,8 +609,15 @@ void UpdateControls()
                 param3 = std::clamp(param3 + encInc * 0.01f, 0.0f, 1.0f);
             break;
         case PAGE_OUTPUT:
+        {
+            const OutputMode previous = outputMode;
             outputMode = static_cast<OutputMode>((outputMode + encInc + NUM_OUTPUT_MODES) % NUM_OUTPUT_MODES);
+            // The audio callback stops rendering voices once the mode has
+            // changed, so they can be silenced from here.
+            if (previous == OUTPUT_POLY && outputMode != OUTPUT_POLY)
+                poly.Reset();
             break;
+        }
         case PAGE_INPUT:
             inputMode = static_cast<InputMode>((inputMode + encInc + NUM_INPUT_MODES) % NUM_INPUT_MODES);
             break;
@@ -354,14 +637,6 @@ void UpdateControls()
         lastAlgorithm = currentAlgorithm;
     }
 
-    currentParam2 = param2Smooth.Process(param2);
-    currentParam3 = param3Smooth.Process(param3);
-
-    osc1.SetParam2(currentParam2);
-    osc1.SetParam3(currentParam3);
-    osc2.SetParam2(currentParam2);
-    osc2.SetParam3(currentParam3);
-
     if (hw.encoder.RisingEdge())
     {
         encoderPressTime = System::GetNow();
@@ -389,7 +664,10 @@ void UpdateDisplay()
     const auto &info = disyn::GetAlgorithmInfo(currentAlgorithm);
     char buf[32];
 
-    const char modeChar = (outputMode == OUTPUT_MONO) ? 'M' : (outputMode == OUTPUT_STEREO) ? 'S' : 'D';
+    const char modeChar = (outputMode == OUTPUT_MONO)     ? 'M'
+                          : (outputMode == OUTPUT_STEREO) ? 'S'
+                          : (outputMode == OUTPUT_DETUNE) ? 'D'
+                                                          : 'P';
     char modeBuf[2] = {modeChar, '\0'};
     const char *pageLabel = "ALG";
     switch (encoderPage)
@@ -425,7 +703,13 @@ void UpdateDisplay()
     hw.display.SetCursor(110, 0);
     hw.display.WriteString(modeBuf, Font_6x8, true);
 
-    snprintf(buf, sizeof(buf), "F:%.0fHz", currentFreq);
+    if (outputMode == OUTPUT_POLY && currentAlgorithm != CALIBRATION_ALGORITHM)
+        snprintf(buf, sizeof(buf), "Voices:%u/%u", static_cast<unsigned>(poly.ActiveVoices()),
+                 static_cast<unsigned>(kPolyVoices));
+    else if (osc1.GetOversampling() > 1 && disyn::DisynOscillator::SupportsOversampling(currentAlgorithm))
+        snprintf(buf, sizeof(buf), "F:%.0fHz %dx", currentFreq, osc1.GetOversampling());
+    else
+        snprintf(buf, sizeof(buf), "F:%.0fHz", currentFreq);
     hw.display.SetCursor(0, 12);
     hw.display.WriteString(buf, Font_6x8, true);
 
@@ -506,45 +790,59 @@ int main(void)
 
     osc1.Init(sampleRate);
     osc1.SetAlgorithm(currentAlgorithm);
+    osc1.SetShapeCache(true);
 
     osc2.Init(sampleRate);
     osc2.SetAlgorithm(currentAlgorithm);
-
-    // Initialize smoothing filters
+    osc2.SetShapeCache(true);
+
+    poly.Init(sampleRate);
+    poly.SetVoiceCount(kPolyVoices);
+    poly.SetAlgorithm(currentAlgorithm);
+
+    std::fill(oversamplingTier, oversamplingTier + NUM_ALGORITHMS, 1);
+    std::fill(oversamplingCeiling, oversamplingCeiling + NUM_ALGORITHMS, disyn::DisynOscillator::kMaxOversampling);
+    cpuLoad.Init(sampleRate, hw.AudioBlockSize());
+    sampleClock.Init(sampleRate, System::GetTickFreq(), hw.AudioBlockSize());
+    midiQueue.Init(static_cast<uint32_t>(hw.AudioBlockSize()));
+    controlScheduler.Init(sampleRate, System::GetTickFreq());
+
+    // Initialize smoothing filters. OnePole takes its cutoff normalised to
+    // the rate it runs at, here the control rate.
+    const float smoothingFreq = kControlSmoothingHz / controlScheduler.ControlRate();
     freqSmooth.Init();
-    freqSmooth.SetFrequency(10.0f); // 10Hz lowpass
+    freqSmooth.SetFrequency(smoothingFreq);
 
     param1Smooth.Init();
-    param1Smooth.SetFrequency(10.0f);
+    param1Smooth.SetFrequency(smoothingFreq);
 
     param2Smooth.Init();
-    param2Smooth.SetFrequency(10.0f);
+    param2Smooth.SetFrequency(smoothingFreq);
 
     param3Smooth.Init();
-    param3Smooth.SetFrequency(10.0f);
+    param3Smooth.SetFrequency(smoothingFreq);
 
-    // Start audio
+    // Start audio, then MIDI: this transport replaces hw.midi on the same
+    // UART so that notes are stamped in its receive interrupt.
     hw.StartAudio(AudioCallback);
+    MidiUartTransport::Config midiConfig;
+    midiTransport.Init(midiConfig);
+    midiTransport.StartRx(MidiRxCallback, nullptr);
 
-    // Main loop
-    uint32_t lastDisplayUpdate = 0;
+    // Main loop: the UI, below the audio callback that runs the controls.
     while (1)
     {
         UpdateControls();
 
-        // Process MIDI events
-        hw.midi.Listen();
-        while (hw.midi.HasEvents())
-        {
-            HandleMidiMessage(hw.midi.PopEvent());
-        }
+        // Refill the C3/N1 shape tables after a param change; the audio
+        // callback renders directly until a table is complete.
+        disyn::DisynOscillator::BuildShapeCaches(kShapeCacheBuildEntries);
+
+        UpdateOversampling(System::GetNow());
 
-        // Update display at ~30Hz
-        uint32_t now = System::GetNow();
-        if (now - lastDisplayUpdate > 33)
+        if (controlScheduler.UiDue(System::GetTick()))
         {
             UpdateDisplay();
-            lastDisplayUpdate = now;
         }
     }
 }
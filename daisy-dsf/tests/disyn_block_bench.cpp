@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+#include "disyn_algorithm_info.h"
+#include "disyn_oscillator.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBlockSize = 48;
+constexpr size_t kBenchSamples = 48000;
+constexpr size_t kCheckSamples = 4800;
+constexpr int kPasses = 5;
+constexpr int kAlgorithms = 19; // Everything but the calibration tone
+
+using Clock = std::chrono::steady_clock;
+
+void Configure(disyn::DisynOscillator &osc, int algorithm)
+{
+    osc.Init(kSampleRate);
+    osc.SetAlgorithm(algorithm);
+    osc.SetFrequency(220.0f);
+    osc.SetParam1(0.4f);
+    osc.SetParam2(0.6f);
+    osc.SetParam3(0.3f);
+}
+
+// Params move every block, as they do from the knobs and CVs.
+void MoveParams(disyn::DisynOscillator &osc, size_t block)
+{
+    const float t = static_cast<float>(block % 200) / 200.0f;
+    osc.SetFrequency(110.0f + 330.0f * t);
+    osc.SetParam1(0.2f + 0.6f * t);
+}
+
+double NsPerSample(int algorithm, bool block)
+{
+    static float primary[kBenchSamples];
+    static float secondary[kBenchSamples];
+    static disyn::DisynOscillator osc;
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        Configure(osc, algorithm);
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kBenchSamples; n += kBlockSize)
+        {
+            MoveParams(osc, n / kBlockSize);
+            if (block)
+            {
+                osc.ProcessBlock(primary + n, secondary + n, kBlockSize);
+            }
+            else
+            {
+                for (size_t j = 0; j < kBlockSize; ++j)
+                {
+                    const disyn::AlgorithmOutput out = osc.Process();
+                    primary[n + j] = out.primary;
+                    secondary[n + j] = out.secondary;
+                }
+            }
+        }
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        if (!std::isfinite(primary[kBenchSamples - 1]) || !std::isfinite(secondary[kBenchSamples - 1]))
+            return -1.0;
+    }
+    return best / kBenchSamples;
+}
+
+// With fixed settings the block path must render exactly what Process does.
+float BlockMismatch(int algorithm)
+{
+    static disyn::DisynOscillator a;
+    static disyn::DisynOscillator b;
+    Configure(a, algorithm);
+    Configure(b, algorithm);
+    float primary[kBlockSize];
+    float secondary[kBlockSize];
+    float maxErr = 0.0f;
+    for (size_t n = 0; n < kCheckSamples; n += kBlockSize)
+    {
+        a.ProcessBlock(primary, secondary, kBlockSize);
+        for (size_t j = 0; j < kBlockSize; ++j)
+        {
+            const disyn::AlgorithmOutput out = b.Process();
+            maxErr = std::max(maxErr, std::fabs(out.primary - primary[j]));
+            maxErr = std::max(maxErr, std::fabs(out.secondary - secondary[j]));
+        }
+    }
+    return maxErr;
+}
+} // namespace
+
+int main()
+{
+    std::printf("DisynOscillator ns/sample, per-sample Process vs ProcessBlock (%zu)\n", kBlockSize);
+    std::printf("%10s%10s%10s%10s%10s\n", "algorithm", "process", "block", "speedup", "blk err");
+
+    bool ok = true;
+    for (int algorithm = 0; algorithm < kAlgorithms; ++algorithm)
+    {
+        const double before = NsPerSample(algorithm, false);
+        const double after = NsPerSample(algorithm, true);
+        const float err = BlockMismatch(algorithm);
+        const bool pass = before >= 0.0 && after >= 0.0 && err == 0.0f;
+        ok = ok && pass;
+        std::printf("%10s%10.2f%10.2f%9.2fx%10.1e%s\n", disyn::GetAlgorithmInfo(algorithm).name, before, after,
+                    before / after, static_cast<double>(err), pass ? "" : "  FAIL");
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "Block bench failed (block/per-sample mismatch or non-finite output).\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#include "formant_bank.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBlockSize = 48;
+constexpr size_t kSamples = 48000;
+constexpr int kPasses = 5;
+constexpr float kTolerance = 1.0e-5f;
+constexpr float kPi = 3.14159265358979323846f;
+
+using Clock = std::chrono::steady_clock;
+
+// daisysp::Svf's band output, retuned with SetRes and SetFreq every block
+// the way FormantSynth drove its four Svfs.
+struct ReferenceSvf
+{
+    float sr = kSampleRate;
+    float freq = 0.25f;
+    float damp = 0.0f;
+    float res = 0.5f;
+    float drive = 0.5f;
+    float low = 0.0f;
+    float band = 0.0f;
+    float outBand = 0.0f;
+
+    void SetRes(float r)
+    {
+        res = std::clamp(r, 0.0f, 1.0f);
+        damp = std::min(2.0f * (1.0f - powf(res, 0.25f)), std::min(2.0f, 2.0f / freq - freq * 0.5f));
+        drive = 0.5f * res;
+    }
+
+    void SetFreq(float f)
+    {
+        const float fc = std::clamp(f, 1.0e-6f, sr / 3.0f);
+        freq = 2.0f * sinf(kPi * std::min(0.25f, fc / (sr * 2.0f)));
+        damp = std::min(2.0f * (1.0f - powf(res, 0.25f)), std::min(2.0f, 2.0f / freq - freq * 0.5f));
+    }
+
+    void Process(float in)
+    {
+        float notch = in - damp * band;
+        low = low + freq * band;
+        float high = notch - low;
+        band = freq * high + band - drive * band * band * band;
+        outBand = 0.5f * band;
+        notch = in - damp * band;
+        low = low + freq * band;
+        high = notch - low;
+        band = freq * high + band - drive * band * band * band;
+        outBand += 0.5f * band;
+    }
+};
+
+// Formant k of channel ch: spread over the vowel range, moving each block,
+// with FormantSynth's Q-derived resonance.
+struct Formant
+{
+    float freq;
+    float res;
+    float gain;
+};
+
+Formant Target(int ch, int k, size_t block)
+{
+    const float sweep = 1.0f + 0.2f * std::sin(0.01f * static_cast<float>(block) + static_cast<float>(ch));
+    const float freq = (300.0f + 550.0f * static_cast<float>(k)) * sweep;
+    const float q = freq / (80.0f + 20.0f * static_cast<float>(k));
+    return {freq, std::min(1.0f - 1.0f / std::max(q, 1.0f), 0.9f), 1.0f / static_cast<float>(k + 1)};
+}
+
+float s_in[FormantBank::kMaxChannels][kSamples];
+float s_ref[FormantBank::kMaxChannels][kSamples];
+float s_out[FormantBank::kMaxChannels][kSamples];
+
+double RenderReference(int formants, int channels)
+{
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        ReferenceSvf filters[FormantBank::kMaxChannels][FormantBank::kMaxFormants];
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kSamples; n += kBlockSize)
+        {
+            float gains[FormantBank::kMaxChannels][FormantBank::kMaxFormants];
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                for (int k = 0; k < formants; ++k)
+                {
+                    const Formant t = Target(ch, k, n / kBlockSize);
+                    filters[ch][k].SetRes(t.res);
+                    filters[ch][k].SetFreq(t.freq);
+                    gains[ch][k] = t.gain;
+                }
+            }
+            for (size_t j = n; j < n + kBlockSize; ++j)
+            {
+                for (int ch = 0; ch < channels; ++ch)
+                {
+                    float sum = 0.0f;
+                    for (int k = 0; k < formants; ++k)
+                    {
+                        filters[ch][k].Process(s_in[ch][j]);
+                        sum += gains[ch][k] * filters[ch][k].outBand;
+                    }
+                    s_ref[ch][j] = sum;
+                }
+            }
+        }
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    return best / kSamples;
+}
+
+double RenderBank(int formants, int channels)
+{
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        static FormantBank bank;
+        bank.Init(kSampleRate, formants, channels);
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kSamples; n += kBlockSize)
+        {
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                for (int k = 0; k < formants; ++k)
+                {
+                    const Formant t = Target(ch, k, n / kBlockSize);
+                    bank.SetFormant(ch, k, t.freq, t.res, t.gain);
+                }
+            }
+            bank.Prepare(kBlockSize);
+            for (size_t j = n; j < n + kBlockSize; ++j)
+            {
+                const float in[FormantBank::kMaxChannels] = {s_in[0][j], s_in[1][j]};
+                float out[FormantBank::kMaxChannels] = {};
+                bank.Process(in, out);
+                for (int ch = 0; ch < channels; ++ch)
+                    s_out[ch][j] = out[ch];
+            }
+        }
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    return best / kSamples;
+}
+} // namespace
+
+int main()
+{
+    srand(1);
+    for (size_t n = 0; n < kSamples; ++n)
+    {
+        // Saw-like pulse plus breath, the excitation FormantSynth mixes.
+        const float phase = std::fmod(110.0f * static_cast<float>(n) / kSampleRate, 1.0f);
+        const float noise = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 0.3f;
+        s_in[0][n] = (2.0f * phase - 1.0f) * 0.7f + noise;
+        s_in[1][n] = (1.0f - 2.0f * phase) * 0.7f - noise;
+    }
+
+    std::printf("Formant bank vs one Svf per formant, ns/sample, block %zu, best of %d passes\n", kBlockSize,
+                kPasses);
+    std::printf("%9s%10s%10s%10s%10s%12s\n", "formants", "channels", "Svfs", "bank", "speedup", "max error");
+
+    bool ok = true;
+    for (int channels = 1; channels <= FormantBank::kMaxChannels; ++channels)
+    {
+        for (int formants = 1; formants <= FormantBank::kMaxFormants; ++formants)
+        {
+            const double refNs = RenderReference(formants, channels);
+            const double bankNs = RenderBank(formants, channels);
+
+            float maxErr = 0.0f;
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                for (size_t n = 0; n < kSamples; ++n)
+                    maxErr = std::max(maxErr, std::fabs(s_out[ch][n] - s_ref[ch][n]));
+            }
+            const bool pass = maxErr <= kTolerance;
+            ok = ok && pass;
+            std::printf("%9d%10d%10.2f%10.2f%9.2fx%12.2e%s\n", formants, channels, refNs, bankNs,
+                        refNs / std::max(bankNs, 1.0e-9), maxErr, pass ? "" : "  FAIL");
+        }
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "Formant bank bench failed (output differs from the Svf reference by more than %g).\n",
+                     static_cast<double>(kTolerance));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "disyn_midi_queue.h"
+
+namespace
+{
+constexpr double kSampleRate = 48000.0;
+constexpr uint32_t kBlockSize = 48;
+constexpr double kTickFrequency = 200.0e6;
+constexpr double kSeconds = 20.0;
+
+// The main loop before sample-accurate MIDI: a control pass, then every
+// 33 ms an OLED redraw that holds the loop for the I2C transfer. Notes were
+// read at the next poll and heard from the next block.
+constexpr double kControlPassUs = 40.0;
+constexpr double kDisplayPeriodUs = 33000.0;
+constexpr double kDisplayRedrawUs = 12000.0;
+
+// One DIN MIDI byte takes 320 us, a note message three bytes.
+constexpr double kNoteWireUs = 960.0;
+
+using Ticks = uint64_t;
+
+struct Scenario
+{
+    const char *name;
+    double callbackJitterUs; // Lateness of the audio interrupt, 0 to this
+    double maxJitterSamples; // Allowed spread of the scheduled latency
+};
+
+const Scenario kScenarios[] = {
+    {"steady", 2.0, 2.0},
+    {"late irq", 100.0, 7.0},
+};
+
+struct Stats
+{
+    double minLatency = 1.0e30;
+    double maxLatency = -1.0e30;
+    double sumLatency = 0.0;
+    size_t count = 0;
+
+    void Add(double samples)
+    {
+        minLatency = std::min(minLatency, samples);
+        maxLatency = std::max(maxLatency, samples);
+        sumLatency += samples;
+        ++count;
+    }
+
+    double Jitter() const { return maxLatency - minLatency; }
+    double Mean() const { return count > 0 ? sumLatency / static_cast<double>(count) : 0.0; }
+};
+
+// Deterministic, so a failure reproduces.
+struct Random
+{
+    uint32_t state = 12345u;
+
+    double Next()
+    {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<double>(state >> 8) / static_cast<double>(1u << 24);
+    }
+};
+
+Ticks UsToTicks(double us)
+{
+    return static_cast<Ticks>(us * kTickFrequency / 1.0e6);
+}
+
+double TicksToSamples(Ticks ticks)
+{
+    return static_cast<double>(ticks) * kSampleRate / kTickFrequency;
+}
+
+// Scripted note-on arrivals: a swung 16th-note line, three-note chords sent
+// back to back on the wire, and a fast trill, each starting off the block
+// grid.
+std::vector<Ticks> ScriptArrivals()
+{
+    std::vector<Ticks> arrivals;
+    const double endUs = kSeconds * 1.0e6;
+    for (double us = 1234.5; us < endUs; us += 250000.0)
+    {
+        arrivals.push_back(UsToTicks(us));
+        arrivals.push_back(UsToTicks(us + 125000.0 * 1.16));
+    }
+    for (double us = 60321.7; us < endUs; us += 1000000.0)
+    {
+        for (int voice = 0; voice < 3; ++voice)
+            arrivals.push_back(UsToTicks(us + voice * kNoteWireUs));
+    }
+    for (double us = 3.0e6 + 777.0; us < 4.0e6; us += 11111.0)
+        arrivals.push_back(UsToTicks(us));
+    std::sort(arrivals.begin(), arrivals.end());
+    return arrivals;
+}
+
+// Stamp in the receive interrupt, queue, apply in the callback.
+bool RunScheduled(const Scenario &scenario, const std::vector<Ticks> &arrivals, Stats &stats)
+{
+    disyn::SampleClock clock;
+    disyn::MidiNoteQueue queue;
+    clock.Init(static_cast<float>(kSampleRate), static_cast<uint32_t>(kTickFrequency), kBlockSize);
+    queue.Init(kBlockSize);
+
+    Random random;
+    size_t next = 0;
+    size_t applied = 0;
+    bool inOrder = true;
+    const uint32_t blocks = static_cast<uint32_t>(kSeconds * kSampleRate / kBlockSize);
+    for (uint32_t block = 0; block < blocks; ++block)
+    {
+        const uint32_t blockStart = block * kBlockSize;
+        const Ticks nominal = static_cast<Ticks>(blockStart * kTickFrequency / kSampleRate);
+        const Ticks callbackTick = nominal + UsToTicks(random.Next() * scenario.callbackJitterUs);
+
+        // Notes that arrive before this callback runs are stamped against
+        // the previous mark.
+        while (next < arrivals.size() && arrivals[next] < callbackTick)
+        {
+            const uint32_t now = clock.Now(static_cast<uint32_t>(arrivals[next]));
+            queue.Push({now, static_cast<uint8_t>(next & 0x7f), 100, true});
+            ++next;
+        }
+
+        clock.MarkBlock(blockStart, static_cast<uint32_t>(callbackTick));
+        disyn::MidiNoteEvent event;
+        size_t offset = 0;
+        while (queue.Next(blockStart, kBlockSize, event, offset))
+        {
+            inOrder = inOrder && event.note == (applied & 0x7f);
+            stats.Add(static_cast<double>(blockStart + offset) - TicksToSamples(arrivals[applied]));
+            ++applied;
+        }
+    }
+    return inOrder && applied == next && queue.Dropped() == 0;
+}
+
+// The old main loop: notes are seen at the first poll after they arrive and
+// take effect from the next block.
+void RunMainLoop(const std::vector<Ticks> &arrivals, Stats &stats)
+{
+    double loopUs = 0.0;
+    double lastDisplayUs = 0.0;
+    size_t next = 0;
+    while (next < arrivals.size())
+    {
+        loopUs += kControlPassUs;
+        const Ticks poll = UsToTicks(loopUs);
+        while (next < arrivals.size() && arrivals[next] <= poll)
+        {
+            const double heard = std::ceil(TicksToSamples(poll) / kBlockSize) * kBlockSize;
+            stats.Add(heard - TicksToSamples(arrivals[next]));
+            ++next;
+        }
+        if (loopUs - lastDisplayUs > kDisplayPeriodUs)
+        {
+            loopUs += kDisplayRedrawUs;
+            lastDisplayUs = loopUs;
+        }
+    }
+}
+
+double SamplesToMs(double samples)
+{
+    return samples * 1000.0 / kSampleRate;
+}
+} // namespace
+
+int main()
+{
+    const std::vector<Ticks> arrivals = ScriptArrivals();
+    std::printf("Note-on latency from wire to first affected sample, %zu scripted notes, block %u\n",
+                arrivals.size(), kBlockSize);
+    std::printf("%22s%10s%10s%10s%12s%10s\n", "path", "min ms", "mean ms", "max ms", "jitter smp", "in order");
+
+    Stats legacy;
+    RunMainLoop(arrivals, legacy);
+    std::printf("%22s%10.3f%10.3f%10.3f%12.1f%10s\n", "main loop (model)", SamplesToMs(legacy.minLatency),
+                SamplesToMs(legacy.Mean()), SamplesToMs(legacy.maxLatency), legacy.Jitter(), "-");
+
+    bool ok = true;
+    for (const Scenario &scenario : kScenarios)
+    {
+        Stats stats;
+        const bool delivered = RunScheduled(scenario, arrivals, stats);
+        // One block at most. Stamps round down to a whole sample, and a late
+        // interrupt makes the stamps after it early by its lateness.
+        const bool pass = delivered && stats.count == arrivals.size()
+            && stats.minLatency >= kBlockSize - scenario.maxJitterSamples && stats.maxLatency <= kBlockSize
+            && stats.Jitter() <= scenario.maxJitterSamples;
+        ok = ok && pass;
+        char name[32];
+        std::snprintf(name, sizeof(name), "queued, %s", scenario.name);
+        std::printf("%22s%10.3f%10.3f%10.3f%12.1f%10s%s\n", name, SamplesToMs(stats.minLatency),
+                    SamplesToMs(stats.Mean()), SamplesToMs(stats.maxLatency), stats.Jitter(),
+                    delivered ? "yes" : "no", pass ? "" : "  FAIL");
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "MIDI timing test failed (notes lost, reordered, or not one block late).\n");
+        return 1;
+    }
+    return 0;
+}
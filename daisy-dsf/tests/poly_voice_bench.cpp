@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "disyn_algorithm_info.h"
+#include "disyn_oscillator.h"
+#include "disyn_voice_engine.h"
+
+// Only Tanh Sq, Tanh Saw, DSF S and Mod FM have packed kernels
+// (disyn_voice_lanes.h). Every other algorithm renders voice by voice
+// through its own DisynOscillator, so its cost grows with the voice count
+// as N calls of the mono block path: the "packed" column says which is
+// which.
+//
+// "max v" is the voice count that fits the Daisy at 48 kHz under a
+// per-voice cost model: the 1-voice cost plus the measured cost of each
+// further voice, converted from host ns to Cortex-M7 cycles. The
+// conversion is an estimate; pass a ratio measured on the module (cycles
+// for one voice there over this bench's "1 v" ns) as the first argument.
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBlockSize = 48;
+constexpr size_t kBenchSamples = 48000;
+constexpr size_t kCheckSamples = 4800;
+constexpr int kPasses = 5;
+constexpr int kAlgorithms = 19; // Everything but the calibration tone
+// The Daisy Seed's M7 at 480 MHz has 10000 cycles per 48 kHz sample; the
+// voices may use this share of them, the rest is left for the callback,
+// controls and display.
+constexpr double kTargetClockHz = 480.0e6;
+constexpr double kLoadBudget = 0.7;
+// Target cycles per host ns of the same code. The M7 issues about one
+// float operation a cycle where a desktop core issues several at six times
+// the clock, and its libm tanh/exp are slower; this is the rough ratio
+// those give, not a measurement.
+constexpr double kDefaultCyclesPerHostNs = 8.0;
+constexpr size_t kVoiceCounts[] = {1, 4, 8, 16};
+constexpr size_t kVoiceCountCount = sizeof(kVoiceCounts) / sizeof(kVoiceCounts[0]);
+
+using Clock = std::chrono::steady_clock;
+
+void Configure(disyn::PolyVoiceEngine &engine, int algorithm, size_t voices)
+{
+    engine.Init(kSampleRate);
+    engine.SetAlgorithm(algorithm);
+    engine.SetVoiceCount(disyn::PolyVoiceEngine::kMaxVoices);
+    engine.SetParam1(0.4f);
+    engine.SetParam2(0.6f);
+    engine.SetParam3(0.3f);
+    // A spread chord, a fifth apart, all held.
+    for (size_t v = 0; v < voices; ++v)
+        engine.NoteOn(static_cast<uint8_t>(36 + (7 * v) % 48), 100);
+}
+
+double NsPerSample(int algorithm, size_t voices)
+{
+    static float primary[kBlockSize];
+    static float secondary[kBlockSize];
+    static disyn::PolyVoiceEngine engine;
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        Configure(engine, algorithm, voices);
+        float acc = 0.0f;
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kBenchSamples; n += kBlockSize)
+        {
+            // Params move every block, as they do from the knobs and CVs.
+            engine.SetParam1(0.2f + 0.6f * static_cast<float>(n / kBlockSize % 200) / 200.0f);
+            engine.ProcessBlock(primary, secondary, kBlockSize);
+            acc += primary[0] + secondary[kBlockSize - 1];
+        }
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        if (!std::isfinite(acc))
+            return -1.0;
+    }
+    return best / kBenchSamples;
+}
+
+// One voice at full velocity with an instant attack must render exactly
+// what a DisynOscillator does, packed kernel or not, both with the settings
+// held and while they ramp.
+float VoiceMismatch(int algorithm)
+{
+    static disyn::PolyVoiceEngine engine;
+    static disyn::DisynOscillator osc;
+    engine.Init(kSampleRate);
+    engine.SetAlgorithm(algorithm);
+    engine.SetAttack(0.0f);
+    engine.SetParam1(0.4f);
+    engine.SetParam2(0.6f);
+    engine.SetParam3(0.3f);
+    engine.NoteOn(69, 127);
+
+    osc.Init(kSampleRate);
+    osc.SetAlgorithm(algorithm);
+    osc.SetFrequency(440.0f);
+    osc.SetParam1(0.4f);
+    osc.SetParam2(0.6f);
+    osc.SetParam3(0.3f);
+
+    float primary[kBlockSize];
+    float secondary[kBlockSize];
+    float expectedPrimary[kBlockSize];
+    float expectedSecondary[kBlockSize];
+    float maxErr = 0.0f;
+    for (size_t n = 0; n < kCheckSamples; n += kBlockSize)
+    {
+        // Held for the first half, then moving every block.
+        if (n >= kCheckSamples / 2)
+        {
+            const float param = 0.2f + 0.6f * static_cast<float>(n % 960) / 960.0f;
+            engine.SetParam1(param);
+            osc.SetParam1(param);
+        }
+        engine.ProcessBlock(primary, secondary, kBlockSize);
+        osc.ProcessBlock(expectedPrimary, expectedSecondary, kBlockSize);
+        for (size_t j = 0; j < kBlockSize; ++j)
+        {
+            maxErr = std::max(maxErr, std::fabs(expectedPrimary[j] - primary[j]));
+            maxErr = std::max(maxErr, std::fabs(expectedSecondary[j] - secondary[j]));
+        }
+    }
+    return maxErr;
+}
+
+bool IsPacked(int algorithm)
+{
+    switch (static_cast<disyn::AlgorithmType>(algorithm))
+    {
+    case disyn::AlgorithmType::TANH_SQUARE:
+    case disyn::AlgorithmType::TANH_SAW:
+    case disyn::AlgorithmType::DSF_SINGLE:
+    case disyn::AlgorithmType::MOD_FM:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Steals go to the quietest released voice first, then the oldest held one,
+// and released voices fade out and free themselves.
+bool AllocatorBehaves()
+{
+    static disyn::PolyVoiceEngine engine;
+    float primary[kBlockSize];
+    float secondary[kBlockSize];
+    engine.Init(kSampleRate);
+    engine.SetVoiceCount(8);
+    engine.SetRelease(0.05f);
+    for (uint8_t note = 60; note < 72; ++note)
+        engine.NoteOn(note, 100);
+    if (engine.ActiveVoices() != 8)
+        return false;
+
+    engine.NoteOff(70);
+    engine.NoteOn(80, 100); // Takes the released voice, no new one
+    if (engine.ActiveVoices() != 8)
+        return false;
+
+    engine.AllNotesOff();
+    for (size_t n = 0; n < 48000; n += kBlockSize)
+        engine.ProcessBlock(primary, secondary, kBlockSize);
+    return engine.ActiveVoices() == 0;
+}
+
+// Voices whose modelled cost fits the budget, 0 to kMaxVoices.
+size_t MaxVoices(double singleNs, double perVoiceNs, double cyclesPerHostNs)
+{
+    const double budget = kLoadBudget * kTargetClockHz / static_cast<double>(kSampleRate);
+    const double single = singleNs * cyclesPerHostNs;
+    const double perVoice = std::max(perVoiceNs, 0.0) * cyclesPerHostNs;
+    if (single > budget)
+        return 0;
+    if (perVoice <= 0.0)
+        return disyn::PolyVoiceEngine::kMaxVoices;
+    const double voices = 1.0 + std::floor((budget - single) / perVoice);
+    return static_cast<size_t>(std::min(voices, static_cast<double>(disyn::PolyVoiceEngine::kMaxVoices)));
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const double cyclesPerHostNs = argc > 1 ? std::atof(argv[1]) : kDefaultCyclesPerHostNs;
+    if (!(cyclesPerHostNs > 0.0))
+    {
+        std::fprintf(stderr, "usage: poly_voice_bench [target cycles per host ns]\n");
+        return 1;
+    }
+    const bool allocator = AllocatorBehaves();
+
+    std::printf("PolyVoiceEngine ns/sample by held voices (block %zu); unpacked algorithms render voice by voice\n",
+                kBlockSize);
+    std::printf("max v: voices within %.0f%% of a 48 kHz sample at %.0f MHz, modelled at %.1f cycles per host ns\n",
+                kLoadBudget * 100.0, kTargetClockHz / 1.0e6, cyclesPerHostNs);
+    std::printf("%10s%7s", "algorithm", "packed");
+    for (size_t voices : kVoiceCounts)
+        std::printf("%8zu v", voices);
+    std::printf("%10s%8s%10s\n", "16v/1v", "max v", "1v err");
+
+    bool ok = allocator;
+    for (int algorithm = 0; algorithm < kAlgorithms; ++algorithm)
+    {
+        double ns[kVoiceCountCount];
+        bool finite = true;
+        for (size_t k = 0; k < kVoiceCountCount; ++k)
+        {
+            ns[k] = NsPerSample(algorithm, kVoiceCounts[k]);
+            finite = finite && ns[k] >= 0.0;
+        }
+        const double single = ns[0];
+        const double full = ns[kVoiceCountCount - 1];
+        const double perVoice = (full - single) / static_cast<double>(kVoiceCounts[kVoiceCountCount - 1] - 1);
+        const size_t maxVoices = MaxVoices(single, perVoice, cyclesPerHostNs);
+        const float err = VoiceMismatch(algorithm);
+        const bool pass = finite && err == 0.0f;
+        ok = ok && pass;
+
+        std::printf("%10s%7s", disyn::GetAlgorithmInfo(algorithm).name, IsPacked(algorithm) ? "yes" : "no");
+        for (double value : ns)
+            std::printf("%10.1f", value);
+        std::printf("%9.1fx%8zu%10.1e%s\n", full / single, maxVoices, static_cast<double>(err), pass ? "" : "  FAIL");
+    }
+    std::printf("Allocator (steal released first, fade to idle): %s\n", allocator ? "ok" : "FAIL");
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "Poly voice bench failed (voice/oscillator mismatch, allocator or non-finite output).\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+#include "disyn_algorithm_info.h"
+#include "disyn_oscillator.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBlockSize = 48;
+constexpr size_t kBenchSamples = 48000;
+constexpr size_t kBuildEntries = 256; // Per main-loop pass in the firmware
+constexpr size_t kMaxWaitBlocks = 1000;
+// The table engages on the block after the build call that completes it.
+constexpr size_t kEngageSamples = (disyn::kShapeCacheSize + kBuildEntries) / kBuildEntries * kBlockSize;
+constexpr int kPasses = 5;
+constexpr double kMaxErrorDb = -60.0;
+
+using Clock = std::chrono::steady_clock;
+
+struct Case
+{
+    disyn::AlgorithmType algorithm;
+    float param1;
+    float param2;
+    float param3;
+};
+
+const Case kCases[] = {
+    {disyn::AlgorithmType::COMBINATION_3_PARALLEL_BANK, 0.2f, 0.5f, 0.3f},
+    {disyn::AlgorithmType::COMBINATION_3_PARALLEL_BANK, 1.0f, 0.5f, 0.7f},
+    {disyn::AlgorithmType::NOVEL_1_MULTISTAGE, 0.3f, 0.5f, 0.4f},
+    {disyn::AlgorithmType::NOVEL_1_MULTISTAGE, 1.0f, 1.0f, 0.9f},
+};
+
+void Configure(disyn::DisynOscillator &osc, const Case &c, bool cached)
+{
+    osc.Init(kSampleRate);
+    osc.SetAlgorithm(static_cast<int>(c.algorithm));
+    osc.SetFrequency(220.0f);
+    osc.SetParam1(c.param1);
+    osc.SetParam2(c.param2);
+    osc.SetParam3(c.param3);
+    osc.SetShapeCache(cached);
+}
+
+// Renders with the cache on, building between blocks as the main loop
+// would, until the output leaves the direct path, and returns the samples
+// that took (0 if it never did). Leaving early means the fallback was not
+// exact; leaving late means the finished table went unused.
+size_t SamplesUntilCached(const Case &c, float param1)
+{
+    static disyn::DisynOscillator cached;
+    static disyn::DisynOscillator direct;
+    Configure(cached, c, true);
+    Configure(direct, c, false);
+    cached.SetParam1(param1);
+    direct.SetParam1(param1);
+    float a[kBlockSize];
+    float b[kBlockSize];
+    float a2[kBlockSize];
+    float b2[kBlockSize];
+    for (size_t block = 0; block < kMaxWaitBlocks; ++block)
+    {
+        cached.ProcessBlock(a, a2, kBlockSize);
+        direct.ProcessBlock(b, b2, kBlockSize);
+        for (size_t i = 0; i < kBlockSize; ++i)
+        {
+            if (a[i] != b[i] || a2[i] != b2[i])
+                return block * kBlockSize;
+        }
+        disyn::DisynOscillator::BuildShapeCaches(kBuildEntries);
+    }
+    return 0;
+}
+
+void FillCache(const Case &c)
+{
+    static disyn::DisynOscillator osc;
+    float primary[kBlockSize];
+    float secondary[kBlockSize];
+    Configure(osc, c, true);
+    osc.ProcessBlock(primary, secondary, kBlockSize); // Posts the request
+    disyn::DisynOscillator::BuildShapeCaches(1 << 16);
+}
+
+double NsPerSample(const Case &c, bool cached)
+{
+    static float primary[kBenchSamples];
+    static float secondary[kBenchSamples];
+    static disyn::DisynOscillator osc;
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        Configure(osc, c, cached);
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kBenchSamples; n += kBlockSize)
+            osc.ProcessBlock(primary + n, secondary + n, kBlockSize);
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    return best / kBenchSamples;
+}
+
+// Worst difference between the cached and direct renders, relative to the
+// direct peak.
+double CachedErrorDb(const Case &c)
+{
+    static disyn::DisynOscillator cached;
+    static disyn::DisynOscillator direct;
+    Configure(cached, c, true);
+    Configure(direct, c, false);
+    float a[kBlockSize];
+    float b[kBlockSize];
+    float a2[kBlockSize];
+    float b2[kBlockSize];
+    double peak = 0.0;
+    double worst = 0.0;
+    for (size_t n = 0; n < kBenchSamples; n += kBlockSize)
+    {
+        cached.ProcessBlock(a, a2, kBlockSize);
+        direct.ProcessBlock(b, b2, kBlockSize);
+        for (size_t i = 0; i < kBlockSize; ++i)
+        {
+            peak = std::max(peak, static_cast<double>(std::fabs(b[i])));
+            worst = std::max(worst, static_cast<double>(std::fabs(a[i] - b[i])));
+            worst = std::max(worst, static_cast<double>(std::fabs(a2[i] - b2[i])));
+        }
+    }
+    return 20.0 * std::log10(std::max(worst, 1.0e-12) / peak);
+}
+} // namespace
+
+int main()
+{
+    std::printf("Shape cache: ns/sample direct vs cached, cached error vs direct, and samples until a new\n"
+                "setting is served from the table (building %zu points per %zu-sample block)\n",
+                kBuildEntries, kBlockSize);
+    std::printf("%8s%6s%6s%6s%10s%10s%9s%10s%10s\n", "algo", "p1", "p2", "p3", "direct", "cached", "speedup",
+                "err dB", "engage");
+
+    bool ok = true;
+    for (const Case &c : kCases)
+    {
+        // A fresh setting first: the direct path must hold, exactly, until
+        // the table is complete.
+        const size_t engage = SamplesUntilCached(c, c.param1 * 0.5f);
+
+        FillCache(c);
+        const double directNs = NsPerSample(c, false);
+        const double cachedNs = NsPerSample(c, true);
+        const double errorDb = CachedErrorDb(c);
+        const bool pass = engage == kEngageSamples && errorDb <= kMaxErrorDb;
+        ok = ok && pass;
+        std::printf("%8s%6.2f%6.2f%6.2f%10.2f%10.2f%8.2fx%10.1f%10zu%s\n",
+                    disyn::GetAlgorithmInfo(static_cast<int>(c.algorithm)).name, static_cast<double>(c.param1),
+                    static_cast<double>(c.param2), static_cast<double>(c.param3), directNs, cachedNs,
+                    directNs / cachedNs, errorDb, engage, pass ? "" : "  FAIL");
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "Shape cache bench failed (table error or inexact fallback while rebuilding).\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "disyn_algorithm_utils.h"
+#include "disyn_phase.h"
+
+namespace
+{
+constexpr double kTwoPi = 6.28318530717958647692;
+constexpr uint32_t kSweepStep = 257; // Odd, so the sweep lands on varied fractions
+constexpr double kMaxErrorDb = -100.0;
+constexpr size_t kBenchSamples = 1 << 16;
+constexpr size_t kLanes = 4;
+constexpr int kPasses = 5;
+
+using Clock = std::chrono::steady_clock;
+
+// Worst |error| of the sine and cosine lookups over a dense phase sweep.
+double MaxError()
+{
+    double worst = 0.0;
+    uint32_t phase = 0;
+    do
+    {
+        const double angle = kTwoPi * static_cast<double>(phase) / 4294967296.0;
+        worst = std::max(worst, std::fabs(disyn::SineLookup(phase) - std::sin(angle)));
+        worst = std::max(worst, std::fabs(disyn::CosineLookup(phase) - std::cos(angle)));
+        phase += kSweepStep;
+    } while (phase >= kSweepStep);
+    return worst;
+}
+
+// Increments go through float phase units, so they may be off by float
+// rounding (under 256 units near half a turn) but must wrap correctly,
+// including above Nyquist and for negative frequencies.
+bool IncrementsExact()
+{
+    const float frequencies[] = {0.0f, 1.0f, 27.5f, 440.0f, 12345.6f, 23999.0f, 30000.0f, -440.0f};
+    for (float f : frequencies)
+    {
+        const double turns = static_cast<double>(f) / 48000.0;
+        const double wrapped = turns - std::floor(turns + 0.5);
+        const double units = static_cast<double>(static_cast<int32_t>(disyn::PhaseStep(disyn::PhaseIncrement(f, 48000.0f))));
+        if (std::fabs(units - wrapped * 4294967296.0) > 256.0)
+            return false;
+    }
+    return true;
+}
+
+template <typename Fn>
+double NsPerSample(Fn fn)
+{
+    double best = 1.0e30;
+    volatile float sink = 0.0f;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        const auto start = Clock::now();
+        const float acc = fn();
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        sink = acc;
+    }
+    (void)sink;
+    return best / kBenchSamples;
+}
+
+// The float path the algorithms used before: floor-wrapped phase and std::sin.
+float FloatOscillators()
+{
+    float phases[kLanes] = {};
+    const float increments[kLanes] = {0.0091f, 0.0137f, 0.0213f, 0.0029f};
+    float acc = 0.0f;
+    for (size_t n = 0; n < kBenchSamples; ++n)
+    {
+        for (size_t k = 0; k < kLanes; ++k)
+        {
+            phases[k] = disyn::AdvancePhase(phases[k], increments[k]);
+            acc += std::sin(static_cast<float>(kTwoPi) * phases[k]);
+        }
+    }
+    return acc;
+}
+
+float TableOscillators()
+{
+    uint32_t phases[kLanes] = {};
+    const uint32_t increments[kLanes] = {
+        disyn::PhaseStep(disyn::PhaseUnits(0.0091f)), disyn::PhaseStep(disyn::PhaseUnits(0.0137f)),
+        disyn::PhaseStep(disyn::PhaseUnits(0.0213f)), disyn::PhaseStep(disyn::PhaseUnits(0.0029f))};
+    float sines[kLanes];
+    float acc = 0.0f;
+    for (size_t n = 0; n < kBenchSamples; ++n)
+    {
+        for (size_t k = 0; k < kLanes; ++k)
+            phases[k] += increments[k];
+        disyn::SineLookup(phases, sines, kLanes);
+        for (size_t k = 0; k < kLanes; ++k)
+            acc += sines[k];
+    }
+    return acc;
+}
+} // namespace
+
+int main()
+{
+    const double error = MaxError();
+    const double errorDb = 20.0 * std::log10(error);
+    const bool exact = IncrementsExact();
+    const double floatNs = NsPerSample(FloatOscillators);
+    const double tableNs = NsPerSample(TableOscillators);
+
+    std::printf("Sine table (%zu segments): max error %.2e (%.1f dB)%s\n", disyn::kSineTableSize, error, errorDb,
+                errorDb <= kMaxErrorDb ? "" : "  FAIL");
+    std::printf("Phase increments match the wrapped exact value: %s\n", exact ? "yes" : "no  FAIL");
+    std::printf("%zu oscillators, ns/sample: float phase + std::sin %.2f, uint32 phase + table %.2f (%.2fx)\n",
+                kLanes, floatNs, tableNs, floatNs / tableNs);
+
+    if (errorDb > kMaxErrorDb || !exact)
+    {
+        std::fprintf(stderr, "Sine table bench failed (lookup accuracy or phase increment mismatch).\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "disyn_algorithms.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBenchSamples = 48000;
+constexpr int kPasses = 5;
+
+constexpr size_t kFftSize = 9600;
+constexpr size_t kSettleSamples = 4800;
+// Bins either side of a harmonic that belong to it (the window's main lobe).
+constexpr int kLobeBins = 4;
+constexpr float kBandHz = 20000.0f;
+
+// The band-limited bounces must cut the alias power of a sharp-cornered
+// triangle by this much, and event-driven stepping must hold the pitch.
+constexpr double kMinImprovementDb = 6.0;
+constexpr double kMaxPitchErrorCents = 1.0;
+
+using Clock = std::chrono::steady_clock;
+
+struct CostCase
+{
+    float pitch;
+    float param1; // Sides: 3 + round(9 * param1)
+    float param2; // Launch angle
+    float param3; // Bounce jitter
+};
+
+const CostCase kCostCases[] = {
+    {110.0f, 0.0f, 0.10f, 0.0f},
+    {440.0f, 0.33f, 0.10f, 0.5f},
+    {440.0f, 1.0f, 0.37f, 1.0f},
+    {2000.0f, 0.33f, 0.10f, 0.5f},
+    {2000.0f, 1.0f, 0.37f, 1.0f},
+};
+
+// In the square (param1 = 1/9) a horizontal launch bounces between the two
+// upright walls, so OUT 1 is a triangle wave at pitch / half-width: a
+// periodic signal whose aliasing can be read off its spectrum. The
+// reference is the same triangle sampled exactly, with sharp corners.
+constexpr float kSquareParam1 = 1.0f / 9.0f;
+// Periods of a fractional number of samples, so the aliases do not fold
+// onto harmonics.
+const float kTriangleHz[] = {1237.0f, 2941.0f, 4813.0f};
+
+float sink[kBenchSamples];
+
+double NsPerSample(const CostCase &c, bool eventDriven)
+{
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        disyn::TrajectoryAlgorithm trajectory(kSampleRate);
+        trajectory.SetEventDriven(eventDriven);
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kBenchSamples; ++n)
+            sink[n] = trajectory.Process(c.pitch, c.param1, c.param2, c.param3).primary;
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    return best / kBenchSamples;
+}
+
+enum class Source
+{
+    PER_SAMPLE,
+    EVENT_DRIVEN,
+    SHARP_TRIANGLE,
+};
+
+struct Spectrum
+{
+    double aliasDb;     // Power between the harmonics, dB re all power in band
+    double pitchCents;  // Fundamental against the requested triangle
+};
+
+std::vector<float> Render(Source source, float triangleHz)
+{
+    const float halfWidth = std::cos(static_cast<float>(M_PI) / 4.0f);
+    std::vector<float> samples(kSettleSamples + kFftSize);
+    if (source == Source::SHARP_TRIANGLE)
+    {
+        for (size_t n = 0; n < samples.size(); ++n)
+        {
+            const double phase = std::fmod(static_cast<double>(n) * triangleHz / kSampleRate, 1.0);
+            samples[n] = halfWidth * static_cast<float>(4.0 * std::fabs(phase - 0.5) - 1.0);
+        }
+        return samples;
+    }
+
+    disyn::TrajectoryAlgorithm trajectory(kSampleRate);
+    trajectory.SetEventDriven(source == Source::EVENT_DRIVEN);
+    for (float &sample : samples)
+        sample = trajectory.Process(triangleHz * halfWidth, kSquareParam1, 0.0f, 0.0f).primary;
+    return samples;
+}
+
+// The fundamental is found from the spectrum rather than assumed, so a path
+// whose period is off is charged for that in pitch, not in aliasing.
+Spectrum Analyse(Source source, float triangleHz)
+{
+    constexpr double kTwoPi = 6.28318530717958647692;
+    const std::vector<float> samples = Render(source, triangleHz);
+
+    std::vector<double> windowed(kFftSize);
+    for (size_t i = 0; i < kFftSize; ++i)
+    {
+        const float x = samples[kSettleSamples + i];
+        const double phase = kTwoPi * static_cast<double>(i) / kFftSize;
+        const double w = 0.35875 - 0.48829 * std::cos(phase) + 0.14128 * std::cos(2.0 * phase)
+            - 0.01168 * std::cos(3.0 * phase);
+        windowed[i] = w * x;
+    }
+
+    std::vector<double> cosine(kFftSize);
+    std::vector<double> sine(kFftSize);
+    for (size_t n = 0; n < kFftSize; ++n)
+    {
+        cosine[n] = std::cos(kTwoPi * static_cast<double>(n) / kFftSize);
+        sine[n] = std::sin(kTwoPi * static_cast<double>(n) / kFftSize);
+    }
+
+    const size_t bandBins = static_cast<size_t>(kBandHz / kSampleRate * kFftSize);
+    std::vector<double> power(bandBins + 1);
+    for (size_t k = 0; k <= bandBins; ++k)
+    {
+        double re = 0.0;
+        double im = 0.0;
+        size_t index = 0;
+        for (size_t n = 0; n < kFftSize; ++n)
+        {
+            re += windowed[n] * cosine[index];
+            im -= windowed[n] * sine[index];
+            index += k;
+            if (index >= kFftSize)
+                index -= kFftSize;
+        }
+        power[k] = re * re + im * im;
+    }
+
+    // Fundamental: the strongest bin above DC, refined by a parabola
+    // through the log magnitudes around it.
+    size_t peak = 1 + kLobeBins;
+    for (size_t k = peak; k < bandBins; ++k)
+    {
+        if (power[k] > power[peak])
+            peak = k;
+    }
+    const double a = std::log(power[peak - 1]);
+    const double b = std::log(power[peak]);
+    const double c = std::log(power[peak + 1]);
+    const double fundamental = static_cast<double>(peak) + 0.5 * (a - c) / (a - 2.0 * b + c);
+
+    double harmonic = 0.0;
+    double alias = 0.0;
+    for (size_t k = 0; k <= bandBins; ++k)
+    {
+        const double nearest = std::round(static_cast<double>(k) / fundamental) * fundamental;
+        if (std::fabs(static_cast<double>(k) - nearest) <= kLobeBins)
+            harmonic += power[k];
+        else
+            alias += power[k];
+    }
+    const double fundamentalHz = fundamental * kSampleRate / kFftSize;
+    return {10.0 * std::log10(std::max(alias, 1.0e-30) / (harmonic + alias)),
+            1200.0 * std::log2(fundamentalHz / triangleHz)};
+}
+} // namespace
+
+int main()
+{
+    bool ok = true;
+
+    std::printf("Trajectory: ns/sample testing every edge per sample vs event-driven stepping\n");
+    std::printf("%8s%6s%6s%6s%12s%10s%9s\n", "pitch", "p1", "p2", "p3", "per-sample", "event", "speedup");
+    for (const CostCase &c : kCostCases)
+    {
+        const double perSampleNs = NsPerSample(c, false);
+        const double eventNs = NsPerSample(c, true);
+        const bool pass = eventNs < perSampleNs;
+        ok = ok && pass;
+        std::printf("%8.0f%6.2f%6.2f%6.2f%12.2f%10.2f%8.2fx%s\n", static_cast<double>(c.pitch),
+                    static_cast<double>(c.param1), static_cast<double>(c.param2), static_cast<double>(c.param3),
+                    perSampleNs, eventNs, perSampleNs / eventNs, pass ? "" : "  FAIL");
+    }
+
+    std::printf("\nThe square's triangle wave: aliasing (power between harmonics below %.0f Hz, dB) and\n"
+                "pitch error (cents) per path, against the exactly sampled sharp-cornered triangle\n",
+                static_cast<double>(kBandHz));
+    std::printf("%10s%12s%10s%12s%10s%10s%10s\n", "triangle", "per-sample", "cents", "sharp", "event", "cents",
+                "gain");
+    for (const float hz : kTriangleHz)
+    {
+        const Spectrum perSample = Analyse(Source::PER_SAMPLE, hz);
+        const Spectrum sharp = Analyse(Source::SHARP_TRIANGLE, hz);
+        const Spectrum event = Analyse(Source::EVENT_DRIVEN, hz);
+        const bool pass = event.aliasDb <= sharp.aliasDb - kMinImprovementDb
+            && std::fabs(event.pitchCents) <= kMaxPitchErrorCents;
+        ok = ok && pass;
+        std::printf("%10.0f%12.1f%10.1f%12.1f%10.1f%10.2f%10.1f%s\n", static_cast<double>(hz), perSample.aliasDb,
+                    perSample.pitchCents, sharp.aliasDb, event.aliasDb, event.pitchCents,
+                    sharp.aliasDb - event.aliasDb, pass ? "" : "  FAIL");
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "Trajectory bench failed (event-driven stepping slower, no less aliased or off pitch).\n");
+        return 1;
+    }
+    return 0;
+}
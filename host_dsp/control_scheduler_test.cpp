@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "control_scheduler.h"
+
+namespace
+{
+constexpr double kSampleRate = 48000.0;
+constexpr double kTickFrequency = 200.0e6;
+constexpr double kSeconds = 20.0;
+constexpr float kSmoothingSeconds = 0.05f;
+
+// The main loop as every firmware had it: a control pass, then every 33 ms
+// an OLED frame that holds the loop for the I2C transfer.
+constexpr double kControlPassUs = 40.0;
+constexpr double kDisplayPeriodUs = 33000.0;
+constexpr double kDisplayFrameUs = 12000.0;
+
+using Ticks = uint64_t;
+
+struct Scenario
+{
+    const char *name;
+    size_t blockSize;
+    double irqJitterUs;  // Lateness of every audio interrupt, 0 to this
+    double stallAtS;     // One callback held off at this time (< 0: none)
+    double stallUs;      // by this long
+    uint32_t tickOffset; // Counter value at time 0, to cross the wrap
+    uint32_t expectedMisses;
+};
+
+const Scenario kScenarios[] = {
+    {"block 48", 48, 2.0, -1.0, 0.0, 0, 0},
+    {"block 16", 16, 2.0, -1.0, 0.0, 0, 0},
+    {"block 128", 128, 2.0, -1.0, 0.0, 0, 0},
+    {"late irq", 48, 100.0, -1.0, 0.0, 0, 0},
+    {"counter wrap", 48, 2.0, -1.0, 0.0, 0xfff00000u, 0},
+    {"3.5 ms stall", 48, 2.0, 5.0, 3500.0, 0, 3},
+};
+
+// Deterministic, so a failure reproduces.
+struct Random
+{
+    uint32_t state = 12345u;
+
+    double Next()
+    {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<double>(state >> 8) / static_cast<double>(1u << 24);
+    }
+};
+
+Ticks UsToTicks(double us)
+{
+    return static_cast<Ticks>(us * kTickFrequency / 1.0e6);
+}
+
+struct Result
+{
+    double ticksPerSecond = 0.0;
+    double maxGapMs = 0.0; // Longest wall-clock wait between control ticks
+    double tauMs = 0.0;    // Time a step took to reach 1 - 1/e
+    uint32_t misses = 0;
+};
+
+// Audio interrupts at their nominal times plus jitter; each runs the ticks
+// BeginBlock() hands it, and one of them smooths a step in the knob.
+Result RunScheduled(const Scenario &scenario)
+{
+    ControlScheduler scheduler;
+    scheduler.Init(static_cast<float>(kSampleRate), static_cast<uint32_t>(kTickFrequency));
+    const float coefficient = scheduler.SmoothingCoefficient(kSmoothingSeconds);
+
+    Random random;
+    Result result;
+    const double blockUs = 1.0e6 * static_cast<double>(scenario.blockSize) / kSampleRate;
+    const size_t blocks = static_cast<size_t>(kSeconds * 1.0e6 / blockUs);
+    const double stepUs = 1.0e6;
+    double lastTickUs = -1.0;
+    double reachedUs = -1.0;
+    float smoothed = 0.0f;
+    bool stalled = false;
+    for (size_t block = 0; block < blocks; ++block)
+    {
+        const double nominalUs = static_cast<double>(block) * blockUs;
+        double startUs = nominalUs + random.Next() * scenario.irqJitterUs;
+        if (scenario.stallAtS >= 0.0 && !stalled && nominalUs >= scenario.stallAtS * 1.0e6)
+        {
+            // The blocks whose interrupts fell inside the stall are lost.
+            startUs = nominalUs + scenario.stallUs;
+            block += static_cast<size_t>(scenario.stallUs / blockUs);
+            stalled = true;
+        }
+
+        const uint32_t tick = scenario.tickOffset + static_cast<uint32_t>(UsToTicks(startUs));
+        const size_t due = scheduler.BeginBlock(scenario.blockSize, tick);
+        for (size_t i = 0; i < due; ++i)
+        {
+            if (lastTickUs >= 0.0)
+                result.maxGapMs = std::max(result.maxGapMs, (startUs - lastTickUs) / 1000.0);
+            lastTickUs = startUs;
+
+            const float target = nominalUs >= stepUs ? 1.0f : 0.0f;
+            smoothed += (target - smoothed) * coefficient;
+            if (reachedUs < 0.0 && smoothed >= 1.0f - std::exp(-1.0f))
+                reachedUs = nominalUs;
+        }
+    }
+    result.ticksPerSecond = static_cast<double>(scheduler.ControlTicks()) / kSeconds;
+    result.tauMs = (reachedUs - stepUs) / 1000.0;
+    result.misses = scheduler.DeadlineMisses();
+    return result;
+}
+
+// The old loop, with the per-pass coefficient that gives the same time
+// constant when the display is idle.
+Result RunMainLoop()
+{
+    const float coefficient = 1.0f - std::exp(static_cast<float>(-kControlPassUs / (kSmoothingSeconds * 1.0e6)));
+    Result result;
+    const double stepUs = 1.0e6;
+    double loopUs = 0.0;
+    double lastDisplayUs = 0.0;
+    double lastPassUs = 0.0;
+    double reachedUs = -1.0;
+    float smoothed = 0.0f;
+    size_t passes = 0;
+    while (loopUs < kSeconds * 1.0e6)
+    {
+        result.maxGapMs = std::max(result.maxGapMs, (loopUs - lastPassUs) / 1000.0);
+        lastPassUs = loopUs;
+        ++passes;
+        const float target = loopUs >= stepUs ? 1.0f : 0.0f;
+        smoothed += (target - smoothed) * coefficient;
+        if (reachedUs < 0.0 && smoothed >= 1.0f - std::exp(-1.0f))
+            reachedUs = loopUs;
+
+        loopUs += kControlPassUs;
+        if (loopUs - lastDisplayUs > kDisplayPeriodUs)
+        {
+            loopUs += kDisplayFrameUs;
+            lastDisplayUs = loopUs;
+        }
+    }
+    result.ticksPerSecond = static_cast<double>(passes) / kSeconds;
+    result.tauMs = (reachedUs - stepUs) / 1000.0;
+    return result;
+}
+
+// The UI task in that same loop: how many frames UiDue() lets through.
+size_t RunUiFrames()
+{
+    ControlScheduler scheduler;
+    scheduler.Init(static_cast<float>(kSampleRate), static_cast<uint32_t>(kTickFrequency));
+    size_t frames = 0;
+    double loopUs = 0.0;
+    while (loopUs < kSeconds * 1.0e6)
+    {
+        loopUs += kControlPassUs;
+        if (scheduler.UiDue(static_cast<uint32_t>(UsToTicks(loopUs))))
+        {
+            loopUs += kDisplayFrameUs;
+            ++frames;
+        }
+    }
+    return frames;
+}
+} // namespace
+
+int main()
+{
+    std::printf("Control rate and smoothing, %.0f s, step smoothed with a %.0f ms time constant\n", kSeconds,
+                kSmoothingSeconds * 1000.0f);
+    std::printf("%16s%10s%12s%10s%8s\n", "path", "ticks/s", "max gap ms", "tau ms", "misses");
+
+    const Result legacy = RunMainLoop();
+    std::printf("%16s%10.0f%12.2f%10.1f%8s\n", "main loop", legacy.ticksPerSecond, legacy.maxGapMs, legacy.tauMs,
+                "-");
+
+    bool ok = true;
+    const double tickMs = 1000.0 / ControlScheduler::kControlRate;
+    for (const Scenario &scenario : kScenarios)
+    {
+        const Result result = RunScheduled(scenario);
+        const double blockMs = 1000.0 * static_cast<double>(scenario.blockSize) / kSampleRate;
+        // Exactly the control rate, ticks never further apart than a block
+        // (or a tick) plus the interrupt's lateness, the time constant
+        // within a block of nominal, and exactly the stalled ticks missed.
+        const double maxGapMs = std::max(blockMs, tickMs) + scenario.irqJitterUs / 1000.0 + scenario.stallUs / 1000.0;
+        const bool pass = std::fabs(result.ticksPerSecond - ControlScheduler::kControlRate) <= 1.0
+                          && result.maxGapMs <= maxGapMs
+                          && std::fabs(result.tauMs - kSmoothingSeconds * 1000.0) <= blockMs + tickMs
+                          && result.misses == scenario.expectedMisses;
+        ok = ok && pass;
+        std::printf("%16s%10.0f%12.2f%10.1f%8u%s\n", scenario.name, result.ticksPerSecond, result.maxGapMs,
+                    result.tauMs, result.misses, pass ? "" : "  FAIL");
+    }
+
+    const size_t frames = RunUiFrames();
+    const size_t expectedFrames = static_cast<size_t>(kSeconds * ControlScheduler::kUiRate);
+    const bool uiPass = frames + expectedFrames / 100 >= expectedFrames && frames <= expectedFrames + 1;
+    ok = ok && uiPass;
+    std::printf("UI frames: %zu in %.0f s (%zu at %.0f Hz)%s\n", frames, kSeconds, expectedFrames,
+                ControlScheduler::kUiRate, uiPass ? "" : "  FAIL");
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "Control scheduler test failed (rate, gap, time constant, misses or UI rate off).\n");
+        return 1;
+    }
+    return 0;
+}
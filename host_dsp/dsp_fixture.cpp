@@ -113,9 +113,11 @@ ThdResult MeasureThd(const std::vector<float> &samples, float sampleRate, float
     return result;
 }
 
+SpectralChannelBuffers s_buffers;
+
 void BuildWindow(std::vector<float> &window)
 {
-    window.resize(SpectralChannel::kFftSize);
+    window.resize(SpectralChannel::kMaxFftSize);
     for (size_t i = 0; i < window.size(); ++i)
     {
         const float phase = static_cast<float>(i) / static_cast<float>(window.size());
@@ -131,7 +133,7 @@ int main()
     BuildWindow(window);
 
     const size_t totalSamples = static_cast<size_t>(kSampleRate) * kSeconds;
-    const size_t warmup = SpectralChannel::kFftSize * kWarmupFrames;
+    const size_t warmup = kSpectralFftSize * kWarmupFrames;
     const size_t capture = static_cast<size_t>(kSampleRate);
 
     std::printf("process, rms, fund, thdn, h2, h3, h4, h5\n");
@@ -140,7 +142,7 @@ int main()
     {
         const auto process = static_cast<SpectralProcess>(p);
         SpectralChannel channel;
-        channel.Init(kSampleRate, window.data());
+        channel.Init(kSampleRate, window.data(), &s_buffers);
 
         std::vector<float> output;
         output.reserve(capture);
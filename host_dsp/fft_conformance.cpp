@@ -0,0 +1,115 @@
+// Conformance test for SpectralFft's real-transform API. Every backend must
+// match a double-precision DFT and round-trip to unity gain at every size.
+// Build it against the portable backend (default) or CMSIS-DSP, see Makefile.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "spectral_fft.h"
+
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+constexpr float kSpectrumTolerance = 1.0e-6f;  // Max bin error for unit-peak input (bins are 1/N scaled)
+constexpr float kRoundTripTolerance = 1.0e-5f; // Max sample error after forward + inverse
+constexpr int kTimingPasses = 2000;
+
+using Clock = std::chrono::steady_clock;
+
+float Random()
+{
+    return static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 2.0f - 1.0f;
+}
+
+struct Result
+{
+    float spectrumError = 0.0f;
+    float roundTripError = 0.0f;
+    double nsPerPair = 0.0;
+};
+
+Result CheckSize(SpectralFft &fft, size_t size)
+{
+    Result result;
+    std::vector<float> input(size);
+    std::vector<float> re(size);
+    std::vector<float> im(size);
+    for (size_t i = 0; i < size; ++i)
+        input[i] = Random();
+
+    std::copy(input.begin(), input.end(), re.begin());
+    fft.ForwardReal(re.data(), im.data(), size);
+
+    // Reference: X[k] = (1/N) sum x[n] e^{-j 2 pi k n / N}
+    for (size_t k = 0; k <= size / 2; ++k)
+    {
+        double sumRe = 0.0;
+        double sumIm = 0.0;
+        for (size_t n = 0; n < size; ++n)
+        {
+            const double phase = 2.0 * kPi * static_cast<double>((k * n) % size) / static_cast<double>(size);
+            sumRe += input[n] * std::cos(phase);
+            sumIm -= input[n] * std::sin(phase);
+        }
+        sumRe /= static_cast<double>(size);
+        sumIm /= static_cast<double>(size);
+        result.spectrumError = std::max(result.spectrumError, static_cast<float>(std::fabs(re[k] - sumRe)));
+        result.spectrumError = std::max(result.spectrumError, static_cast<float>(std::fabs(im[k] - sumIm)));
+    }
+
+    fft.InverseReal(re.data(), im.data(), size);
+    for (size_t i = 0; i < size; ++i)
+        result.roundTripError = std::max(result.roundTripError, std::fabs(re[i] - input[i]));
+
+    const auto start = Clock::now();
+    for (int pass = 0; pass < kTimingPasses; ++pass)
+    {
+        std::copy(input.begin(), input.end(), re.begin());
+        fft.ForwardReal(re.data(), im.data(), size);
+        fft.InverseReal(re.data(), im.data(), size);
+    }
+    result.nsPerPair = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kTimingPasses;
+    return result;
+}
+} // namespace
+
+int main()
+{
+    srand(1);
+    SpectralFft fft;
+    fft.Init();
+
+    std::printf("SpectralFft conformance, backend: %s\n", SpectralFft::BackendName());
+    std::printf("%6s%14s%14s%16s\n", "size", "bin error", "round trip", "ns fwd+inv");
+
+    bool ok = true;
+    for (size_t i = 0; i < kSpectralNumFftSizes; ++i)
+    {
+        const size_t size = SpectralFftSizeAt(static_cast<int>(i));
+        const Result result = CheckSize(fft, size);
+        const bool pass = result.spectrumError <= kSpectrumTolerance
+                          && result.roundTripError <= kRoundTripTolerance;
+        ok = ok && pass;
+        std::printf("%6zu%14.2e%14.2e%16.0f%s\n",
+                    size,
+                    static_cast<double>(result.spectrumError),
+                    static_cast<double>(result.roundTripError),
+                    result.nsPerPair,
+                    pass ? "" : "  FAIL");
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "FFT backend does not conform (bin tolerance %g, round-trip tolerance %g).\n",
+                     static_cast<double>(kSpectrumTolerance),
+                     static_cast<double>(kRoundTripTolerance));
+        return 1;
+    }
+    std::printf("FFT backend conforms.\n");
+    return 0;
+}
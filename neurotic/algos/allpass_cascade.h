@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+
+// Stereo chain of identical first-order allpasses,
+// H(z) = (-a + z^-1) / (1 - a z^-1) per stage.
+//
+// A stage's previous output is the next stage's previous input, so the chain
+// only keeps one value per stage boundary: state_[i] is the last input to
+// stage i and state_[poles] the last output. That makes each stage one
+// multiply and two adds. L and R are interleaved in the inner loop, giving the
+// FPU two independent dependency chains to overlap.
+class AllpassCascade
+{
+public:
+    static constexpr int kMaxPoles = 256;
+
+    void Reset()
+    {
+        std::fill(&state_[0][0], &state_[0][0] + 2 * (kMaxPoles + 1), 0.0f);
+    }
+
+    void Process(float &left, float &right, float a, int poles)
+    {
+        poles = std::clamp(poles, 0, kMaxPoles);
+        float xl = left;
+        float xr = right;
+        for (int i = 0; i < poles; ++i)
+        {
+            const float yl = a * (state_[i + 1][0] - xl) + state_[i][0];
+            const float yr = a * (state_[i + 1][1] - xr) + state_[i][1];
+            state_[i][0] = xl;
+            state_[i][1] = xr;
+            xl = yl;
+            xr = yr;
+        }
+        state_[poles][0] = xl;
+        state_[poles][1] = xr;
+        left = xl;
+        right = xr;
+    }
+
+private:
+    float state_[kMaxPoles + 1][2]{};
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+// Fractional-delay interpolators for the delay lines. A read at delay D
+// sits a fraction t = D - i past tap i (the newer neighbour) towards tap
+// i + 1. The cubic kernels also use taps i - 1 and i + 2.
+//
+// Linear is cheapest but is a lowpass that drags short loops flat and
+// damps them. Hermite (Catmull-Rom) and Lagrange are third order and stay
+// close to flat much further up; both are fine for modulated delays. The
+// first-order Thiran allpass has unity gain at every frequency and an exact
+// low-frequency delay, but it keeps state, so it suits delays that move
+// slowly.
+
+enum class DelayInterpolation
+{
+    Linear,
+    Hermite,
+    Lagrange,
+    Thiran,
+};
+
+constexpr int kDelayInterpolationCount = 4;
+
+inline float InterpolateLinear(float x0, float x1, float t)
+{
+    return x0 + (x1 - x0) * t;
+}
+
+inline float InterpolateHermite(float xm1, float x0, float x1, float x2, float t)
+{
+    const float c1 = 0.5f * (x1 - xm1);
+    const float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+    const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+    return ((c3 * t + c2) * t + c1) * t + x0;
+}
+
+// Tap weights for taps i - 1 .. i + 2, for reads that reuse one fraction.
+struct CubicWeights
+{
+    float w[4];
+
+    float Apply(float xm1, float x0, float x1, float x2) const
+    {
+        return w[0] * xm1 + w[1] * x0 + w[2] * x1 + w[3] * x2;
+    }
+};
+
+inline CubicWeights HermiteWeights(float t)
+{
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    return {{-0.5f * t3 + t2 - 0.5f * t,
+             1.5f * t3 - 2.5f * t2 + 1.0f,
+             -1.5f * t3 + 2.0f * t2 + 0.5f * t,
+             0.5f * t3 - 0.5f * t2}};
+}
+
+inline CubicWeights LagrangeWeights(float t)
+{
+    const float tp1 = t + 1.0f;
+    const float tm1 = t - 1.0f;
+    const float tm2 = t - 2.0f;
+    return {{-t * tm1 * tm2 * (1.0f / 6.0f),
+             tp1 * tm1 * tm2 * 0.5f,
+             -tp1 * t * tm2 * 0.5f,
+             tp1 * t * tm1 * (1.0f / 6.0f)}};
+}
+
+inline float InterpolateLagrange(float xm1, float x0, float x1, float x2, float t)
+{
+    return LagrangeWeights(t).Apply(xm1, x0, x1, x2);
+}
+
+// First-order Thiran allpass, y = a x[i] + x[i + 1] - a y[n - 1] with
+// a = (1 - d) / (1 + d). Its low-frequency delay is i + d, and it is best
+// behaved for d in [0.5, 1.5), so ThiranSplit picks i to keep d there.
+struct ThiranAllpass
+{
+    float coeff;
+    float last;
+
+    void Reset()
+    {
+        coeff = 0.0f;
+        last = 0.0f;
+    }
+
+    void SetFraction(float d)
+    {
+        coeff = (1.0f - d) / (1.0f + d);
+    }
+
+    float Process(float near, float far)
+    {
+        last = coeff * (near - last) + far;
+        return last;
+    }
+};
+
+// Splits delay into the tap ThiranAllpass reads first and its fraction.
+// Needs delay >= 1.5 so the first tap is at least 1.
+inline int ThiranSplit(float delay, float &fraction)
+{
+    const int integral = static_cast<int>(delay - 0.5f);
+    fraction = delay - static_cast<float>(integral);
+    return integral;
+}
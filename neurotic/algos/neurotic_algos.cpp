@@ -1,4 +1,7 @@
 #include "neurotic_algos.h"
+#include "allpass_cascade.h"
+#include "formant_bank.h"
+#include "fractional_delay.h"
 
 #include <algorithm>
 #include <cmath>
@@ -11,6 +14,7 @@ constexpr float kTwoPi = 2.0f * kPi;
 constexpr size_t kFftSize = 1024;
 constexpr size_t kHopSize = 256;
 constexpr size_t kBins = kFftSize / 2 + 1;
+constexpr float kSilenceThreshold = 1.0e-4f;
 
 float Clamp01(float v)
 {
@@ -40,19 +44,15 @@ float MapPitch(float value, float minMidi, float maxMidi)
     return 440.0f * std::pow(2.0f, (note - 69.0f) / 12.0f);
 }
 
-float OnePoleProcess(float x, float cutoffHz, float sampleRate, float &state)
+float OnePoleAlpha(float cutoffHz, float sampleRate)
 {
-    const float alpha = std::clamp(cutoffHz / (cutoffHz + sampleRate), 0.0f, 1.0f);
-    state += (x - state) * alpha;
-    return state;
+    return std::clamp(cutoffHz / (cutoffHz + sampleRate), 0.0f, 1.0f);
 }
 
-float Allpass(float x, float a, float &x1, float &y1)
+float OnePole(float x, float alpha, float &state)
 {
-    const float y = -a * x + x1 + a * y1;
-    x1 = x;
-    y1 = y;
-    return y;
+    state += (x - state) * alpha;
+    return state;
 }
 
 float ShortestPhaseDelta(float from, float to)
@@ -68,6 +68,8 @@ float ShortestPhaseDelta(float from, float to)
 struct SimpleDelay
 {
     static constexpr size_t kMax = 8192;
+    static constexpr size_t kMask = kMax - 1;
+    static_assert((kMax & kMask) == 0, "SimpleDelay size must be a power of two");
     float buffer[kMax];
     size_t write;
 
@@ -89,6 +91,45 @@ struct SimpleDelay
         return buffer[i0] + (buffer[i1] - buffer[i0]) * frac;
     }
 
+    // Third-order reads for swept delays that recirculate, where Read()'s
+    // linear interpolation dulls every repeat. Taps are taken one sample
+    // either side of the pair Read() uses.
+    float ReadHermite(float delaySamples) const
+    {
+        size_t i0 = 0;
+        const float t = CubicPosition(delaySamples, i0);
+        return InterpolateHermite(buffer[(i0 - 1) & kMask], buffer[i0], buffer[(i0 + 1) & kMask],
+                                  buffer[(i0 + 2) & kMask], t);
+    }
+
+    float ReadLagrange(float delaySamples) const
+    {
+        size_t i0 = 0;
+        const float t = CubicPosition(delaySamples, i0);
+        return InterpolateLagrange(buffer[(i0 - 1) & kMask], buffer[i0], buffer[(i0 + 1) & kMask],
+                                   buffer[(i0 + 2) & kMask], t);
+    }
+
+    // Linear by default, as these algorithms always sounded; Hermite when
+    // the Intrp setting asks for it.
+    float ReadSwept(float delaySamples, bool cubic) const
+    {
+        return cubic ? ReadHermite(delaySamples) : Read(delaySamples);
+    }
+
+    // The cubic kernels read two samples newer than the read point, so the
+    // delay must be at least 2.
+    float CubicPosition(float delaySamples, size_t &i0) const
+    {
+        const float d = std::clamp(delaySamples, 2.0f, static_cast<float>(kMax - 3));
+        float read = static_cast<float>(write) - d;
+        if (read < 0.0f)
+            read += static_cast<float>(kMax);
+        const size_t whole = static_cast<size_t>(read);
+        i0 = whole & kMask;
+        return read - static_cast<float>(whole);
+    }
+
     void Write(float v)
     {
         buffer[write] = v;
@@ -192,6 +233,9 @@ struct SpectralStereo
     size_t outRead;
     size_t outWrite;
     bool primed;
+    float hopPeak;
+    size_t silentHops;
+    bool frameDue;
     SpectralFft fft;
 
     void Init()
@@ -222,11 +266,19 @@ struct SpectralStereo
         std::fill(&input[1][0], &input[1][kFftSize], 0.0f);
         std::fill(&output[0][0], &output[0][4096], 0.0f);
         std::fill(&output[1][0], &output[1][4096], 0.0f);
+        ResetCounters();
+    }
+
+    void ResetCounters()
+    {
         inputWrite = 0;
         hopCounter = 0;
         outRead = 0;
         outWrite = 0;
         primed = false;
+        hopPeak = 0.0f;
+        silentHops = 0;
+        frameDue = false;
     }
 
     void ProcessSample(float inL, float inR, float &outL, float &outR)
@@ -234,6 +286,7 @@ struct SpectralStereo
         input[0][inputWrite] = inL;
         input[1][inputWrite] = inR;
         inputWrite = (inputWrite + 1) % kFftSize;
+        hopPeak = std::max(hopPeak, std::max(std::fabs(inL), std::fabs(inR)));
 
         outL = 0.0f;
         outR = 0.0f;
@@ -250,10 +303,17 @@ struct SpectralStereo
         if (hopCounter >= kHopSize)
         {
             hopCounter = 0;
+            // Once a full window of input is silent the frame would synthesise
+            // nothing, so skip it and only advance the OLA write head.
+            silentHops = (hopPeak < kSilenceThreshold) ? silentHops + 1 : 0;
+            hopPeak = 0.0f;
+            frameDue = !primed || silentHops < kFftSize / kHopSize;
+            if (!frameDue)
+                outWrite = (outWrite + kHopSize) % 4096;
         }
     }
 
-    bool ReadyForFrame() const { return hopCounter == 0; }
+    bool ReadyForFrame() const { return hopCounter == 0 && frameDue; }
 
     void BuildSpectrum()
     {
@@ -318,14 +378,145 @@ struct SpectralStereo
     }
 };
 
-SpectralStereo s_spectral;
-SimpleDelay s_delayA;
-SimpleDelay s_delayB;
+// Spectral and delay state an algorithm may own while it runs. Two sets are
+// pooled so the outgoing and incoming algorithms can overlap in a crossfade.
+struct AlgoResources
+{
+    SpectralStereo spectral;
+    SimpleDelay delayA;
+    SimpleDelay delayB;
+
+    void Init()
+    {
+        spectral.Init();
+        delayA.Reset();
+        delayB.Reset();
+    }
+
+    void Rewind()
+    {
+        spectral.ResetCounters();
+        delayA.write = 0;
+        delayB.write = 0;
+    }
+
+    // Zero at most maxSamples of the buffers starting at cursor; returns true
+    // once everything is clean.
+    bool Clear(size_t &cursor, size_t maxSamples)
+    {
+        struct Region
+        {
+            float *data;
+            size_t size;
+        };
+        const Region regions[] = {
+            {&spectral.input[0][0], 2 * kFftSize},
+            {&spectral.output[0][0], 2 * 4096},
+            {delayA.buffer, SimpleDelay::kMax},
+            {delayB.buffer, SimpleDelay::kMax},
+        };
+
+        size_t offset = cursor;
+        size_t budget = maxSamples;
+        for (const Region &region : regions)
+        {
+            if (offset >= region.size)
+            {
+                offset -= region.size;
+                continue;
+            }
+            const size_t count = std::min(region.size - offset, budget);
+            std::fill(region.data + offset, region.data + offset + count, 0.0f);
+            cursor += count;
+            budget -= count;
+            if (offset + count < region.size)
+            {
+                return false;
+            }
+            offset = 0;
+        }
+        return true;
+    }
+};
+
+AlgoResources s_resources[2];
+
+class AlgoBase
+{
+public:
+    void Bind(AlgoResources *res) { res_ = res; }
+    void ResetFeedback()
+    {
+        fbL_ = 0.0f;
+        fbR_ = 0.0f;
+    }
+
+protected:
+    // Shared block loop: control-rate values come from Algo::Prepare() once
+    // per block, then Algo::Tick() runs per sample with the global feedback
+    // path (the algorithm's own previous output) folded into its input.
+    template <typename Algo>
+    void RunBlock(Algo &algo,
+                  const float *inL,
+                  const float *inR,
+                  float *outL,
+                  float *outR,
+                  size_t n,
+                  const NeuroticRuntime &rt)
+    {
+        typename Algo::Controls c = algo.Prepare(rt, n);
+        const float fb = std::clamp(rt.fb, 0.0f, 0.98f);
+        float fbL = fbL_;
+        float fbR = fbR_;
+        for (size_t i = 0; i < n; ++i)
+        {
+            algo.Tick(inL[i] + fbL * fb, inR[i] + fbR * fb, c, fbL, fbR);
+            outL[i] = fbL;
+            outR[i] = fbR;
+        }
+        fbL_ = fbL;
+        fbR_ = fbR;
+    }
+
+    AlgoResources *res_ = &s_resources[0];
+    float fbL_ = 0.0f;
+    float fbR_ = 0.0f;
+};
+
+// Linear ramp of a control across one block.
+struct Ramp
+{
+    float value = 0.0f;
+    float step = 0.0f;
+
+    void Set(float start, float end, size_t n)
+    {
+        value = start;
+        step = (n > 0) ? (end - start) / static_cast<float>(n) : 0.0f;
+    }
+
+    float Next()
+    {
+        const float v = value;
+        value += step;
+        return v;
+    }
+};
+
+float LfoAtBlockEnd(const NeuroticRuntime &rt, size_t n)
+{
+    return rt.lfoValue + rt.lfoStep * static_cast<float>(n);
+}
 }
 
-class AlgoNcr
+class AlgoNcr : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        float dampAlpha;
+    };
+
     void Init(float sampleRate)
     {
         sampleRate_ = sampleRate;
@@ -345,8 +536,14 @@ public:
         }
     }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
     {
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
+
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
+    {
+        (void)n;
         const float mass = rt.c1;
         const float tension = rt.c2;
         const float damping = rt.c3;
@@ -356,8 +553,6 @@ public:
         const float spread = 1.0f + mass * 2.5f;
         const float q = 0.8f + (1.0f - damping) * 8.0f;
 
-        float sumL = 0.0f;
-        float sumR = 0.0f;
         for (int i = 0; i < 2; ++i)
         {
             const float ratio = 0.8f + static_cast<float>(i) * 0.9f;
@@ -367,18 +562,27 @@ public:
             svfR_[i].SetFreq(freqR * spread);
             svfL_[i].SetRes(q);
             svfR_[i].SetRes(q);
+        }
+
+        Controls c;
+        c.dampAlpha = OnePoleAlpha(MapExpo(1.0f - damping, 120.0f, 6000.0f), sampleRate_);
+        return c;
+    }
+
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
+    {
+        float sumL = 0.0f;
+        float sumR = 0.0f;
+        for (int i = 0; i < 2; ++i)
+        {
             svfL_[i].Process(inL);
             svfR_[i].Process(inR);
             sumL += svfL_[i].Band() * (1.0f / (i + 1));
             sumR += svfR_[i].Band() * (1.0f / (i + 1));
         }
 
-        const float dampCut = MapExpo(1.0f - damping, 120.0f, 6000.0f);
-        sumL = OnePoleProcess(sumL, dampCut, sampleRate_, lpStateL_);
-        sumR = OnePoleProcess(sumR, dampCut, sampleRate_, lpStateR_);
-
-        outL = sumL;
-        outR = sumR;
+        outL = OnePole(sumL, c.dampAlpha, lpStateL_);
+        outR = OnePole(sumR, c.dampAlpha, lpStateR_);
     }
 
 private:
@@ -389,9 +593,17 @@ private:
     float lpStateR_ = 0.0f;
 };
 
-class AlgoLsb
+class AlgoLsb : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        float depth;
+        float weave;
+        float protect;
+        size_t formantBin;
+    };
+
     void Init(float sampleRate)
     {
         (void)sampleRate;
@@ -399,57 +611,80 @@ public:
 
     void Reset() { }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
     {
-        s_spectral.ProcessSample(inL, inR, outL, outR);
-        if (!s_spectral.ReadyForFrame())
-            return;
-
-        s_spectral.BuildSpectrum();
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
 
-        const float depth = Clamp01(rt.c1);
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
+    {
+        (void)n;
         const float formant = Clamp01(rt.c2);
-        const float transient = Clamp01(rt.c3);
-        const float weave = Clamp01(rt.c4);
+        Controls c;
+        c.depth = Clamp01(rt.c1);
+        c.weave = Clamp01(rt.c4);
+        c.protect = Lerp(0.1f, 1.0f, Clamp01(rt.c3));
+        c.formantBin = static_cast<size_t>(formant * formant * (kBins - 1));
+        return c;
+    }
 
-        const float protect = Lerp(0.1f, 1.0f, transient);
-        const size_t formantBin = static_cast<size_t>(formant * formant * (kBins - 1));
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
+    {
+        res_->spectral.ProcessSample(inL, inR, outL, outR);
+        if (res_->spectral.ReadyForFrame())
+        {
+            ProcessFrame(c);
+        }
+    }
+
+private:
+    void ProcessFrame(const Controls &c)
+    {
+        SpectralStereo &spec = res_->spectral;
+        spec.BuildSpectrum();
 
         for (size_t k = 0; k < kBins; ++k)
         {
-            const float reL = s_spectral.re[0][k];
-            const float imL = s_spectral.im[0][k];
-            const float reR = s_spectral.re[1][k];
-            const float imR = s_spectral.im[1][k];
+            const float reL = spec.re[0][k];
+            const float imL = spec.im[0][k];
+            const float reR = spec.re[1][k];
+            const float imR = spec.im[1][k];
 
             const float magL = std::sqrt(reL * reL + imL * imL);
             const float magR = std::sqrt(reR * reR + imR * imR);
             const float phaseL = std::atan2(imL, reL);
             const float phaseR = std::atan2(imR, reR);
 
-            const float mix = (k < formantBin) ? weave : depth;
+            const float mix = (k < c.formantBin) ? c.weave : c.depth;
             const float magLNew = Lerp(magL, magR, mix);
             const float magRNew = Lerp(magR, magL, mix);
-            const float phaseShift = mix * protect * 6.0f;
+            const float phaseShift = mix * c.protect * 6.0f;
             const float phaseLNew = phaseL + ShortestPhaseDelta(phaseL, phaseR) * phaseShift;
             const float phaseRNew = phaseR + ShortestPhaseDelta(phaseR, phaseL) * phaseShift;
 
-            s_spectral.re[0][k] = magLNew * std::cos(phaseLNew);
-            s_spectral.im[0][k] = magLNew * std::sin(phaseLNew);
-            s_spectral.re[1][k] = magRNew * std::cos(phaseRNew);
-            s_spectral.im[1][k] = magRNew * std::sin(phaseRNew);
+            spec.re[0][k] = magLNew * std::cos(phaseLNew);
+            spec.im[0][k] = magLNew * std::sin(phaseLNew);
+            spec.re[1][k] = magRNew * std::cos(phaseRNew);
+            spec.im[1][k] = magRNew * std::sin(phaseRNew);
         }
 
-        s_spectral.InverseToOutput();
+        spec.InverseToOutput();
     }
-
-private:
-    int unused_ = 0;
 };
 
-class AlgoNth
+class AlgoNth : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        Ramp flow;
+        Ramp baseDelay;
+        float driveGain;
+        float fb;
+        float gapAlpha;
+        bool cubic;
+    };
+
     void Init(float sampleRate)
     {
         sampleRate_ = sampleRate;
@@ -462,46 +697,76 @@ public:
         phase_ = 0.0f;
     }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
+    {
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
+
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
+    {
+        const float flowStart = rt.c2 + rt.lfoValue * rt.lfoDepth * 0.4f;
+        const float flowEnd = rt.c2 + LfoAtBlockEnd(rt, n) * rt.lfoDepth * 0.4f;
+
+        Controls c;
+        c.flow.Set(flowStart, flowEnd, n);
+        c.baseDelay.Set(BaseDelay(flowStart), BaseDelay(flowEnd), n);
+        c.driveGain = 1.0f + rt.c1 * 4.0f;
+        c.fb = std::clamp(rt.c4 * 1.2f, 0.0f, 0.98f);
+        c.gapAlpha = OnePoleAlpha(MapExpo(1.0f - rt.c3, 80.0f, 12000.0f), sampleRate_);
+        c.cubic = rt.cubicDelays;
+        return c;
+    }
+
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
     {
-        const float drive = rt.c1;
-        const float flow = rt.c2 + rt.lfoValue * rt.lfoDepth * 0.4f;
-        const float headGap = rt.c3;
-        const float fb = std::clamp(rt.c4 * 1.2f, 0.0f, 0.98f);
+        const float flow = c.flow.Next();
+        const float baseDelay = c.baseDelay.Next();
 
-        const float baseDelay = MapExpo(0.1f + std::clamp(flow, 0.0f, 1.0f) * 0.9f, 120.0f, 2000.0f);
         phase_ += (0.1f + flow * 2.0f) / sampleRate_;
         if (phase_ > 1.0f)
             phase_ -= 1.0f;
         const float mod = std::sin(phase_ * kTwoPi) * (20.0f + flow * 140.0f);
         const float delaySamp = baseDelay + mod;
 
-        const float satL = SoftClip(inL * (1.0f + drive * 4.0f));
-        const float satR = SoftClip(inR * (1.0f + drive * 4.0f));
+        const float satL = SoftClip(inL * c.driveGain);
+        const float satR = SoftClip(inR * c.driveGain);
 
-        const float dl = s_delayA.Read(delaySamp);
-        const float dr = s_delayB.Read(delaySamp * 0.97f);
-        const float gapCut = MapExpo(1.0f - headGap, 80.0f, 12000.0f);
-        const float fbL = OnePoleProcess(dl, gapCut, sampleRate_, lpStateL_);
-        const float fbR = OnePoleProcess(dr, gapCut, sampleRate_, lpStateR_);
+        const float dl = res_->delayA.ReadSwept(delaySamp, c.cubic);
+        const float dr = res_->delayB.ReadSwept(delaySamp * 0.97f, c.cubic);
+        const float fbL = OnePole(dl, c.gapAlpha, lpStateL_);
+        const float fbR = OnePole(dr, c.gapAlpha, lpStateR_);
 
-        s_delayA.Write(satL + fbL * fb);
-        s_delayB.Write(satR + fbR * fb);
+        res_->delayA.Write(satL + fbL * c.fb);
+        res_->delayB.Write(satR + fbR * c.fb);
 
         outL = dl;
         outR = dr;
     }
 
 private:
+    static float BaseDelay(float flow)
+    {
+        return MapExpo(0.1f + std::clamp(flow, 0.0f, 1.0f) * 0.9f, 120.0f, 2000.0f);
+    }
+
     float sampleRate_ = 48000.0f;
     float lpStateL_ = 0.0f;
     float lpStateR_ = 0.0f;
     float phase_ = 0.0f;
 };
 
-class AlgoBgm
+class AlgoBgm : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        Ramp spin;
+        float az;
+        float elev;
+        float itdScale;
+        float distAlpha;
+    };
+
     void Init(float sampleRate)
     {
         sampleRate_ = sampleRate;
@@ -513,43 +778,57 @@ public:
         lpState_ = 0.0f;
     }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
+    {
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
+
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
     {
-        const float az = rt.c1 * 2.0f - 1.0f;
-        const float elev = rt.c2;
         const float dist = rt.c3;
-        const float spin = rt.c4 + rt.lfoValue * rt.lfoDepth * 0.7f;
+        Controls c;
+        c.spin.Set(rt.c4 + rt.lfoValue * rt.lfoDepth * 0.7f,
+                   rt.c4 + LfoAtBlockEnd(rt, n) * rt.lfoDepth * 0.7f,
+                   n);
+        c.az = rt.c1 * 2.0f - 1.0f;
+        c.elev = rt.c2;
+        c.itdScale = 20.0f + dist * 100.0f;
+        c.distAlpha = OnePoleAlpha(MapExpo(1.0f - dist, 200.0f, 14000.0f), sampleRate_);
+        return c;
+    }
 
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
+    {
+        const float spin = c.spin.Next();
         phase_ += (0.2f + spin * 2.0f) / sampleRate_;
         if (phase_ > 1.0f)
             phase_ -= 1.0f;
         const float spinPan = std::sin(phase_ * kTwoPi) * spin * 1.6f;
 
-        const float pan = std::clamp(az + spinPan, -1.0f, 1.0f);
-        const float itd = std::fabs(pan) * (20.0f + dist * 100.0f);
+        const float pan = std::clamp(c.az + spinPan, -1.0f, 1.0f);
+        const float itd = std::fabs(pan) * c.itdScale;
         const float leftGain = std::sqrt(0.5f * (1.0f - pan));
         const float rightGain = std::sqrt(0.5f * (1.0f + pan));
 
-        s_delayA.Write(inL);
-        s_delayB.Write(inR);
+        res_->delayA.Write(inL);
+        res_->delayB.Write(inR);
 
         float l = inL;
         float r = inR;
         if (pan > 0.0f)
         {
-            l = s_delayA.Read(1.0f + itd);
+            l = res_->delayA.Read(1.0f + itd);
         }
         else if (pan < 0.0f)
         {
-            r = s_delayB.Read(1.0f + itd);
+            r = res_->delayB.Read(1.0f + itd);
         }
 
-        const float cutoff = MapExpo(1.0f - dist, 200.0f, 14000.0f);
         const float mono = 0.5f * (l + r);
-        const float distant = OnePoleProcess(mono, cutoff, sampleRate_, lpState_);
+        const float distant = OnePole(mono, c.distAlpha, lpState_);
 
-        outL = (distant + (l - distant) * elev) * leftGain * 2.2f;
-        outR = (distant + (r - distant) * elev) * rightGain * 2.2f;
+        outL = (distant + (l - distant) * c.elev) * leftGain * 2.2f;
+        outR = (distant + (r - distant) * c.elev) * rightGain * 2.2f;
     }
 
 private:
@@ -558,35 +837,39 @@ private:
     float lpState_ = 0.0f;
 };
 
-class AlgoNff
+class AlgoNff : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        float noiseScale;
+        float airAlpha;
+        float airGain;
+    };
+
     void Init(float sampleRate)
     {
         sampleRate_ = sampleRate;
-        for (int i = 0; i < 3; ++i)
-        {
-            formL_[i].Init(sampleRate_);
-            formR_[i].Init(sampleRate_);
-            formL_[i].SetRes(2.0f);
-            formR_[i].SetRes(2.0f);
-        }
+        formants_.Init(sampleRate_, kFormants, 2);
+        formants_.SetDrive(kFormantDrive);
+        formants_.SetSmoothing(kFormantGlideSeconds);
         airStateL_ = 0.0f;
         airStateR_ = 0.0f;
     }
 
     void Reset()
     {
-        for (int i = 0; i < 3; ++i)
-        {
-            formL_[i].Init(sampleRate_);
-            formR_[i].Init(sampleRate_);
-        }
+        formants_.Reset();
         airStateL_ = 0.0f;
         airStateR_ = 0.0f;
     }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
+    {
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
+
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
     {
         const float vowel = rt.c1;
         const float art = rt.c2;
@@ -599,50 +882,67 @@ public:
         const float f2 = base * spread;
         const float f3 = base * (spread + 0.8f);
 
-        formL_[0].SetFreq(f1);
-        formL_[1].SetFreq(f2);
-        formL_[2].SetFreq(f3);
-
+        const float freqs[kFormants] = {f1, f2, f3};
         const float splitMul = 1.0f + breath * 0.9f;
-        formR_[0].SetFreq(f1 * splitMul);
-        formR_[1].SetFreq(f2 * splitMul);
-        formR_[2].SetFreq(f3 * splitMul);
+        for (int i = 0; i < kFormants; ++i)
+        {
+            formants_.SetFormant(0, i, freqs[i], kFormantRes, 1.0f);
+            formants_.SetFormant(1, i, freqs[i] * splitMul, kFormantRes, 1.0f);
+        }
+        formants_.Prepare(n);
 
-        const float noise = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * artic * 0.12f;
+        Controls c;
+        c.noiseScale = artic * 0.12f;
+        c.airAlpha = OnePoleAlpha(MapExpo(std::clamp(breath, 0.0f, 1.0f), 500.0f, 12000.0f), sampleRate_);
+        c.airGain = breath * 0.8f;
+        return c;
+    }
+
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
+    {
+        const float noise = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * c.noiseScale;
         const float nL = inL + noise;
         const float nR = inR + noise;
 
         float sumL = 0.0f;
         float sumR = 0.0f;
-        for (int i = 0; i < 3; ++i)
-        {
-            formL_[i].Process(nL);
-            formR_[i].Process(nR);
-            sumL += formL_[i].Band();
-            sumR += formR_[i].Band();
-        }
+        formants_.Process(nL, nR, sumL, sumR);
 
-        const float airCut = MapExpo(std::clamp(breath, 0.0f, 1.0f), 500.0f, 12000.0f);
-        const float lpL = OnePoleProcess(inL, airCut, sampleRate_, airStateL_);
-        const float lpR = OnePoleProcess(inR, airCut, sampleRate_, airStateR_);
-        const float airL = inL - lpL;
-        const float airR = inR - lpR;
+        const float airL = inL - OnePole(inL, c.airAlpha, airStateL_);
+        const float airR = inR - OnePole(inR, c.airAlpha, airStateR_);
 
-        outL = sumL * 0.6f + airL * (breath * 0.8f);
-        outR = sumR * 0.6f + airR * (breath * 0.8f);
+        outL = sumL * 0.6f + airL * c.airGain;
+        outR = sumR * 0.6f + airR * c.airGain;
     }
 
 private:
+    static constexpr int kFormants = 3;
+    // What the Svfs this replaced ran at: Reset() re-ran Svf::Init after
+    // Init's SetRes, leaving resonance at its default 0.5 and drive at 0.5.
+    static constexpr float kFormantRes = 0.5f;
+    static constexpr float kFormantDrive = 1.0f;
+    static constexpr float kFormantGlideSeconds = 0.005f;
+
     float sampleRate_ = 48000.0f;
-    daisysp::Svf formL_[3];
-    daisysp::Svf formR_[3];
+    FormantBank formants_;
     float airStateL_ = 0.0f;
     float airStateR_ = 0.0f;
 };
 
-class AlgoNdm
+class AlgoNdm : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        Ramp drift;
+        float modDepth;
+        float delayA;
+        float delayB;
+        float regen;
+        float tilt;
+        bool cubic;
+    };
+
     void Init(float sampleRate)
     {
         sampleRate_ = sampleRate;
@@ -653,29 +953,41 @@ public:
         phase_ = 0.0f;
     }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
+    {
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
+
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
     {
         const float spread = rt.c1;
-        const float color = rt.c2;
-        const float gran = rt.c3;
-        const float drift = rt.c4 + rt.lfoValue * rt.lfoDepth * 0.4f;
+        Controls c;
+        c.drift.Set(rt.c4 + rt.lfoValue * rt.lfoDepth * 0.4f,
+                    rt.c4 + LfoAtBlockEnd(rt, n) * rt.lfoDepth * 0.4f,
+                    n);
+        c.modDepth = 8.0f + spread * 40.0f;
+        c.delayA = 40.0f + spread * 220.0f;
+        c.delayB = 70.0f + spread * 300.0f;
+        c.regen = 0.25f + rt.c3 * 0.6f;
+        c.tilt = (rt.c2 - 0.5f) * 0.8f;
+        c.cubic = rt.cubicDelays;
+        return c;
+    }
 
-        phase_ += (0.1f + drift * 1.5f) / sampleRate_;
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
+    {
+        phase_ += (0.1f + c.drift.Next() * 1.5f) / sampleRate_;
         if (phase_ > 1.0f)
             phase_ -= 1.0f;
-        const float mod = std::sin(phase_ * kTwoPi) * (8.0f + spread * 40.0f);
+        const float mod = std::sin(phase_ * kTwoPi) * c.modDepth;
 
-        const float delayA = 40.0f + spread * 220.0f + mod;
-        const float delayB = 70.0f + spread * 300.0f - mod;
+        const float dl = res_->delayA.ReadSwept(c.delayA + mod, c.cubic);
+        const float dr = res_->delayB.ReadSwept(c.delayB - mod, c.cubic);
+        res_->delayA.Write(inL + dl * c.regen);
+        res_->delayB.Write(inR + dr * c.regen);
 
-        const float dl = s_delayA.Read(delayA);
-        const float dr = s_delayB.Read(delayB);
-        s_delayA.Write(inL + dl * (0.25f + gran * 0.6f));
-        s_delayB.Write(inR + dr * (0.25f + gran * 0.6f));
-
-        const float tilt = (color - 0.5f) * 0.8f;
-        outL = dl + inL * tilt;
-        outR = dr - inR * tilt;
+        outL = dl + inL * c.tilt;
+        outR = dr - inR * c.tilt;
     }
 
 private:
@@ -683,9 +995,19 @@ private:
     float phase_ = 0.0f;
 };
 
-class AlgoNes
+class AlgoNes : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        float attack;
+        float release;
+        float glue;
+        float compAmount;
+        float gain;
+        float bias;
+    };
+
     void Init(float sampleRate)
     {
         sampleRate_ = sampleRate;
@@ -693,30 +1015,41 @@ public:
     }
     void Reset() { envL_ = 0.0f; envR_ = 0.0f; }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
     {
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
+
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
+    {
+        (void)n;
         const float punch = std::clamp(rt.c1 * 2.0f, 0.0f, 1.0f);
-        const float glue = std::clamp(rt.c2 * 1.6f, 0.0f, 1.0f);
         const float lift = std::clamp(rt.c3 * 2.0f, 0.0f, 1.0f);
-        const float bias = rt.c4;
-
-        const float attack = 0.002f + (1.0f - punch) * 0.02f;
-        const float release = 0.01f + (1.0f - punch) * 0.12f;
-
-        envL_ += (std::fabs(inL) - envL_) * attack;
-        envR_ += (std::fabs(inR) - envR_) * attack;
-        envL_ += (std::fabs(inL) - envL_) * release;
-        envR_ += (std::fabs(inR) - envR_) * release;
 
-        const float env = Lerp(envL_, envR_, glue);
-        const float comp = 1.0f / (1.0f + env * (1.0f + punch * 18.0f));
-        const float liftGain = 1.0f + lift * 1.6f;
+        Controls c;
+        c.attack = 0.002f + (1.0f - punch) * 0.02f;
+        c.release = 0.01f + (1.0f - punch) * 0.12f;
+        c.glue = std::clamp(rt.c2 * 1.6f, 0.0f, 1.0f);
+        c.compAmount = 1.0f + punch * 18.0f;
+        c.gain = (1.0f + lift * 1.6f) * (1.0f + lift * 0.6f);
+        c.bias = rt.c4;
+        return c;
+    }
 
-        const float mixL = Lerp(inL, inR, bias);
-        const float mixR = Lerp(inR, inL, bias);
-        const float expand = 1.0f + lift * 0.6f;
-        outL = SoftClip(mixL * comp * liftGain * expand);
-        outR = SoftClip(mixR * comp * liftGain * expand);
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
+    {
+        envL_ += (std::fabs(inL) - envL_) * c.attack;
+        envR_ += (std::fabs(inR) - envR_) * c.attack;
+        envL_ += (std::fabs(inL) - envL_) * c.release;
+        envR_ += (std::fabs(inR) - envR_) * c.release;
+
+        const float env = Lerp(envL_, envR_, c.glue);
+        const float comp = 1.0f / (1.0f + env * c.compAmount);
+
+        const float mixL = Lerp(inL, inR, c.bias);
+        const float mixR = Lerp(inR, inL, c.bias);
+        outL = SoftClip(mixL * comp * c.gain);
+        outR = SoftClip(mixR * comp * c.gain);
     }
 
 private:
@@ -725,156 +1058,228 @@ private:
     float envR_ = 0.0f;
 };
 
-class AlgoNhc
+class AlgoNhc : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        float scale;
+        float inharm;
+        int period;
+        int width;
+        float fold;
+        float gain;
+    };
+
     void Init(float sampleRate)
     {
         (void)sampleRate;
+        for (size_t k = 0; k < kBins; ++k)
+        {
+            inharmTable_[k] = std::sin(k * 0.01f);
+        }
     }
 
     void Reset() { }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
     {
-        s_spectral.ProcessSample(inL, inR, outL, outR);
-        if (!s_spectral.ReadyForFrame())
-            return;
-
-        s_spectral.BuildSpectrum();
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
 
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
+    {
+        (void)n;
         const float stretch = rt.c1;
-        const float inh = rt.c2;
-        const float sparsity = rt.c3;
-        const float mirror = rt.c4;
+        Controls c;
+        c.scale = 0.6f + stretch * 1.8f;
+        c.inharm = rt.c2 * 0.18f;
+        c.period = 2 + static_cast<int>(rt.c3 * 24.0f);
+        c.width = std::max(1, c.period / 5);
+        c.fold = rt.c4 * 0.6f;
+        c.gain = 1.6f + stretch * 1.0f;
+        return c;
+    }
 
-        const float scale = 0.6f + stretch * 1.8f;
-        const float inharm = inh * 0.18f;
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
+    {
+        res_->spectral.ProcessSample(inL, inR, outL, outR);
+        if (res_->spectral.ReadyForFrame())
+        {
+            ProcessFrame(c);
+        }
+    }
 
+private:
+    void ProcessFrame(const Controls &c)
+    {
+        SpectralStereo &spec = res_->spectral;
+        spec.BuildSpectrum();
+
+        // The stretch can be above or below 1, so no walking order makes an
+        // in-place remap safe. Read from the FFT buffers instead: they hold
+        // the same analysis bins until InverseToOutput() overwrites them.
+        const float *srcRe[2] = {spec.fftRe[0], spec.fftRe[1]};
+        const float *srcIm[2] = {spec.fftIm[0], spec.fftIm[1]};
         for (size_t k = 0; k < kBins; ++k)
         {
-            const float src = static_cast<float>(k) * (scale + std::sin(k * 0.01f) * inharm);
+            const float src = static_cast<float>(k) * (c.scale + inharmTable_[k] * c.inharm);
             if (src >= static_cast<float>(kBins - 1))
             {
-                s_spectral.re[0][k] = 0.0f;
-                s_spectral.im[0][k] = 0.0f;
-                s_spectral.re[1][k] = 0.0f;
-                s_spectral.im[1][k] = 0.0f;
+                spec.re[0][k] = 0.0f;
+                spec.im[0][k] = 0.0f;
+                spec.re[1][k] = 0.0f;
+                spec.im[1][k] = 0.0f;
                 continue;
             }
             const size_t i0 = static_cast<size_t>(src);
             const size_t i1 = i0 + 1;
             const float frac = src - static_cast<float>(i0);
 
-            const float reL = s_spectral.re[0][i0] + (s_spectral.re[0][i1] - s_spectral.re[0][i0]) * frac;
-            const float imL = s_spectral.im[0][i0] + (s_spectral.im[0][i1] - s_spectral.im[0][i0]) * frac;
-            const float reR = s_spectral.re[1][i0] + (s_spectral.re[1][i1] - s_spectral.re[1][i0]) * frac;
-            const float imR = s_spectral.im[1][i0] + (s_spectral.im[1][i1] - s_spectral.im[1][i0]) * frac;
-
-            const int period = 2 + static_cast<int>(sparsity * 24.0f);
-            const int width = std::max(1, period / 5);
-            const int slot = static_cast<int>(k) % period;
-            const float gate = (slot < width) ? 1.0f : 0.35f;
-            s_spectral.re[0][k] = reL * gate;
-            s_spectral.im[0][k] = imL * gate;
-            s_spectral.re[1][k] = reR * gate;
-            s_spectral.im[1][k] = imR * gate;
+            const float reL = srcRe[0][i0] + (srcRe[0][i1] - srcRe[0][i0]) * frac;
+            const float imL = srcIm[0][i0] + (srcIm[0][i1] - srcIm[0][i0]) * frac;
+            const float reR = srcRe[1][i0] + (srcRe[1][i1] - srcRe[1][i0]) * frac;
+            const float imR = srcIm[1][i0] + (srcIm[1][i1] - srcIm[1][i0]) * frac;
+
+            const int slot = static_cast<int>(k) % c.period;
+            const float gate = (slot < c.width) ? 1.0f : 0.35f;
+            spec.re[0][k] = reL * gate;
+            spec.im[0][k] = imL * gate;
+            spec.re[1][k] = reR * gate;
+            spec.im[1][k] = imR * gate;
         }
 
-        if (mirror > 0.0f)
+        if (c.fold > 0.0f)
         {
             const size_t mid = kBins / 2;
             for (size_t k = mid; k < kBins; ++k)
             {
                 const size_t mirrorBin = kBins - 1 - k;
-                const float fold = mirror * 0.6f;
-                s_spectral.re[0][mirrorBin] += s_spectral.re[0][k] * fold;
-                s_spectral.im[0][mirrorBin] -= s_spectral.im[0][k] * fold;
-                s_spectral.re[1][mirrorBin] += s_spectral.re[1][k] * fold;
-                s_spectral.im[1][mirrorBin] -= s_spectral.im[1][k] * fold;
+                spec.re[0][mirrorBin] += spec.re[0][k] * c.fold;
+                spec.im[0][mirrorBin] -= spec.im[0][k] * c.fold;
+                spec.re[1][mirrorBin] += spec.re[1][k] * c.fold;
+                spec.im[1][mirrorBin] -= spec.im[1][k] * c.fold;
             }
         }
 
-        const float gain = 1.6f + stretch * 1.0f;
         for (size_t k = 0; k < kBins; ++k)
         {
-            s_spectral.re[0][k] *= gain;
-            s_spectral.im[0][k] *= gain;
-            s_spectral.re[1][k] *= gain;
-            s_spectral.im[1][k] *= gain;
+            spec.re[0][k] *= c.gain;
+            spec.im[0][k] *= c.gain;
+            spec.re[1][k] *= c.gain;
+            spec.im[1][k] *= c.gain;
         }
 
-        s_spectral.InverseToOutput();
+        spec.InverseToOutput();
     }
 
-private:
-    int unused_ = 0;
+    float inharmTable_[kBins]{};
 };
 
-class AlgoNpl
+class AlgoNpl : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        float bind;
+        Ramp swirl;
+        float tilt;
+        float stereo;
+    };
+
     void Init(float sampleRate)
     {
         (void)sampleRate;
+        for (size_t k = 0; k < kBins; ++k)
+        {
+            swirlTable_[k] = std::sin(k * 0.02f) * 8.0f;
+        }
     }
 
     void Reset() { }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
     {
-        s_spectral.ProcessSample(inL, inR, outL, outR);
-        if (!s_spectral.ReadyForFrame())
-            return;
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
 
-        s_spectral.BuildSpectrum();
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
+    {
+        Controls c;
+        c.bind = std::clamp(rt.c1 * 3.0f, 0.0f, 1.0f);
+        c.swirl.Set(rt.c2 * 4.0f + rt.lfoValue * rt.lfoDepth * 1.6f,
+                    rt.c2 * 4.0f + LfoAtBlockEnd(rt, n) * rt.lfoDepth * 1.6f,
+                    n);
+        c.tilt = std::clamp(rt.c3 * 4.0f, 0.0f, 1.0f);
+        c.stereo = rt.c4;
+        return c;
+    }
 
-        const float bind = std::clamp(rt.c1 * 3.0f, 0.0f, 1.0f);
-        const float swirl = std::clamp(rt.c2 * 4.0f + rt.lfoValue * rt.lfoDepth * 1.6f, 0.0f, 1.0f);
-        const float tilt = std::clamp(rt.c3 * 4.0f, 0.0f, 1.0f);
-        const float stereo = rt.c4;
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
+    {
+        const float swirl = c.swirl.Next();
+        res_->spectral.ProcessSample(inL, inR, outL, outR);
+        if (res_->spectral.ReadyForFrame())
+        {
+            ProcessFrame(c, std::clamp(swirl, 0.0f, 1.0f));
+        }
+    }
+
+private:
+    void ProcessFrame(const Controls &c, float swirl)
+    {
+        SpectralStereo &spec = res_->spectral;
+        spec.BuildSpectrum();
 
+        const float warpScale = c.tilt * 3.0f / static_cast<float>(kBins);
         for (size_t k = 1; k < kBins - 1; ++k)
         {
-            const float reL = s_spectral.re[0][k];
-            const float imL = s_spectral.im[0][k];
-            const float reR = s_spectral.re[1][k];
-            const float imR = s_spectral.im[1][k];
+            const float reL = spec.re[0][k];
+            const float imL = spec.im[0][k];
+            const float reR = spec.re[1][k];
+            const float imR = spec.im[1][k];
 
             const float magL = std::sqrt(reL * reL + imL * imL);
             const float magR = std::sqrt(reR * reR + imR * imR);
             const float phaseL = std::atan2(imL, reL);
             const float phaseR = std::atan2(imR, reR);
 
-            const float warp = (static_cast<float>(k) / static_cast<float>(kBins)) * tilt * 3.0f;
-            const float swirlPhase = std::sin(k * 0.02f) * swirl * 8.0f;
+            const float warp = static_cast<float>(k) * warpScale;
+            const float swirlPhase = swirlTable_[k] * swirl;
 
             const float phaseLNew = phaseL + swirlPhase + warp;
             const float phaseRNew = phaseR - swirlPhase - warp;
 
-            const float linkL = phaseLNew + ShortestPhaseDelta(phaseLNew, phaseRNew) * bind;
-            const float linkR = phaseRNew + ShortestPhaseDelta(phaseRNew, phaseLNew) * bind;
+            const float linkL = phaseLNew + ShortestPhaseDelta(phaseLNew, phaseRNew) * c.bind;
+            const float linkR = phaseRNew + ShortestPhaseDelta(phaseRNew, phaseLNew) * c.bind;
 
-            s_spectral.re[0][k] = magL * std::cos(linkL);
-            s_spectral.im[0][k] = magL * std::sin(linkL);
-            s_spectral.re[1][k] = magR * std::cos(linkR);
-            s_spectral.im[1][k] = magR * std::sin(linkR);
+            spec.re[0][k] = magL * std::cos(linkL);
+            spec.im[0][k] = magL * std::sin(linkL);
+            spec.re[1][k] = magR * std::cos(linkR);
+            spec.im[1][k] = magR * std::sin(linkR);
         }
 
-        const float widen = 1.0f + stereo * 1.1f;
-        s_spectral.re[0][0] *= widen;
-        s_spectral.re[1][0] *= 1.0f - stereo * 0.6f;
+        spec.re[0][0] *= 1.0f + c.stereo * 1.1f;
+        spec.re[1][0] *= 1.0f - c.stereo * 0.6f;
 
-        s_spectral.InverseToOutput();
+        spec.InverseToOutput();
     }
 
-private:
-    int unused_ = 0;
+    float swirlTable_[kBins]{};
 };
 
-class AlgoNmg
+class AlgoNmg : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        Ramp drift;
+        int grainSize;
+        float windowStep;
+        float blend;
+        float scatter;
+    };
+
     void Init(float sampleRate)
     {
         sampleRate_ = sampleRate;
@@ -887,36 +1292,46 @@ public:
         holdSampleR_ = 0.0f;
     }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
+    {
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
+
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
     {
-        const float size = rt.c1;
-        const float drift = rt.c2 + rt.lfoValue * rt.lfoDepth * 0.4f;
-        const float blend = rt.c3;
-        const float scatter = rt.c4;
+        Controls c;
+        c.drift.Set(rt.c2 + rt.lfoValue * rt.lfoDepth * 0.4f,
+                    rt.c2 + LfoAtBlockEnd(rt, n) * rt.lfoDepth * 0.4f,
+                    n);
+        c.grainSize = 20 + static_cast<int>(rt.c1 * 300.0f);
+        c.windowStep = 1.0f / static_cast<float>(std::max(1, c.grainSize));
+        c.blend = rt.c3;
+        c.scatter = rt.c4;
+        return c;
+    }
 
-        const int grainSize = 20 + static_cast<int>(size * 300.0f);
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
+    {
+        const float drift = c.drift.Next();
         if (hold_ <= 0)
         {
-            hold_ = grainSize;
+            hold_ = c.grainSize;
             const float driftAmt = std::clamp(drift, -1.0f, 1.0f);
             const float jitter = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * driftAmt * 40.0f;
-            holdSampleL_ = s_delayA.Read(10.0f + scatter * 80.0f + jitter);
-            holdSampleR_ = s_delayB.Read(10.0f + (1.0f - scatter) * 80.0f - jitter);
+            holdSampleL_ = res_->delayA.Read(10.0f + c.scatter * 80.0f + jitter);
+            holdSampleR_ = res_->delayB.Read(10.0f + (1.0f - c.scatter) * 80.0f - jitter);
             holdWindow_ = 0.0f;
         }
         hold_--;
 
-        s_delayA.Write(inL);
-        s_delayB.Write(inR);
+        res_->delayA.Write(inL);
+        res_->delayB.Write(inR);
 
-        holdWindow_ += 1.0f / std::max(1, grainSize);
+        holdWindow_ += c.windowStep;
         const float win = 0.5f - 0.5f * std::cos(kTwoPi * std::clamp(holdWindow_, 0.0f, 1.0f));
 
-        const float grainL = holdSampleL_ * win;
-        const float grainR = holdSampleR_ * win;
-
-        outL = Lerp(inL, grainL, blend);
-        outR = Lerp(inR, grainR, blend);
+        outL = Lerp(inL, holdSampleL_ * win, c.blend);
+        outR = Lerp(inR, holdSampleR_ * win, c.blend);
     }
 
 private:
@@ -927,61 +1342,69 @@ private:
     float holdWindow_ = 0.0f;
 };
 
-class AlgoNsm
+class AlgoNsm : public AlgoBase
 {
 public:
+    struct Controls
+    {
+        Ramp a;
+        int poles;
+        float fb;
+    };
+
     void Init(float sampleRate) { sampleRate_ = sampleRate; }
 
     void Reset()
     {
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            for (int i = 0; i < kMaxPoles; ++i)
-            {
-                x1_[ch][i] = 0.0f;
-                y1_[ch][i] = 0.0f;
-            }
-            fbState_[ch] = 0.0f;
-        }
+        cascade_.Reset();
+        fbStateL_ = 0.0f;
+        fbStateR_ = 0.0f;
     }
 
-    void Process(float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+    void ProcessBlock(const float *inL, const float *inR, float *outL, float *outR, size_t n, const NeuroticRuntime &rt)
     {
-        const float lfo = rt.lfoValue * rt.lfoDepth * 0.35f;
-        const float freqControl = std::clamp(rt.c1 + lfo, 0.0f, 1.0f);
-        const float freqHz = MapPitch(freqControl, 28.0f, 122.0f);
-        const float g = std::tan(kPi * freqHz / sampleRate_);
-        float a = (1.0f - g) / (1.0f + g);
-        const float res = 0.2f + rt.c2 * 0.78f;
-        a = std::clamp(a * res, -0.98f, 0.98f);
-
-        const int poles = 2 + static_cast<int>(rt.c3 * 126.0f + 0.5f);
-        const float fb = std::clamp(rt.c4, 0.0f, 0.95f);
-
-        float in[2] = {inL + fbState_[0] * fb, inR + fbState_[1] * fb};
-        float out[2] = {0.0f, 0.0f};
+        RunBlock(*this, inL, inR, outL, outR, n, rt);
+    }
 
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            float x = in[ch];
-            for (int i = 0; i < poles; ++i)
-            {
-                x = Allpass(x, a, x1_[ch][i], y1_[ch][i]);
-            }
-            out[ch] = x;
-            fbState_[ch] = x;
-        }
+    Controls Prepare(const NeuroticRuntime &rt, size_t n)
+    {
+        // The coefficient needs a pitch map and a tan(); evaluate it at the
+        // block edges and ramp in between.
+        const float res = 0.2f + rt.c2 * 0.78f;
+        Controls c;
+        c.a.Set(Coefficient(rt.c1 + rt.lfoValue * rt.lfoDepth * 0.35f, res),
+                Coefficient(rt.c1 + LfoAtBlockEnd(rt, n) * rt.lfoDepth * 0.35f, res),
+                n);
+        c.poles = 2 + static_cast<int>(rt.c3 * (AllpassCascade::kMaxPoles - 2) + 0.5f);
+        c.fb = std::clamp(rt.c4, 0.0f, 0.95f);
+        return c;
+    }
 
-        outL = SoftClip(out[0]);
-        outR = SoftClip(out[1]);
+    void Tick(float inL, float inR, Controls &c, float &outL, float &outR)
+    {
+        float l = inL + fbStateL_ * c.fb;
+        float r = inR + fbStateR_ * c.fb;
+        cascade_.Process(l, r, c.a.Next(), c.poles);
+        fbStateL_ = l;
+        fbStateR_ = r;
+
+        outL = SoftClip(l);
+        outR = SoftClip(r);
     }
 
 private:
-    static constexpr int kMaxPoles = 128;
+    float Coefficient(float freqControl, float res) const
+    {
+        const float freqHz = MapPitch(std::clamp(freqControl, 0.0f, 1.0f), 28.0f, 122.0f);
+        const float g = std::tan(kPi * freqHz / sampleRate_);
+        const float a = (1.0f - g) / (1.0f + g);
+        return std::clamp(a * res, -0.98f, 0.98f);
+    }
+
     float sampleRate_ = 48000.0f;
-    float x1_[2][kMaxPoles];
-    float y1_[2][kMaxPoles];
-    float fbState_[2];
+    AllpassCascade cascade_;
+    float fbStateL_ = 0.0f;
+    float fbStateR_ = 0.0f;
 };
 
 static AlgoNcr s_algoNcr;
@@ -996,122 +1419,253 @@ static AlgoNpl s_algoNpl;
 static AlgoNmg s_algoNmg;
 static AlgoNsm s_algoNsm;
 
-void NeuroticAlgoBank::Init(float sampleRate)
+namespace
 {
-    sampleRate_ = sampleRate;
-    s_spectral.Init();
-    s_delayA.Reset();
-    s_delayB.Reset();
-    ncr_ = &s_algoNcr;
-    lsb_ = &s_algoLsb;
-    nth_ = &s_algoNth;
-    bgm_ = &s_algoBgm;
-    nff_ = &s_algoNff;
-    ndm_ = &s_algoNdm;
-    nes_ = &s_algoNes;
-    nhc_ = &s_algoNhc;
-    npl_ = &s_algoNpl;
-    nmg_ = &s_algoNmg;
-    nsm_ = &s_algoNsm;
-
-    ncr_->Init(sampleRate_);
-    lsb_->Init(sampleRate_);
-    nth_->Init(sampleRate_);
-    bgm_->Init(sampleRate_);
-    nff_->Init(sampleRate_);
-    ndm_->Init(sampleRate_);
-    nes_->Init(sampleRate_);
-    nhc_->Init(sampleRate_);
-    npl_->Init(sampleRate_);
-    nmg_->Init(sampleRate_);
-    nsm_->Init(sampleRate_);
+constexpr float kPairLoadBudget = 0.85f;   // Max combined load for a concurrent crossfade
+constexpr float kUnmeasuredLoad = 0.4f;    // Assumed load until an algorithm has run solo
+constexpr float kLoadDecay = 0.995f;       // Per-block decay of the held peak load
+constexpr float kShortFadeSeconds = 0.005f;
 }
 
-void NeuroticAlgoBank::Reset(int algoIndex)
+template <typename Fn>
+void NeuroticAlgoBank::Visit(int algoIndex, Fn &&fn)
 {
-    s_spectral.Reset();
-    s_delayA.Reset();
-    s_delayB.Reset();
     switch (algoIndex)
     {
     case 0:
-        ncr_->Reset();
+        fn(*ncr_);
         break;
     case 1:
-        lsb_->Reset();
+        fn(*lsb_);
         break;
     case 2:
-        nth_->Reset();
+        fn(*nth_);
         break;
     case 3:
-        bgm_->Reset();
+        fn(*bgm_);
         break;
     case 4:
-        nff_->Reset();
+        fn(*nff_);
         break;
     case 5:
-        ndm_->Reset();
+        fn(*ndm_);
         break;
     case 6:
-        nes_->Reset();
+        fn(*nes_);
         break;
     case 7:
-        nhc_->Reset();
+        fn(*nhc_);
         break;
     case 8:
-        npl_->Reset();
+        fn(*npl_);
         break;
     case 9:
-        nmg_->Reset();
+        fn(*nmg_);
         break;
     case 10:
-        nsm_->Reset();
+        fn(*nsm_);
         break;
     default:
         break;
     }
 }
 
-void NeuroticAlgoBank::Process(int algoIndex, float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR)
+void NeuroticAlgoBank::Init(float sampleRate)
 {
-    switch (algoIndex)
+    sampleRate_ = sampleRate;
+    s_resources[0].Init();
+    s_resources[1].Init();
+    ncr_ = &s_algoNcr;
+    lsb_ = &s_algoLsb;
+    nth_ = &s_algoNth;
+    bgm_ = &s_algoBgm;
+    nff_ = &s_algoNff;
+    ndm_ = &s_algoNdm;
+    nes_ = &s_algoNes;
+    nhc_ = &s_algoNhc;
+    npl_ = &s_algoNpl;
+    nmg_ = &s_algoNmg;
+    nsm_ = &s_algoNsm;
+
+    for (int i = 0; i < kNumAlgos; ++i)
     {
-    case 0:
-        ncr_->Process(inL, inR, rt, outL, outR);
-        break;
-    case 1:
-        lsb_->Process(inL, inR, rt, outL, outR);
-        break;
-    case 2:
-        nth_->Process(inL, inR, rt, outL, outR);
-        break;
-    case 3:
-        bgm_->Process(inL, inR, rt, outL, outR);
-        break;
-    case 4:
-        nff_->Process(inL, inR, rt, outL, outR);
-        break;
-    case 5:
-        ndm_->Process(inL, inR, rt, outL, outR);
-        break;
-    case 6:
-        nes_->Process(inL, inR, rt, outL, outR);
-        break;
-    case 7:
-        nhc_->Process(inL, inR, rt, outL, outR);
-        break;
-    case 8:
-        npl_->Process(inL, inR, rt, outL, outR);
-        break;
-    case 9:
-        nmg_->Process(inL, inR, rt, outL, outR);
-        break;
-    case 10:
-        nsm_->Process(inL, inR, rt, outL, outR);
-        break;
-    default:
-        outL = inL;
-        outR = inR;
-        break;
+        Visit(i, [this](auto &algo) { algo.Init(sampleRate_); });
+        algoLoad_[i] = kUnmeasuredLoad;
+    }
+    Reset(0);
+}
+
+void NeuroticAlgoBank::Reset(int algoIndex)
+{
+    active_ = std::clamp(algoIndex, 0, kNumAlgos - 1);
+    requested_ = active_;
+    incoming_ = -1;
+    fadeMode_ = FadeMode::None;
+    fadePos_ = 0.0f;
+
+    clearing_ = false;
+    for (AlgoResources &set : s_resources)
+    {
+        size_t cursor = 0;
+        set.Rewind();
+        set.Clear(cursor, static_cast<size_t>(-1));
+    }
+    AlgoResources &res = s_resources[activeRes_];
+    Visit(active_, [&res](auto &algo) {
+        algo.Bind(&res);
+        algo.Reset();
+        algo.ResetFeedback();
+    });
+}
+
+void NeuroticAlgoBank::SetCrossfadeTime(float seconds)
+{
+    crossfadeSeconds_ = std::max(seconds, 0.0f);
+}
+
+void NeuroticAlgoBank::Select(int algoIndex)
+{
+    requested_ = std::clamp(algoIndex, 0, kNumAlgos - 1);
+}
+
+void NeuroticAlgoBank::Service(size_t maxClearSamples)
+{
+    if (clearing_)
+    {
+        clearing_ = !s_resources[1 - activeRes_].Clear(clearCursor_, maxClearSamples);
+    }
+    if (fadeMode_ == FadeMode::None && !clearing_ && requested_ != active_)
+    {
+        StartFade(requested_);
+    }
+}
+
+void NeuroticAlgoBank::ReportLoad(float load)
+{
+    // Only a solo block says anything about one algorithm's cost. Hold the
+    // peak since spectral algorithms spike on frame boundaries.
+    if (fadeMode_ == FadeMode::None)
+    {
+        algoLoad_[active_] = std::max(load, algoLoad_[active_] * kLoadDecay);
+    }
+}
+
+void NeuroticAlgoBank::StartFade(int algoIndex)
+{
+    incoming_ = algoIndex;
+    AlgoResources &res = s_resources[1 - activeRes_];
+    res.Rewind();
+    Visit(incoming_, [&res](auto &algo) {
+        algo.Bind(&res);
+        algo.Reset();
+        algo.ResetFeedback();
+    });
+
+    // Run both algorithms together only if the pair fits the callback budget;
+    // otherwise fade out then in quickly so they never overlap.
+    const bool fits = algoLoad_[active_] + algoLoad_[incoming_] <= kPairLoadBudget;
+    const float seconds = fits ? crossfadeSeconds_ : kShortFadeSeconds;
+    fadeMode_ = fits ? FadeMode::Crossfade : FadeMode::Sequential;
+    fadeStep_ = std::min(1.0f / (std::max(seconds, 1.0e-6f) * sampleRate_), 1.0f);
+    fadePos_ = 0.0f;
+}
+
+void NeuroticAlgoBank::ReleaseActive()
+{
+    s_resources[activeRes_].Rewind();
+    clearCursor_ = 0;
+    clearing_ = true;
+    activeRes_ = 1 - activeRes_;
+    active_ = incoming_;
+    incoming_ = -1;
+}
+
+size_t NeuroticAlgoBank::FadeChunk(size_t n) const
+{
+    if (fadeMode_ == FadeMode::None)
+    {
+        return n;
+    }
+    // End the chunk on the sample where the fade reaches its next stage so
+    // the handover lands exactly where a per-sample loop would put it.
+    const float target = (fadeMode_ == FadeMode::Sequential && incoming_ < 0) ? 2.0f : 1.0f;
+    const float left = std::ceil((target - fadePos_) / fadeStep_);
+    return std::min(n, static_cast<size_t>(std::max(left, 1.0f)));
+}
+
+void NeuroticAlgoBank::ProcessBlock(const float *inL,
+                                    const float *inR,
+                                    float *outL,
+                                    float *outR,
+                                    size_t size,
+                                    const NeuroticRuntime &rt)
+{
+    size_t done = 0;
+    while (done < size)
+    {
+        const size_t n = FadeChunk(std::min(size - done, kMaxBlock));
+        NeuroticRuntime local = rt;
+        local.lfoValue = rt.lfoValue + rt.lfoStep * static_cast<float>(done);
+        ProcessChunk(inL + done, inR + done, outL + done, outR + done, n, local);
+        done += n;
+    }
+}
+
+void NeuroticAlgoBank::ProcessChunk(const float *inL,
+                                    const float *inR,
+                                    float *outL,
+                                    float *outR,
+                                    size_t n,
+                                    const NeuroticRuntime &rt)
+{
+    const auto run = [&](int algoIndex, float *l, float *r) {
+        Visit(algoIndex, [&](auto &algo) { algo.ProcessBlock(inL, inR, l, r, n, rt); });
+    };
+
+    if (fadeMode_ == FadeMode::None)
+    {
+        run(active_, outL, outR);
+        return;
+    }
+
+    if (fadeMode_ == FadeMode::Crossfade)
+    {
+        run(active_, outL, outR);
+        run(incoming_, fadeL_, fadeR_);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            fadePos_ = std::min(fadePos_ + fadeStep_, 1.0f);
+            const float gainIn = std::sqrt(fadePos_);
+            const float gainOut = std::sqrt(1.0f - fadePos_);
+            outL[i] = outL[i] * gainOut + fadeL_[i] * gainIn;
+            outR[i] = outR[i] * gainOut + fadeR_[i] * gainIn;
+        }
+        if (fadePos_ >= 1.0f)
+        {
+            ReleaseActive();
+            fadeMode_ = FadeMode::None;
+        }
+        return;
+    }
+
+    // Sequential: fadePos_ runs 0..1 fading the old algorithm out, then 1..2
+    // fading the new one in.
+    run(active_, outL, outR);
+    const bool fadingOut = incoming_ >= 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const float gain = fadingOut ? 1.0f - fadePos_ : fadePos_ - 1.0f;
+        outL[i] *= gain;
+        outR[i] *= gain;
+        fadePos_ += fadeStep_;
+    }
+    if (incoming_ >= 0 && fadePos_ >= 1.0f)
+    {
+        ReleaseActive();
+    }
+    else if (incoming_ < 0 && fadePos_ >= 2.0f)
+    {
+        fadeMode_ = FadeMode::None;
     }
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 #include "daisysp.h"
 #include "neurotic_state.h"
 
@@ -18,12 +20,72 @@ class AlgoNsm;
 class NeuroticAlgoBank
 {
 public:
+    static constexpr int kNumAlgos = 11;
+    static constexpr size_t kMaxBlock = 64;
+
     void Init(float sampleRate);
+    // Immediately make algoIndex the only running algorithm with clean state.
     void Reset(int algoIndex);
-    void Process(int algoIndex, float inL, float inR, const NeuroticRuntime &rt, float &outL, float &outR);
+
+    // Switching is driven from the audio callback: Select() requests an
+    // algorithm, Service() runs once per block to clear released buffers
+    // (at most maxClearSamples) and start fades, and ProcessBlock() runs the
+    // active algorithm plus the incoming one while they crossfade.
+    void SetCrossfadeTime(float seconds);
+    void Select(int algoIndex);
+    void Service(size_t maxClearSamples);
+    // Measured load (0..1 of the block period) of the last callback, used to
+    // decide whether two algorithms can run side by side.
+    void ReportLoad(float load);
+    // Wet output only; out must not alias in. The algorithm is dispatched once
+    // per chunk of up to kMaxBlock samples, and control-rate values are
+    // computed once per chunk. rt.lfoValue is the LFO at the first sample and
+    // rt.lfoStep its per-sample slope across the block.
+    void ProcessBlock(const float *inL,
+                      const float *inR,
+                      float *outL,
+                      float *outR,
+                      size_t size,
+                      const NeuroticRuntime &rt);
+
+    int ActiveAlgo() const { return active_; }
+    bool Switching() const { return fadeMode_ != FadeMode::None || clearing_ || requested_ != active_; }
 
 private:
+    enum class FadeMode
+    {
+        None,
+        Crossfade,
+        Sequential
+    };
+
+    template <typename Fn>
+    void Visit(int algoIndex, Fn &&fn);
+    void StartFade(int algoIndex);
+    void ReleaseActive();
+    size_t FadeChunk(size_t n) const;
+    void ProcessChunk(const float *inL,
+                      const float *inR,
+                      float *outL,
+                      float *outR,
+                      size_t n,
+                      const NeuroticRuntime &rt);
+
     float sampleRate_ = 48000.0f;
+    float crossfadeSeconds_ = 0.05f;
+
+    int active_ = 0;
+    int activeRes_ = 0;
+    int incoming_ = -1;
+    int requested_ = 0;
+    FadeMode fadeMode_ = FadeMode::None;
+    float fadePos_ = 0.0f;
+    float fadeStep_ = 1.0f;
+    bool clearing_ = false;
+    size_t clearCursor_ = 0;
+    float algoLoad_[kNumAlgos]{};
+    float fadeL_[kMaxBlock]{};
+    float fadeR_[kMaxBlock]{};
 
     AlgoNcr *ncr_ = nullptr;
     AlgoLsb *lsb_ = nullptr;
@@ -7,6 +7,8 @@ void NeuroticApp::Init()
 
     const float sampleRate = hw_.AudioSampleRate();
     dsp_.Init(sampleRate);
+    ticksToLoad_ = sampleRate / static_cast<float>(daisy::System::GetTickFreq());
+    scheduler_.Init(sampleRate, daisy::System::GetTickFreq());
     ui_.Init(hw_, state_);
 
     lastHeartbeatMs_ = daisy::System::GetNow();
@@ -17,10 +19,10 @@ void NeuroticApp::StartAudio(daisy::AudioHandle::AudioCallback cb)
     hw_.StartAudio(cb);
 }
 
+// Main loop: the encoder and menu, then the display when a frame is due.
+// Knobs and CV are read by ControlTick().
 void NeuroticApp::Update()
 {
-    hw_.ProcessAnalogControls();
-    params_.Update(hw_, state_, runtime_);
     ui_.Update(hw_, state_);
 
     const uint32_t now = daisy::System::GetNow();
@@ -30,12 +32,29 @@ void NeuroticApp::Update()
         lastHeartbeatMs_ = now;
     }
 
-    ui_.RenderIfNeeded(hw_, state_, heartbeatOn_, now);
+    if (scheduler_.UiDue(daisy::System::GetTick()))
+    {
+        ui_.Render(hw_, state_, heartbeatOn_);
+    }
+}
+
+// Audio callback, at the control rate.
+void NeuroticApp::ControlTick()
+{
+    hw_.ProcessAnalogControls();
+    params_.Update(hw_, state_, runtime_);
 }
 
 void NeuroticApp::ProcessAudio(daisy::AudioHandle::InputBuffer in,
                                daisy::AudioHandle::OutputBuffer out,
                                size_t size)
 {
+    const uint32_t start = daisy::System::GetTick();
+    for (size_t ticks = scheduler_.BeginBlock(size, start); ticks > 0; --ticks)
+    {
+        ControlTick();
+    }
     dsp_.Process(in, out, size, runtime_);
+    const uint32_t ticks = daisy::System::GetTick() - start;
+    dsp_.ReportLoad(static_cast<float>(ticks) * ticksToLoad_ / static_cast<float>(size));
 }
@@ -3,6 +3,7 @@
 #include "daisy_seed.h"
 #include "kxmx_bluemchen.h"
 
+#include "control_scheduler.h"
 #include "neurotic_dsp.h"
 #include "neurotic_params.h"
 #include "neurotic_ui.h"
@@ -19,13 +20,17 @@ public:
                       size_t size);
 
 private:
+    void ControlTick();
+
     kxmx::Bluemchen hw_{};
     NeuroticState state_{};
     NeuroticRuntime runtime_{};
     NeuroticParams params_{};
     NeuroticUi ui_{};
     NeuroticDsp dsp_{};
+    ControlScheduler scheduler_{};
 
+    float ticksToLoad_ = 0.0f;
     bool heartbeatOn_ = false;
     uint32_t lastHeartbeatMs_ = 0;
 };
@@ -1,58 +1,58 @@
 #include "neurotic_dsp.h"
 
 #include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Released buffers zeroed per callback after a switch; a full set is ~26k
+// floats, so it is clean again within a handful of callbacks.
+constexpr size_t kClearSamplesPerBlock = 4096;
+constexpr float kTwoPi = 2.0f * 3.14159265358979323846f;
+}
 
 void NeuroticDsp::Init(float sampleRate)
 {
     sampleRate_ = sampleRate;
     algos_.Init(sampleRate_);
-    currentAlgo_ = 0;
     lfoPhase_ = 0.0f;
-    fbStateL_ = 0.0f;
-    fbStateR_ = 0.0f;
 }
 
-void NeuroticDsp::Process(daisy::AudioHandle::InputBuffer in,
-                          daisy::AudioHandle::OutputBuffer out,
+void NeuroticDsp::ReportLoad(float load)
+{
+    algos_.ReportLoad(load);
+}
+
+void NeuroticDsp::Process(const float *const *in,
+                          float **out,
                           size_t size,
                           const NeuroticRuntime &runtime)
 {
-    if (runtime.algoIndex != currentAlgo_)
-    {
-        currentAlgo_ = std::clamp(runtime.algoIndex, 0, 10);
-        algos_.Reset(currentAlgo_);
-    }
+    algos_.SetCrossfadeTime(runtime.crossfadeSeconds);
+    algos_.Select(runtime.algoIndex);
+    algos_.Service(kClearSamplesPerBlock);
 
     const float mix = std::clamp(runtime.mix, 0.0f, 1.0f);
     const float dryMix = 1.0f - mix;
     const float wetMix = mix;
     const float trim = std::clamp(runtime.outTrim, 0.0f, 2.0f);
-    const float fb = std::clamp(runtime.fb, 0.0f, 0.98f);
     const float lfoHz = 0.1f + runtime.lfoRate * 9.8f;
-    const float lfoInc = (2.0f * 3.14159265358979323846f) * lfoHz / sampleRate_;
+    const float lfoInc = kTwoPi * lfoHz / sampleRate_;
 
-    for (size_t i = 0; i < size; ++i)
-    {
-        const float inL = in[0][i];
-        const float inR = in[1][i];
-        const float feedL = inL + fbStateL_ * fb;
-        const float feedR = inR + fbStateR_ * fb;
-
-        lfoPhase_ += lfoInc;
-        if (lfoPhase_ > 2.0f * 3.14159265358979323846f)
-            lfoPhase_ -= 2.0f * 3.14159265358979323846f;
-
-        NeuroticRuntime local = runtime;
-        local.lfoValue = std::sin(lfoPhase_);
+    // The LFO only moves control-rate values, so sample it at the block edges
+    // and let the algorithms ramp between them.
+    NeuroticRuntime local = runtime;
+    local.lfoValue = std::sin(lfoPhase_ + lfoInc);
+    lfoPhase_ = std::fmod(lfoPhase_ + lfoInc * static_cast<float>(size), kTwoPi);
+    local.lfoStep = (size > 0)
+                        ? (std::sin(lfoPhase_ + lfoInc) - local.lfoValue) / static_cast<float>(size)
+                        : 0.0f;
 
-        float wetL = 0.0f;
-        float wetR = 0.0f;
-        algos_.Process(currentAlgo_, feedL, feedR, local, wetL, wetR);
+    algos_.ProcessBlock(in[0], in[1], out[0], out[1], size, local);
 
-        fbStateL_ = wetL;
-        fbStateR_ = wetR;
-
-        out[0][i] = (inL * dryMix + wetL * wetMix) * trim;
-        out[1][i] = (inR * dryMix + wetR * wetMix) * trim;
+    for (size_t i = 0; i < size; ++i)
+    {
+        out[0][i] = (in[0][i] * dryMix + out[0][i] * wetMix) * trim;
+        out[1][i] = (in[1][i] * dryMix + out[1][i] * wetMix) * trim;
     }
 }
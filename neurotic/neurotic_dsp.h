@@ -1,6 +1,7 @@
 #pragma once
 
-#include "daisy_seed.h"
+#include <cstddef>
+
 #include "neurotic_state.h"
 #include "algos/neurotic_algos.h"
 
@@ -8,16 +9,19 @@ class NeuroticDsp
 {
 public:
     void Init(float sampleRate);
-    void Process(daisy::AudioHandle::InputBuffer in,
-                 daisy::AudioHandle::OutputBuffer out,
+    // Buffers match daisy::AudioHandle::InputBuffer/OutputBuffer; kept as raw
+    // pointers so the DSP core also builds in host tests.
+    void Process(const float *const *in,
+                 float **out,
                  size_t size,
                  const NeuroticRuntime &runtime);
+    // Fraction of the block period the last Process() call took.
+    void ReportLoad(float load);
+    // True from an algorithm change until its crossfade and buffer clear end.
+    bool Switching() const { return algos_.Switching(); }
 
 private:
     float sampleRate_ = 48000.0f;
-    int currentAlgo_ = 0;
     float lfoPhase_ = 0.0f;
-    float fbStateL_ = 0.0f;
-    float fbStateR_ = 0.0f;
     NeuroticAlgoBank algos_{};
 };
@@ -26,6 +26,8 @@ void NeuroticParams::Update(kxmx::Bluemchen &hw, const NeuroticState &state, Neu
     runtime.fb = state.fb;
     runtime.outTrim = 1.0f;
     runtime.algoIndex = state.algoIndex;
+    runtime.crossfadeSeconds = static_cast<float>(std::max(state.crossfadeMs, 0)) * 0.001f;
+    runtime.cubicDelays = state.delayInterp != 0;
     runtime.c3 = state.c3;
     runtime.c4 = state.c4;
     runtime.lfoDepth = (state.lfoDepth < 0.005f) ? 0.0f : state.lfoDepth;
@@ -8,6 +8,8 @@ struct NeuroticState
     float fb = 0.0f;
     float outTrim = 1.0f;
     int algoIndex = 0;
+    int crossfadeMs = 50;
+    int delayInterp = 0; // 0 = linear, 1 = Hermite
     float lfoDepth = 0.0f;
     float lfoRate = 0.2f;
     float c3 = 0.0f;
@@ -20,6 +22,8 @@ struct NeuroticRuntime
     float fb = 0.0f;
     float outTrim = 1.0f;
     int algoIndex = 0;
+    float crossfadeSeconds = 0.05f;
+    bool cubicDelays = false;
     float c1 = 0.0f;
     float c2 = 0.0f;
     float c3 = 0.5f;
@@ -27,6 +31,7 @@ struct NeuroticRuntime
     float lfoDepth = 0.0f;
     float lfoRate = 0.2f;
     float lfoValue = 0.0f;
+    float lfoStep = 0.0f;
 
     uint16_t rawK1 = 0;
     uint16_t rawK2 = 0;
@@ -1,11 +1,13 @@
 #include "neurotic_ui.h"
 
-#include "daisy_seed.h"
+#include "algos/allpass_cascade.h"
 
 #include <algorithm>
 
 namespace
 {
+constexpr int kMaxSmearPoles = AllpassCascade::kMaxPoles;
+
 const char *kAlgoParamLabels[][2] = {
     {"Mass", "Asym"},   // 0 NCR
     {"Form", "Trans"},  // 1 LSB
@@ -43,13 +45,14 @@ void NeuroticUi::Init(kxmx::Bluemchen &hw, NeuroticState &state)
     algoItems_[3] = {"Rate", MenuItemType::Hz, &state.lfoRate, nullptr, 0.0f, 1.0f, 0.0102041f};
     algoItems_[4] = {kAlgoParamLabels[0][0], MenuItemType::Percent, &state.c3, nullptr, 0.0f, 1.0f, 0.02f};
     algoItems_[5] = {kAlgoParamLabels[0][1], MenuItemType::Percent, &state.c4, nullptr, 0.0f, 1.0f, 0.02f};
+    algoItems_[6] = {"Fade", MenuItemType::Int, nullptr, &state.crossfadeMs, 0.0f, 500.0f, 10.0f};
+    algoItems_[7] = {"Intrp", MenuItemType::Int, nullptr, &state.delayInterp, 0.0f, 1.0f, 1.0f};
 
     pages_[0] = {kAlgoNames[0], algoItems_, sizeof(algoItems_) / sizeof(algoItems_[0])};
 
     MenuInit(menuState_);
     menuState_.selectedIndex = 0;
     UpdateAlgoLabels(state);
-    lastDisplayUpdateMs_ = daisy::System::GetNow();
 
     (void)hw;
 }
@@ -63,12 +66,12 @@ void NeuroticUi::UpdateAlgoLabels(NeuroticState &state)
 
     if (clamped == 10)
     {
-        smearPoles_ = std::clamp(2 + static_cast<int>(state.c3 * 126.0f + 0.5f), 2, 128);
+        smearPoles_ = std::clamp(2 + static_cast<int>(state.c3 * (kMaxSmearPoles - 2) + 0.5f), 2, kMaxSmearPoles);
         algoItems_[4].type = MenuItemType::Int;
         algoItems_[4].value = nullptr;
         algoItems_[4].intValue = &smearPoles_;
         algoItems_[4].min = 2.0f;
-        algoItems_[4].max = 128.0f;
+        algoItems_[4].max = static_cast<float>(kMaxSmearPoles);
         algoItems_[4].step = 1.0f;
     }
     else
@@ -111,8 +114,8 @@ void NeuroticUi::Update(kxmx::Bluemchen &hw, NeuroticState &state)
 
     if (state.algoIndex == 10)
     {
-        const int poles = std::clamp(smearPoles_, 2, 128);
-        state.c3 = static_cast<float>(poles - 2) / 126.0f;
+        const int poles = std::clamp(smearPoles_, 2, kMaxSmearPoles);
+        state.c3 = static_cast<float>(poles - 2) / static_cast<float>(kMaxSmearPoles - 2);
     }
 
     if (state.algoIndex != algoIndex_)
@@ -121,13 +124,9 @@ void NeuroticUi::Update(kxmx::Bluemchen &hw, NeuroticState &state)
     }
 }
 
-void NeuroticUi::RenderIfNeeded(kxmx::Bluemchen &hw, const NeuroticState &state, bool heartbeatOn, uint32_t nowMs)
+void NeuroticUi::Render(kxmx::Bluemchen &hw, const NeuroticState &state, bool heartbeatOn)
 {
     (void)state;
-    if (nowMs - lastDisplayUpdateMs_ < 33)
-    {
-        return;
-    }
 
     const MenuPage &page = pages_[menuState_.pageIndex];
     DisplayData data;
@@ -135,6 +134,4 @@ void NeuroticUi::RenderIfNeeded(kxmx::Bluemchen &hw, const NeuroticState &state,
     data.heartbeatOn = heartbeatOn;
     MenuBuildVisibleLines(menuState_, page, data.lines, 3, data.lineCount, data.titleSelected);
     RenderDisplay(hw, data);
-
-    lastDisplayUpdateMs_ = nowMs;
 }
@@ -10,7 +10,7 @@ class NeuroticUi
 public:
     void Init(kxmx::Bluemchen &hw, NeuroticState &state);
     void Update(kxmx::Bluemchen &hw, NeuroticState &state);
-    void RenderIfNeeded(kxmx::Bluemchen &hw, const NeuroticState &state, bool heartbeatOn, uint32_t nowMs);
+    void Render(kxmx::Bluemchen &hw, const NeuroticState &state, bool heartbeatOn);
 
 private:
     void UpdateAlgoLabels(NeuroticState &state);
@@ -18,10 +18,9 @@ private:
     MenuState menuState_{};
     EncoderState encoderState_{};
 
-    MenuItem algoItems_[6]{};
+    MenuItem algoItems_[8]{};
     MenuPage pages_[1]{};
 
-    uint32_t lastDisplayUpdateMs_ = 0;
     int algoIndex_ = 0;
     int smearPoles_ = 2;
 };
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#include "algos/neurotic_algos.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBlockSize = 48;
+constexpr size_t kWarmupBlocks = 50;
+constexpr size_t kMeasureBlocks = 100;
+constexpr int kPasses = 5;
+constexpr int kNumAlgos = NeuroticAlgoBank::kNumAlgos;
+constexpr float kPi = 3.14159265358979323846f;
+
+using Clock = std::chrono::steady_clock;
+
+const char *kAlgoShortNames[kNumAlgos] = {
+    "NCR", "LSB", "NTH", "BGM", "NFF", "NDM", "NES", "NHC", "NPL", "NMG", "NSM",
+};
+
+size_t s_sample = 0;
+
+// Runs one block through the bank in calls of `chunk` samples and returns its
+// wall time in microseconds. chunk = 1 reproduces per-sample dispatch.
+double RunBlock(NeuroticAlgoBank &bank, const NeuroticRuntime &rt, size_t chunk = kBlockSize)
+{
+    static float inL[kBlockSize];
+    static float inR[kBlockSize];
+    static float outL[kBlockSize];
+    static float outR[kBlockSize];
+    for (size_t i = 0; i < kBlockSize; ++i, ++s_sample)
+    {
+        const float phase = 2.0f * kPi * 220.0f * static_cast<float>(s_sample) / kSampleRate;
+        const float noise = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 0.05f;
+        inL[i] = 0.25f * std::sin(phase) + noise;
+        inR[i] = 0.25f * std::sin(phase * 1.01f) - noise;
+    }
+
+    const auto start = Clock::now();
+    float sink = 0.0f;
+    for (size_t i = 0; i < kBlockSize; i += chunk)
+    {
+        bank.ProcessBlock(inL + i, inR + i, outL + i, outR + i, chunk, rt);
+    }
+    const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    for (size_t i = 0; i < kBlockSize; ++i)
+    {
+        sink += outL[i] + outR[i];
+    }
+    if (!std::isfinite(sink))
+    {
+        std::fprintf(stderr, "non-finite output\n");
+        std::exit(1);
+    }
+    return us;
+}
+// Average block time of one algorithm running alone, best of several passes.
+double SoloAverage(NeuroticAlgoBank &bank, const NeuroticRuntime &rt, int algo, size_t chunk)
+{
+    double best = 1.0e9;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        bank.Reset(algo);
+        for (size_t i = 0; i < kWarmupBlocks; ++i)
+            RunBlock(bank, rt, chunk);
+
+        double total = 0.0;
+        for (size_t i = 0; i < kMeasureBlocks; ++i)
+            total += RunBlock(bank, rt, chunk);
+        best = std::min(best, total / static_cast<double>(kMeasureBlocks));
+    }
+    return best;
+}
+} // namespace
+
+int main()
+{
+    static NeuroticAlgoBank bank;
+    bank.Init(kSampleRate);
+
+    NeuroticRuntime rt;
+    rt.c1 = 0.5f;
+    rt.c2 = 0.5f;
+    rt.c3 = 1.0f; // Worst case for pole/tap counts.
+    rt.c4 = 0.5f;
+    rt.lfoDepth = 0.5f;
+
+    const double budgetUs = 1.0e6 * static_cast<double>(kBlockSize) / kSampleRate;
+
+    std::printf("Average solo block time, per-sample vs per-block dispatch\n");
+    std::printf("%-5s%12s%12s%10s\n", "", "sample us", "block us", "speedup");
+    for (int a = 0; a < kNumAlgos; ++a)
+    {
+        const double perSample = SoloAverage(bank, rt, a, 1);
+        const double perBlock = SoloAverage(bank, rt, a, kBlockSize);
+        std::printf("%-5s%12.2f%12.2f%9.2fx\n", kAlgoShortNames[a], perSample, perBlock,
+                    perSample / std::max(perBlock, 1.0e-9));
+    }
+    std::printf("\n");
+
+    std::printf("Worst-case block time as %% of the %.0f us budget (%zu-sample blocks)\n",
+                budgetUs, kBlockSize);
+    std::printf("row = outgoing, column = incoming, diagonal = algorithm alone\n\n     ");
+    for (int b = 0; b < kNumAlgos; ++b)
+        std::printf("%6s", kAlgoShortNames[b]);
+    std::printf("\n");
+
+    double worstPair = 0.0;
+    int worstA = 0;
+    int worstB = 0;
+    for (int a = 0; a < kNumAlgos; ++a)
+    {
+        std::printf("%-5s", kAlgoShortNames[a]);
+        for (int b = 0; b < kNumAlgos; ++b)
+        {
+            // Worst block per pass, best of several passes: frame spikes recur
+            // every pass, host scheduler noise does not.
+            double worst = 1.0e9;
+            for (int pass = 0; pass < kPasses; ++pass)
+            {
+                bank.Reset(a);
+                for (size_t i = 0; i < kWarmupBlocks; ++i)
+                    RunBlock(bank, rt);
+
+                if (a != b)
+                {
+                    // Long enough that every measured block runs both algorithms.
+                    bank.SetCrossfadeTime(60.0f);
+                    bank.Select(b);
+                    bank.Service(static_cast<size_t>(-1));
+                }
+
+                double passWorst = 0.0;
+                for (size_t i = 0; i < kMeasureBlocks; ++i)
+                    passWorst = std::max(passWorst, RunBlock(bank, rt));
+                worst = std::min(worst, passWorst);
+            }
+
+            const double pct = 100.0 * worst / budgetUs;
+            std::printf("%6.1f", pct);
+            if (a != b && pct > worstPair)
+            {
+                worstPair = pct;
+                worstA = a;
+                worstB = b;
+            }
+        }
+        std::printf("\n");
+    }
+    std::printf("\nWorst pair: %s -> %s at %.1f%%\n",
+                kAlgoShortNames[worstA], kAlgoShortNames[worstB], worstPair);
+    return 0;
+}
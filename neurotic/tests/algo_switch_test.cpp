@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+#include "neurotic_dsp.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBlockSize = 48;
+constexpr size_t kBlocksPerAlgo = 400;
+constexpr size_t kMaxSwitchBlocks = 64;
+constexpr size_t kNumAlgos = 11;
+constexpr float kInputAmp = 0.25f;
+// At a handover the output may step by at most this much more than the
+// larger sample-to-sample step either algorithm makes on its own.
+constexpr float kMaxJumpRatio = 1.5f;
+constexpr float kJumpFloor = 1.0e-3f;
+constexpr float kPi = 3.14159265358979323846f;
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedUs(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+} // namespace
+
+int main()
+{
+    static float inL[kBlockSize];
+    static float inR[kBlockSize];
+    static float outL[kBlockSize];
+    static float outR[kBlockSize];
+    const float *inputs[2] = {inL, inR};
+    float *outputs[2] = {outL, outR};
+
+    // Cost of the old behaviour: clearing every shared buffer in one go.
+    static NeuroticAlgoBank bank;
+    bank.Init(kSampleRate);
+    double fullResetUs = 0.0;
+    for (size_t algo = 0; algo < kNumAlgos; ++algo)
+    {
+        const auto start = Clock::now();
+        bank.Reset(static_cast<int>(algo));
+        fullResetUs = std::max(fullResetUs, ElapsedUs(start, Clock::now()));
+    }
+
+    static NeuroticDsp dsp;
+    dsp.Init(kSampleRate);
+    NeuroticRuntime runtime;
+    runtime.mix = 1.0f;
+    runtime.c1 = 0.5f;
+    runtime.c2 = 0.5f;
+
+    const double budgetUs = 1.0e6 * static_cast<double>(kBlockSize) / kSampleRate;
+    double steadyWorstUs = 0.0;
+    double switchWorstUs = 0.0;
+    const size_t fadeBlocks = static_cast<size_t>(
+        std::ceil(runtime.crossfadeSeconds * kSampleRate / static_cast<float>(kBlockSize)));
+    float steadyJump[kNumAlgos]{};
+    float switchJump[kNumAlgos + 1]{};
+    float lastL = 0.0f;
+    float lastR = 0.0f;
+    size_t sample = 0;
+    bool ok = true;
+
+    for (size_t step = 0; step <= kNumAlgos; ++step)
+    {
+        runtime.algoIndex = static_cast<int>(step % kNumAlgos);
+        size_t switchBlocks = 0;
+        for (size_t block = 0; block < kBlocksPerAlgo; ++block)
+        {
+            for (size_t i = 0; i < kBlockSize; ++i, ++sample)
+            {
+                const float phase = 2.0f * kPi * 220.0f * static_cast<float>(sample) / kSampleRate;
+                inL[i] = kInputAmp * std::sin(phase);
+                inR[i] = kInputAmp * std::sin(phase * 1.01f);
+            }
+
+            const auto start = Clock::now();
+            dsp.Process(inputs, outputs, kBlockSize, runtime);
+            const double us = ElapsedUs(start, Clock::now());
+
+            // mix = 1, so this is the wet path alone. The two algorithms
+            // crossfade, so the output must not step where the fade starts
+            // (block 0) or where the old algorithm drops out (fadeBlocks).
+            float jump = 0.0f;
+            for (size_t i = 0; i < kBlockSize; ++i)
+            {
+                if (!std::isfinite(outL[i]) || !std::isfinite(outR[i]))
+                    ok = false;
+                jump = std::max(jump, std::max(std::fabs(outL[i] - lastL), std::fabs(outR[i] - lastR)));
+                lastL = outL[i];
+                lastR = outR[i];
+            }
+            if (dsp.Switching())
+                switchBlocks++;
+            const bool handover = block == 0 || (block + 1 >= fadeBlocks && block <= fadeBlocks);
+            if (step > 0 && handover)
+                switchJump[step] = std::max(switchJump[step], jump);
+            if (block >= kMaxSwitchBlocks)
+                steadyJump[runtime.algoIndex] = std::max(steadyJump[runtime.algoIndex], jump);
+
+            if (step > 0 && block < kMaxSwitchBlocks)
+            {
+                switchWorstUs = std::max(switchWorstUs, us);
+            }
+            else if (block >= kMaxSwitchBlocks)
+            {
+                steadyWorstUs = std::max(steadyWorstUs, us);
+            }
+        }
+        // The fade runs its full length (no cut) and the buffer clear after
+        // it finishes within the switching window.
+        if (step > 0 && (switchBlocks < fadeBlocks || switchBlocks > kMaxSwitchBlocks))
+        {
+            std::fprintf(stderr, "Switch to algo %d took %zu blocks (fade %zu, limit %zu)\n",
+                         runtime.algoIndex, switchBlocks, fadeBlocks, kMaxSwitchBlocks);
+            ok = false;
+        }
+    }
+
+    for (size_t step = 1; step <= kNumAlgos; ++step)
+    {
+        const size_t from = step - 1;
+        const size_t to = step % kNumAlgos;
+        const float limit = kMaxJumpRatio * std::max(steadyJump[from], steadyJump[to]) + kJumpFloor;
+        if (switchJump[step] > limit)
+        {
+            std::fprintf(stderr, "Switch %zu -> %zu stepped by %.4f (steady %.4f / %.4f)\n", from, to,
+                         switchJump[step], steadyJump[from], steadyJump[to]);
+            ok = false;
+        }
+    }
+
+    std::printf("block budget:         %8.2f us\n", budgetUs);
+    std::printf("full Reset():         %8.2f us\n", fullResetUs);
+    std::printf("steady worst block:   %8.2f us\n", steadyWorstUs);
+    std::printf("switching worst block:%8.2f us\n", switchWorstUs);
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "Algorithm switch test failed.\n");
+        return 1;
+    }
+    std::printf("Algorithm switch test passed.\n");
+    return 0;
+}
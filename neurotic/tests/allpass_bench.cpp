@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#include "algos/allpass_cascade.h"
+
+namespace
+{
+constexpr size_t kSamples = 48000;
+constexpr int kPasses = 5;
+constexpr float kTolerance = 1.0e-4f;
+constexpr int kPoleCounts[] = {8, 32, 64, 128, 192, 256};
+
+using Clock = std::chrono::steady_clock;
+
+// Straightforward two-state-per-stage cascade, one channel after the other;
+// this is what AlgoNsm used before AllpassCascade.
+struct ReferenceCascade
+{
+    float x1[2][AllpassCascade::kMaxPoles]{};
+    float y1[2][AllpassCascade::kMaxPoles]{};
+
+    void Process(float &left, float &right, float a, int poles)
+    {
+        float *io[2] = {&left, &right};
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            float x = *io[ch];
+            for (int i = 0; i < poles; ++i)
+            {
+                const float y = -a * x + x1[ch][i] + a * y1[ch][i];
+                x1[ch][i] = x;
+                y1[ch][i] = y;
+                x = y;
+            }
+            *io[ch] = x;
+        }
+    }
+};
+
+float s_inL[kSamples];
+float s_inR[kSamples];
+float s_refL[kSamples];
+float s_refR[kSamples];
+float s_outL[kSamples];
+float s_outR[kSamples];
+float s_coef[kSamples];
+
+template <typename Cascade>
+double Render(int poles, float *outL, float *outR)
+{
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        static Cascade cascade;
+        cascade = Cascade{};
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kSamples; ++n)
+        {
+            float l = s_inL[n];
+            float r = s_inR[n];
+            cascade.Process(l, r, s_coef[n], poles);
+            outL[n] = l;
+            outR[n] = r;
+        }
+        best = std::min(best, std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    return best;
+}
+} // namespace
+
+int main()
+{
+    srand(1);
+    for (size_t n = 0; n < kSamples; ++n)
+    {
+        s_inL[n] = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 0.5f;
+        s_inR[n] = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 0.5f;
+        // Slow sweep so the comparison covers a range of coefficients.
+        s_coef[n] = 0.9f * std::sin(static_cast<float>(n) * 2.0e-4f);
+    }
+
+    const double secondsOfAudio = static_cast<double>(kSamples) / 48000.0;
+    std::printf("Stereo allpass cascade, %zu samples, best of %d passes\n", kSamples, kPasses);
+    std::printf("%6s%14s%14s%10s%12s\n", "poles", "reference us", "cascade us", "speedup", "max error");
+
+    bool ok = true;
+    for (int poles : kPoleCounts)
+    {
+        const double refUs = Render<ReferenceCascade>(poles, s_refL, s_refR);
+        const double newUs = Render<AllpassCascade>(poles, s_outL, s_outR);
+
+        float maxErr = 0.0f;
+        for (size_t n = 0; n < kSamples; ++n)
+        {
+            maxErr = std::max(maxErr, std::fabs(s_outL[n] - s_refL[n]));
+            maxErr = std::max(maxErr, std::fabs(s_outR[n] - s_refR[n]));
+        }
+        if (!(maxErr <= kTolerance))
+            ok = false;
+
+        std::printf("%6d%14.0f%14.0f%9.2fx%12.2e  (%.1f%% of realtime)\n",
+                    poles, refUs, newUs, refUs / std::max(newUs, 1.0e-9), maxErr,
+                    100.0 * newUs * 1.0e-6 / secondsOfAudio);
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "cascade output differs from reference by more than %g\n", kTolerance);
+        return 1;
+    }
+    std::printf("Allpass cascade matches reference.\n");
+    return 0;
+}
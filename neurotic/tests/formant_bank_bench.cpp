@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#include "algos/formant_bank.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBlockSize = 48;
+constexpr size_t kSamples = 48000;
+constexpr int kPasses = 5;
+constexpr int kFormants = 3;
+constexpr float kTolerance = 1.0e-5f;
+constexpr float kPi = 3.14159265358979323846f;
+
+using Clock = std::chrono::steady_clock;
+
+// daisysp::Svf as AlgoNff ran it: Init, then SetFreq once per block, band
+// output only.
+struct ReferenceSvf
+{
+    float sr = 48000.0f;
+    float freq = 0.25f;
+    float damp = 0.0f;
+    float res = 0.5f;
+    float drive = 0.5f;
+    float low = 0.0f;
+    float band = 0.0f;
+    float outBand = 0.0f;
+
+    void SetFreq(float f)
+    {
+        const float fc = std::clamp(f, 1.0e-6f, sr / 3.0f);
+        freq = 2.0f * sinf(kPi * std::min(0.25f, fc / (sr * 2.0f)));
+        damp = std::min(2.0f * (1.0f - powf(res, 0.25f)), std::min(2.0f, 2.0f / freq - freq * 0.5f));
+    }
+
+    void Process(float in)
+    {
+        float notch = in - damp * band;
+        low = low + freq * band;
+        float high = notch - low;
+        band = freq * high + band - drive * band * band * band;
+        outBand = 0.5f * band;
+        notch = in - damp * band;
+        low = low + freq * band;
+        high = notch - low;
+        band = freq * high + band - drive * band * band * band;
+        outBand += 0.5f * band;
+    }
+};
+
+struct Case
+{
+    const char *name;
+    float vowelRate; // Per-block change of the vowel control
+};
+
+const Case kCases[] = {
+    {"held", 0.0f},
+    {"swept", 0.02f},
+};
+
+float s_inL[kSamples];
+float s_inR[kSamples];
+float s_refL[kSamples];
+float s_refR[kSamples];
+float s_outL[kSamples];
+float s_outR[kSamples];
+
+// AlgoNff's formant frequencies for block b.
+void Targets(const Case &c, size_t block, float *left, float *right)
+{
+    const float vowel = 0.5f + 0.45f * std::sin(c.vowelRate * static_cast<float>(block));
+    const float base = 440.0f * std::pow(2.0f, (43.0f + 40.0f * vowel - 69.0f) / 12.0f);
+    const float spread = 1.4f + 0.6f * 1.5f;
+    const float splitMul = 1.0f + 0.5f * 0.9f;
+    left[0] = base;
+    left[1] = base * spread;
+    left[2] = base * (spread + 0.8f);
+    for (int i = 0; i < kFormants; ++i)
+        right[i] = left[i] * splitMul;
+}
+
+double RenderReference(const Case &c)
+{
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        ReferenceSvf formL[kFormants];
+        ReferenceSvf formR[kFormants];
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kSamples; n += kBlockSize)
+        {
+            float left[kFormants];
+            float right[kFormants];
+            Targets(c, n / kBlockSize, left, right);
+            for (int i = 0; i < kFormants; ++i)
+            {
+                formL[i].SetFreq(left[i]);
+                formR[i].SetFreq(right[i]);
+            }
+            for (size_t j = n; j < n + kBlockSize; ++j)
+            {
+                float sumL = 0.0f;
+                float sumR = 0.0f;
+                for (int i = 0; i < kFormants; ++i)
+                {
+                    formL[i].Process(s_inL[j]);
+                    formR[i].Process(s_inR[j]);
+                    sumL += formL[i].outBand;
+                    sumR += formR[i].outBand;
+                }
+                s_refL[j] = sumL;
+                s_refR[j] = sumR;
+            }
+        }
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    return best / kSamples;
+}
+
+// The bank with AlgoNff's settings, but without the glide so it can be
+// compared sample for sample.
+double RenderBank(const Case &c)
+{
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        static FormantBank bank;
+        bank.Init(kSampleRate, kFormants, 2);
+        bank.SetDrive(1.0f);
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kSamples; n += kBlockSize)
+        {
+            float left[kFormants];
+            float right[kFormants];
+            Targets(c, n / kBlockSize, left, right);
+            for (int i = 0; i < kFormants; ++i)
+            {
+                bank.SetFormant(0, i, left[i], 0.5f, 1.0f);
+                bank.SetFormant(1, i, right[i], 0.5f, 1.0f);
+            }
+            bank.Prepare(kBlockSize);
+            for (size_t j = n; j < n + kBlockSize; ++j)
+                bank.Process(s_inL[j], s_inR[j], s_outL[j], s_outR[j]);
+        }
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    return best / kSamples;
+}
+} // namespace
+
+int main()
+{
+    srand(1);
+    for (size_t n = 0; n < kSamples; ++n)
+    {
+        const float noise = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 0.05f;
+        s_inL[n] = 0.25f * std::sin(2.0f * kPi * 220.0f * static_cast<float>(n) / kSampleRate) + noise;
+        s_inR[n] = 0.25f * std::sin(2.0f * kPi * 222.2f * static_cast<float>(n) / kSampleRate) - noise;
+    }
+
+    std::printf("Nff formants (%d per channel, stereo), ns/sample, block %zu, best of %d passes\n", kFormants,
+                kBlockSize, kPasses);
+    std::printf("%8s%14s%10s%10s%12s\n", "vowel", "6 x Svf", "bank", "speedup", "max error");
+
+    bool ok = true;
+    for (const Case &c : kCases)
+    {
+        const double refNs = RenderReference(c);
+        const double bankNs = RenderBank(c);
+
+        float maxErr = 0.0f;
+        for (size_t n = 0; n < kSamples; ++n)
+        {
+            maxErr = std::max(maxErr, std::fabs(s_outL[n] - s_refL[n]));
+            maxErr = std::max(maxErr, std::fabs(s_outR[n] - s_refR[n]));
+        }
+        const bool pass = maxErr <= kTolerance;
+        ok = ok && pass;
+        std::printf("%8s%14.2f%10.2f%9.2fx%12.2e%s\n", c.name, refNs, bankNs, refNs / std::max(bankNs, 1.0e-9),
+                    maxErr, pass ? "" : "  FAIL");
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "formant bank differs from the Svf reference by more than %g\n", kTolerance);
+        return 1;
+    }
+    std::printf("Formant bank matches reference.\n");
+    return 0;
+}
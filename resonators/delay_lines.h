@@ -2,12 +2,60 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 
-constexpr size_t kMaxDelaySamples = 48000;
+#include "fractional_delay.h"
 
+// Delay capacity follows from the lowest resonator pitch: one period at
+// kResonatorMinFreq and the highest supported sample rate, plus two samples
+// of interpolator headroom, rounded up to a power of two so indices wrap
+// with a mask.
+constexpr float kResonatorMinFreq = 10.0f;
+constexpr float kResonatorMaxFreq = 8000.0f;
+constexpr float kResonatorMaxSampleRate = 48000.0f;
+
+constexpr size_t NextPowerOfTwo(size_t n)
+{
+    size_t p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+constexpr size_t kMaxDelaySamples =
+    NextPowerOfTwo(static_cast<size_t>(kResonatorMaxSampleRate / kResonatorMinFreq) + 2);
+
+// Shortest delay each read mode reaches before it clamps.
+constexpr float MinReadDelay(DelayInterpolation mode)
+{
+    switch (mode)
+    {
+    case DelayInterpolation::Hermite:
+    case DelayInterpolation::Lagrange:
+        return 2.0f;
+    case DelayInterpolation::Thiran:
+        return 1.5f;
+    default:
+        return 1.0f;
+    }
+}
+
+// Highest pitch a feedback loop through one line can be tuned to when
+// `latency` samples of its period are spent outside the line (oversampling
+// filters, ADAA). Above it the read delay clamps and the pitch stalls.
+inline float MaxLoopFreq(float sampleRate, float latency, DelayInterpolation mode)
+{
+    return sampleRate / (latency + MinReadDelay(mode));
+}
+
+// No default member initializers, so a DelayBuffer can live in SDRAM
+// (DSY_SDRAM_BSS); Init() sets up all state.
 template <size_t max_size>
 class DelayBuffer
 {
+    static_assert((max_size & (max_size - 1)) == 0, "DelayBuffer size must be a power of two");
+    static constexpr size_t kMask = max_size - 1;
+
 public:
     void Init()
     {
@@ -21,6 +69,8 @@ public:
             line_[i] = 0.0f;
         }
         write_ptr_ = 0;
+        delay_ = 1.0f;
+        thiran_.Reset();
     }
 
     void SetDelay(float delay)
@@ -30,17 +80,63 @@ public:
 
     float Read() const
     {
-        const int32_t delay_integral = static_cast<int32_t>(delay_);
-        const float delay_fractional = delay_ - static_cast<float>(delay_integral);
-        const float a = line_[(write_ptr_ + delay_integral) % max_size];
-        const float b = line_[(write_ptr_ + delay_integral + 1) % max_size];
-        return a + (b - a) * delay_fractional;
+        return Interpolate(delay_);
+    }
+
+    // Per-sample modulated read: the delay is clamped like SetDelay, but
+    // nothing is stored, so a caller can sweep it every sample.
+    float ReadAt(float delay) const
+    {
+        return Interpolate(std::clamp(delay, 1.0f, static_cast<float>(max_size - 2)));
+    }
+
+    float ReadHermite(float delay) const
+    {
+        delay = std::clamp(delay, 2.0f, static_cast<float>(max_size - 3));
+        const int32_t integral = static_cast<int32_t>(delay);
+        const size_t idx = write_ptr_ + static_cast<size_t>(integral);
+        return InterpolateHermite(line_[(idx - 1) & kMask], line_[idx & kMask], line_[(idx + 1) & kMask],
+                                  line_[(idx + 2) & kMask], delay - static_cast<float>(integral));
+    }
+
+    float ReadLagrange(float delay) const
+    {
+        delay = std::clamp(delay, 2.0f, static_cast<float>(max_size - 3));
+        const int32_t integral = static_cast<int32_t>(delay);
+        const size_t idx = write_ptr_ + static_cast<size_t>(integral);
+        return InterpolateLagrange(line_[(idx - 1) & kMask], line_[idx & kMask], line_[(idx + 1) & kMask],
+                                   line_[(idx + 2) & kMask], delay - static_cast<float>(integral));
+    }
+
+    // The allpass keeps state, so call this exactly once per Write.
+    float ReadThiran(float delay)
+    {
+        delay = std::clamp(delay, 1.5f, static_cast<float>(max_size - 3));
+        float fraction = 0.0f;
+        const size_t idx = write_ptr_ + static_cast<size_t>(ThiranSplit(delay, fraction));
+        thiran_.SetFraction(fraction);
+        return thiran_.Process(line_[idx & kMask], line_[(idx + 1) & kMask]);
+    }
+
+    float ReadAt(DelayInterpolation mode, float delay)
+    {
+        switch (mode)
+        {
+        case DelayInterpolation::Hermite:
+            return ReadHermite(delay);
+        case DelayInterpolation::Lagrange:
+            return ReadLagrange(delay);
+        case DelayInterpolation::Thiran:
+            return ReadThiran(delay);
+        default:
+            return ReadAt(delay);
+        }
     }
 
     void Write(float sample)
     {
         line_[write_ptr_] = sample;
-        write_ptr_ = (write_ptr_ - 1 + max_size) % max_size;
+        write_ptr_ = (write_ptr_ - 1) & kMask;
     }
 
     void AddAt(float delay, float sample)
@@ -48,16 +144,26 @@ public:
         const float clamped = std::clamp(delay, 0.0f, static_cast<float>(max_size - 2));
         const int32_t delay_integral = static_cast<int32_t>(clamped);
         const float delay_fractional = clamped - static_cast<float>(delay_integral);
-        const size_t idx = (write_ptr_ + delay_integral) % max_size;
-        const size_t idx2 = (idx + 1) % max_size;
+        const size_t idx = (write_ptr_ + delay_integral) & kMask;
+        const size_t idx2 = (idx + 1) & kMask;
         line_[idx] += sample * (1.0f - delay_fractional);
         line_[idx2] += sample * delay_fractional;
     }
 
 private:
+    float Interpolate(float delay) const
+    {
+        const int32_t delay_integral = static_cast<int32_t>(delay);
+        const float delay_fractional = delay - static_cast<float>(delay_integral);
+        const float a = line_[(write_ptr_ + delay_integral) & kMask];
+        const float b = line_[(write_ptr_ + delay_integral + 1) & kMask];
+        return a + (b - a) * delay_fractional;
+    }
+
     float line_[max_size];
-    size_t write_ptr_ = 0;
-    float delay_ = 1.0f;
+    size_t write_ptr_;
+    float delay_;
+    ThiranAllpass thiran_;
 };
 
 struct DelayLinePair
@@ -79,6 +185,10 @@ struct DelayLinePair
 
     float Read1() const { return d1.Read(); }
     float Read2() const { return d2.Read(); }
+    float ReadAt1(float delay) const { return d1.ReadAt(delay); }
+    float ReadAt2(float delay) const { return d2.ReadAt(delay); }
+    float ReadAt1(DelayInterpolation mode, float delay) { return d1.ReadAt(mode, delay); }
+    float ReadAt2(DelayInterpolation mode, float delay) { return d2.ReadAt(mode, delay); }
 
     void Write1(float v) { d1.Write(v); }
     void Write2(float v) { d2.Write(v); }
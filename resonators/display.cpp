@@ -1,5 +1,6 @@
 #include "display.h"
 
+#include <algorithm>
 #include <cstdio>
 
 using namespace kxmx;
@@ -48,6 +49,11 @@ void RenderDisplay(Bluemchen &hw, const DisplayData &data)
         snprintf(buf, sizeof(buf), "Hz%4d", static_cast<int>(data.currentFreq + 0.5f));
         hw.display.SetCursor(0, 24);
         hw.display.WriteString(buf, Font_6x8, true);
+
+        // Control ticks run late since boot, pinned at 99.
+        snprintf(buf, sizeof(buf), "DM%2u", static_cast<unsigned>(std::min<uint32_t>(data.deadlineMisses, 99)));
+        hw.display.SetCursor(40, 24);
+        hw.display.WriteString(buf, Font_6x8, true);
     }
     else
     {
@@ -10,6 +10,7 @@ struct DisplayData
     float pitchScale = 1.0f;
     float pitchOffset = 0.0f;
     float currentFreq = 0.0f;
+    uint32_t deadlineMisses = 0;
     bool heartbeatOn = false;
 
     const char *pageTitle = "";
@@ -3,6 +3,30 @@
 #include <algorithm>
 #include <cmath>
 
+#include "oversampler.h"
+
+// Fold and drive as the resonator loop uses them: each shaper is blended
+// with its own input.
+struct FoldDriveSettings
+{
+    float depth = 0.0f;
+    int folds = 1;
+    float foldMix = 1.0f;
+    float driveMix = 0.0f;
+    bool adaa = false;
+};
+
+inline float SoftClipSample(float x)
+{
+    const float absx = fabsf(x);
+    return x / (1.0f + absx);
+}
+
+inline float WavefolderDrive(float depth, int folds)
+{
+    return 1.0f + depth * static_cast<float>(folds) * 2.0f;
+}
+
 inline float ApplyWavefolder(float sample, float depth, int folds)
 {
     if (depth <= 0.0f || folds <= 0)
@@ -10,7 +34,7 @@ inline float ApplyWavefolder(float sample, float depth, int folds)
         return sample;
     }
 
-    const float drive = 1.0f + depth * static_cast<float>(folds) * 2.0f;
+    const float drive = WavefolderDrive(depth, folds);
     float out = sample * drive;
     for (int i = 0; i < folds; ++i)
     {
@@ -26,6 +50,12 @@ inline float ApplyWavefolder(float sample, float depth, int folds)
     return out;
 }
 
+inline float OverdriveDrive(float amount)
+{
+    const float shaped = amount * amount;
+    return 1.0f + shaped * 28.0f;
+}
+
 inline float ApplyOverdrive(float sample, float amount)
 {
     if (amount <= 0.0f)
@@ -33,8 +63,7 @@ inline float ApplyOverdrive(float sample, float amount)
         return sample;
     }
 
-    const float shaped = amount * amount;
-    const float drive = 1.0f + shaped * 28.0f;
+    const float drive = OverdriveDrive(amount);
     const float soft = std::tanh(sample * drive);
     if (amount < 0.5f)
     {
@@ -46,23 +75,226 @@ inline float ApplyOverdrive(float sample, float amount)
     return soft + (hard - soft) * hardMix;
 }
 
+// First-order antiderivative anti-aliasing (ADAA) for one memoryless shaper:
+// y[n] = (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1]), with F the shaper's
+// antiderivative. Where the step is too small to divide by, the shaper is
+// evaluated at the midpoint instead. Costs half a sample of delay.
+struct AdaaStage
+{
+    static constexpr float kMinStep = 1.0e-3f;
+
+    float x1 = 0.0f;
+    float f1 = 0.0f;
+    bool primed = false;
+
+    void Reset()
+    {
+        x1 = 0.0f;
+        primed = false;
+    }
+
+    // F(x[n-1]) is cached, so call this whenever the shaper's parameters
+    // change; otherwise the first difference mixes two different curves.
+    void Invalidate() { primed = false; }
+
+    template <typename Shaper, typename Antiderivative>
+    float Process(float x, Shaper &&shaper, Antiderivative &&antiderivative)
+    {
+        if (!primed)
+        {
+            f1 = antiderivative(x1);
+            primed = true;
+        }
+        const float fx = antiderivative(x);
+        const float dx = x - x1;
+        const float y = std::fabs(dx) > kMinStep ? (fx - f1) / dx : shaper(0.5f * (x + x1));
+        x1 = x;
+        f1 = fx;
+        return y;
+    }
+};
+
+// Antiderivative of the triangle fold in ApplyWavefolder, in units of the
+// driven signal u. Within the folded range the fold is a period-4 triangle
+// whose antiderivative is T^2 / 2 on rising segments and 1 - T^2 / 2 on
+// falling ones; past the last fold the final segment carries on linearly.
+inline float TriangleFoldAntiderivative(float u, int folds)
+{
+    const float a = std::fabs(u);
+    const float edge = static_cast<float>(2 * folds + 1);
+    if (a <= edge)
+    {
+        const float v = std::fmod(a + 1.0f, 4.0f) - 1.0f; // [-1, 3)
+        if (v <= 1.0f)
+        {
+            return 0.5f * v * v;
+        }
+        const float t = 2.0f - v;
+        return 1.0f - 0.5f * t * t;
+    }
+    const float r = a - static_cast<float>(2 * folds);
+    const float sign = (folds & 1) ? -0.5f : 0.5f;
+    return 0.5f + sign * (r * r - 1.0f);
+}
+
+inline float WavefolderAntiderivative(float sample, float depth, int folds)
+{
+    if (depth <= 0.0f || folds <= 0)
+    {
+        return 0.5f * sample * sample;
+    }
+    const float drive = WavefolderDrive(depth, folds);
+    return TriangleFoldAntiderivative(sample * drive, folds) / drive;
+}
+
+// log(cosh(x)) without overflowing cosh.
+inline float LogCosh(float x)
+{
+    const float a = std::fabs(x);
+    return a + std::log1p(std::exp(-2.0f * a)) - 0.69314718f;
+}
+
+inline float HardClipAntiderivative(float x)
+{
+    const float a = std::fabs(x);
+    return a <= 1.0f ? 0.5f * x * x : a - 0.5f;
+}
+
+inline float OverdriveAntiderivative(float sample, float amount)
+{
+    const float linear = 0.5f * sample * sample;
+    if (amount <= 0.0f)
+    {
+        return linear;
+    }
+
+    const float drive = OverdriveDrive(amount);
+    const float soft = LogCosh(sample * drive) / drive;
+    if (amount < 0.5f)
+    {
+        return linear + (soft - linear) * (amount * 2.0f);
+    }
+
+    const float hard = HardClipAntiderivative(sample);
+    return soft + (hard - soft) * ((amount - 0.5f) * 2.0f);
+}
+
+inline float SoftClipAntiderivative(float x)
+{
+    const float absx = fabsf(x);
+    return absx - std::log1p(absx);
+}
+
+inline float FoldBlend(float x, const FoldDriveSettings &s)
+{
+    const float fold = ApplyWavefolder(x, s.depth, s.folds);
+    return x + (fold - x) * s.foldMix;
+}
+
+inline float FoldBlendAntiderivative(float x, const FoldDriveSettings &s)
+{
+    const float linear = 0.5f * x * x;
+    return linear + (WavefolderAntiderivative(x, s.depth, s.folds) - linear) * s.foldMix;
+}
+
+inline float DriveBlend(float x, const FoldDriveSettings &s)
+{
+    const float drive = ApplyOverdrive(x, s.depth);
+    return x + (drive - x) * s.driveMix;
+}
+
+inline float DriveBlendAntiderivative(float x, const FoldDriveSettings &s)
+{
+    const float linear = 0.5f * x * x;
+    return linear + (OverdriveAntiderivative(x, s.depth) - linear) * s.driveMix;
+}
+
 struct DistortionChannel
 {
+    // Makeup gain time constants: back to unity on silence, and following
+    // the shaper's level otherwise.
+    static constexpr float kMakeupSettleSeconds = 0.05f;
+    static constexpr float kMakeupTrackSeconds = 0.02f;
+
     float makeupGain = 1.0f;
+    float makeupSettle = 0.02f;
+    float makeupTrack = 0.05f;
+    Oversampler oversampler{};
+    AdaaStage foldAdaa{};
+    AdaaStage driveAdaa{};
+    AdaaStage clipAdaa{};
+
+    void Reset()
+    {
+        makeupGain = 1.0f;
+        oversampler.Init();
+        foldAdaa.Reset();
+        driveAdaa.Reset();
+        clipAdaa.Reset();
+    }
+
+    // Once per block, before Shape/Clip, since the settings may have moved.
+    void Prepare(int oversample)
+    {
+        oversampler.SetFactorIndex(oversample);
+        foldAdaa.Invalidate();
+        driveAdaa.Invalidate();
+    }
 
-    void Reset() { makeupGain = 1.0f; }
+    // Delay Shape and Clip add to the loop, in samples.
+    float Latency(bool adaa) const
+    {
+        const float adaaDelay = adaa ? 1.0f / static_cast<float>(oversampler.Factor()) + 0.5f : 0.0f;
+        return oversampler.Latency() + adaaDelay;
+    }
+
+    float Shape(float x, const FoldDriveSettings &s)
+    {
+        return oversampler.ProcessSample(x, [this, &s](float v) {
+            if (!s.adaa)
+            {
+                return DriveBlend(FoldBlend(v, s), s);
+            }
+            const float folded = foldAdaa.Process(
+                v,
+                [&s](float a) { return FoldBlend(a, s); },
+                [&s](float a) { return FoldBlendAntiderivative(a, s); });
+            return driveAdaa.Process(
+                folded,
+                [&s](float a) { return DriveBlend(a, s); },
+                [&s](float a) { return DriveBlendAntiderivative(a, s); });
+        });
+    }
+
+    float Clip(float x, bool adaa)
+    {
+        if (!adaa)
+        {
+            return SoftClipSample(x);
+        }
+        return clipAdaa.Process(x, SoftClipSample, SoftClipAntiderivative);
+    }
     float ApplyMakeup(float input) const { return input * makeupGain; }
 
+    // Coefficients for one UpdateMakeup per control tick, from
+    // ControlScheduler::SmoothingCoefficient() and the times above.
+    void SetMakeupCoefficients(float settle, float track)
+    {
+        makeupSettle = settle;
+        makeupTrack = track;
+    }
+
+    // Once per control tick, with the peaks seen since the last one.
     void UpdateMakeup(float inPeak, float outPeak)
     {
         if (inPeak < 0.0005f || outPeak < 0.0005f)
         {
-            makeupGain += (1.0f - makeupGain) * 0.02f;
+            makeupGain += (1.0f - makeupGain) * makeupSettle;
             return;
         }
 
         float target = inPeak / outPeak;
         target = std::clamp(target, 0.25f, 4.0f);
-        makeupGain += (target - makeupGain) * 0.05f;
+        makeupGain += (target - makeupGain) * makeupTrack;
     }
 };
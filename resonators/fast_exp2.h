@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Table-based 2^x for pitch conversion in the audio callback. The fraction
+// is looked up in a 256-segment table of 2^f on [0, 1] with linear
+// interpolation (worst case about 1e-6 relative, well under 0.01 cent); the
+// integer part goes straight into the float exponent. The table is built at
+// compile time, so it lives in flash and needs no Init().
+
+constexpr size_t kFastExp2Segments = 256;
+
+struct FastExp2Table
+{
+    float values[kFastExp2Segments + 1];
+};
+
+// 2^x for x in [0, 1] by the exp series, in double so the table is exact
+// to float precision.
+constexpr double Exp2Series(double x)
+{
+    const double y = x * 0.69314718055994530942;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int k = 1; k < 24; ++k)
+    {
+        term *= y / k;
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr FastExp2Table MakeFastExp2Table()
+{
+    FastExp2Table table{};
+    for (size_t i = 0; i <= kFastExp2Segments; ++i)
+        table.values[i] = static_cast<float>(Exp2Series(static_cast<double>(i) / kFastExp2Segments));
+    return table;
+}
+
+inline constexpr FastExp2Table kFastExp2Table = MakeFastExp2Table();
+
+inline float FastExp2(float x)
+{
+    x = x < -126.0f ? -126.0f : (x > 126.0f ? 126.0f : x);
+    const float whole = std::floor(x);
+    const float pos = (x - whole) * static_cast<float>(kFastExp2Segments);
+    // x just below an integer can round to a fraction of exactly 1.
+    const int index = pos < static_cast<float>(kFastExp2Segments) ? static_cast<int>(pos)
+                                                                   : static_cast<int>(kFastExp2Segments) - 1;
+    const float frac = pos - static_cast<float>(index);
+    const float *table = kFastExp2Table.values;
+    const float mantissa = table[index] + (table[index + 1] - table[index]) * frac;
+
+    const uint32_t bits = static_cast<uint32_t>(static_cast<int>(whole) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return mantissa * scale;
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "delay_lines.h"
+#include "distortion.h"
+
+// N-line feedback delay network for the 4- and 8-line resonator modes. The
+// 2-line mode keeps using DelayLinePair and FeedFilters in main.cpp.
+//
+// Per sample: read every line, damp each with its own lowpass, mix through
+// an orthogonal matrix that the coupling rotates in from the identity, add
+// the inputs, shape and write back. Per-line state is kept as
+// structure-of-arrays so the damping, mixing and gain loops run across all
+// lines at once.
+
+constexpr size_t kFdnMaxLines = 8;
+constexpr size_t kFdnLineSamples = kMaxDelaySamples;
+
+// Line storage, separate from FeedbackDelayNetwork so the firmware can place
+// it in SDRAM (DSY_SDRAM_BSS).
+struct FdnLines
+{
+    DelayBuffer<kFdnLineSamples> lines[kFdnMaxLines];
+};
+
+enum class FdnMatrix
+{
+    Householder, // I + rank-2 rotation of the common mode, O(N)
+    Hadamard,    // Fast Walsh-Hadamard butterflies, O(N log N)
+};
+
+// In-place orthogonal mixes over `count` lanes (count is a power of two),
+// each a rotation by an angle with cosine c and sine s. Every angle is
+// lossless, so coupling can move between independent lines (angle 0) and the
+// full matrix without any mode losing or gaining energy on the way.
+//
+// Householder: rotates the plane of the common mode u = 1/sqrt(N) and the
+// half-alternating mode w (+ on the first half, - on the second). At 90
+// degrees u goes to w and w to -u, which mixes every line into every other
+// like I - (2/N) 11^T does. The reflection itself has determinant -1, so no
+// lossless path from the identity reaches it.
+inline void MixHouseholder(float *v, size_t count, float c, float s)
+{
+    const size_t half = count / 2;
+    float sumLow = 0.0f;
+    float sumHigh = 0.0f;
+    for (size_t i = 0; i < half; ++i)
+        sumLow += v[i];
+    for (size_t i = half; i < count; ++i)
+        sumHigh += v[i];
+    const float norm = 1.0f / std::sqrt(static_cast<float>(count));
+    const float common = (sumLow + sumHigh) * norm;
+    const float alternating = (sumLow - sumHigh) * norm;
+    const float dCommon = (c - 1.0f) * common - s * alternating;
+    const float dAlternating = s * common + (c - 1.0f) * alternating;
+    const float addLow = (dCommon + dAlternating) * norm;
+    const float addHigh = (dCommon - dAlternating) * norm;
+    for (size_t i = 0; i < half; ++i)
+        v[i] += addLow;
+    for (size_t i = half; i < count; ++i)
+        v[i] += addHigh;
+}
+
+// Hadamard: every butterfly is a Givens rotation. At 45 degrees it is the
+// Walsh-Hadamard transform with some rows negated, already normalised.
+inline void MixHadamard(float *v, size_t count, float c, float s)
+{
+    for (size_t span = 1; span < count; span *= 2)
+    {
+        for (size_t start = 0; start < count; start += 2 * span)
+        {
+            for (size_t i = start; i < start + span; ++i)
+            {
+                const float a = v[i];
+                const float b = v[i + span];
+                v[i] = c * a + s * b;
+                v[i + span] = c * b - s * a;
+            }
+        }
+    }
+}
+
+// The coupling blend as the network applies it: 0 = independent lines,
+// 1 = the full matrix.
+struct FdnCoupling
+{
+    FdnMatrix matrix = FdnMatrix::Householder;
+    float c = 1.0f;
+    float s = 0.0f;
+
+    void Set(FdnMatrix m, float coupling)
+    {
+        constexpr float kHalfPi = 1.57079632679489661923f;
+        matrix = m;
+        const float fullAngle = (m == FdnMatrix::Hadamard) ? 0.5f * kHalfPi : kHalfPi;
+        const float angle = std::clamp(coupling, 0.0f, 1.0f) * fullAngle;
+        c = std::cos(angle);
+        s = std::sin(angle);
+    }
+
+    void Apply(float *v, size_t count) const
+    {
+        if (matrix == FdnMatrix::Hadamard)
+            MixHadamard(v, count, c, s);
+        else
+            MixHouseholder(v, count, c, s);
+    }
+};
+
+class FeedbackDelayNetwork
+{
+public:
+    struct Settings
+    {
+        float freqX = 440.0f;     // Pitch of the even lines
+        float freqY = 440.0f;     // Pitch of the odd lines
+        float spread = 0.0f;      // 0 = all lines at their base pitch, 1 = harmonic series
+        float feedback = 0.8f;
+        float coupling = 0.5f;    // 0 = independent lines, 1 = full matrix
+        FdnMatrix matrix = FdnMatrix::Householder;
+        float filterLevel = 0.2f; // Same meaning as the Filter page
+        float filterRatio = 0.25f;
+        float filterQ = 0.7f;
+        DelayInterpolation interpolation = DelayInterpolation::Linear;
+    };
+
+    void Init(float sampleRate, FdnLines *lines)
+    {
+        sampleRate_ = sampleRate;
+        lines_ = lines;
+        for (size_t i = 0; i < kFdnMaxLines; ++i)
+        {
+            lines_->lines[i].Init();
+            shapers_[i].Reset();
+            inPeak_[i] = 0.0f;
+            outPeak_[i] = 0.0f;
+            ic1_[i] = 0.0f;
+            ic2_[i] = 0.0f;
+        }
+        lineCount_ = 4;
+    }
+
+    // 4 or 8; anything else is rounded to the nearest supported count.
+    void SetLineCount(size_t count)
+    {
+        count = count <= 4 ? 4 : kFdnMaxLines;
+        if (count == lineCount_)
+            return;
+        // Lines that were idle hold stale audio.
+        for (size_t i = lineCount_; i < count; ++i)
+        {
+            lines_->lines[i].Reset();
+            ic1_[i] = 0.0f;
+            ic2_[i] = 0.0f;
+        }
+        lineCount_ = count;
+    }
+
+    size_t LineCount() const { return lineCount_; }
+
+    // Once per block, with the shaping ProcessSample will use.
+    void Prepare(const Settings &settings, const FoldDriveSettings &shape, int oversample)
+    {
+        for (size_t i = 0; i < lineCount_; ++i)
+        {
+            shapers_[i].Prepare(oversample);
+        }
+        // The shaping sits inside every loop; take its delay off the lines.
+        loopLatency_ = shapers_[0].Latency(shape.adaa);
+
+        coupling_.Set(settings.matrix, settings.coupling);
+        interpolation_ = settings.interpolation;
+        feedback_ = std::clamp(settings.feedback, 0.0f, 0.99f);
+        level_ = std::clamp(settings.filterLevel, 0.0f, 1.0f);
+
+        const float ratio = std::clamp(settings.filterRatio, 0.25f, 2.0f);
+        const float q = std::clamp(settings.filterQ, 0.5f, 2.0f);
+        const float res = (q - 0.5f) / 1.5f;
+        const float damp = std::max(2.0f * (1.0f - std::pow(res, 0.25f)), kMinDamp);
+        for (size_t i = 0; i < lineCount_; ++i)
+        {
+            const float base = (i & 1) ? settings.freqY : settings.freqX;
+            const float harmonic = 1.0f + static_cast<float>(i / 2) * std::clamp(settings.spread, 0.0f, 1.0f);
+            const float freq = std::max(base * harmonic, 1.0f);
+            period_[i] = sampleRate_ / freq;
+
+            const float cutoff = std::clamp(freq * ratio, 20.0f, std::min(12000.0f, sampleRate_ / 3.0f));
+            const float g = std::tan(kPi * cutoff / sampleRate_);
+            a1_[i] = 1.0f / (1.0f + g * (g + damp));
+            a2_[i] = g * a1_[i];
+            a3_[i] = g * a2_[i];
+        }
+    }
+
+    // periodScale multiplies every line's period for this sample (1 = the
+    // pitches given to Prepare), so pitch can be swept within a block.
+    void ProcessSample(float inX, float inY, const FoldDriveSettings &shape, float &outX, float &outY,
+                       float periodScale = 1.0f)
+    {
+        const size_t count = lineCount_;
+        float tap[kFdnMaxLines];
+        float mixed[kFdnMaxLines];
+        for (size_t i = 0; i < count; ++i)
+            tap[i] = lines_->lines[i].ReadAt(interpolation_, period_[i] * periodScale - loopLatency_);
+
+        // Damping: trapezoidal SVF lowpass per line, blended like FeedFilters.
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float v3 = tap[i] - ic2_[i];
+            const float v1 = a1_[i] * ic1_[i] + a2_[i] * v3;
+            const float v2 = ic2_[i] + a2_[i] * ic1_[i] + a3_[i] * v3;
+            ic1_[i] = 2.0f * v1 - ic1_[i];
+            ic2_[i] = 2.0f * v2 - ic2_[i];
+            mixed[i] = tap[i] + (v2 - tap[i]) * level_;
+        }
+
+        coupling_.Apply(mixed, count);
+
+        float pre[kFdnMaxLines];
+        for (size_t i = 0; i < count; ++i)
+            pre[i] = ((i & 1) ? inY : inX) + mixed[i] * feedback_;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float shaped = shapers_[i].Shape(pre[i], shape);
+            inPeak_[i] = std::max(inPeak_[i], std::fabs(pre[i]));
+            outPeak_[i] = std::max(outPeak_[i], std::fabs(shaped));
+            lines_->lines[i].Write(shapers_[i].Clip(shapers_[i].ApplyMakeup(shaped), shape.adaa));
+        }
+
+        float sumX = 0.0f;
+        float sumY = 0.0f;
+        for (size_t i = 0; i < count; i += 2)
+        {
+            sumX += tap[i];
+            sumY += tap[i + 1];
+        }
+        const float norm = 2.0f / static_cast<float>(count);
+        outX = sumX * norm;
+        outY = sumY * norm;
+    }
+
+    // Coefficients for one UpdateMakeup per control tick, as
+    // DistortionChannel::SetMakeupCoefficients().
+    void SetMakeupCoefficients(float settle, float track)
+    {
+        for (size_t i = 0; i < kFdnMaxLines; ++i)
+            shapers_[i].SetMakeupCoefficients(settle, track);
+    }
+
+    // Once per control tick: each line's makeup follows the levels its
+    // shaper saw since the last one.
+    void UpdateMakeup()
+    {
+        for (size_t i = 0; i < lineCount_; ++i)
+            shapers_[i].UpdateMakeup(inPeak_[i], outPeak_[i]);
+        for (size_t i = 0; i < kFdnMaxLines; ++i)
+        {
+            inPeak_[i] = 0.0f;
+            outPeak_[i] = 0.0f;
+        }
+    }
+
+private:
+    static constexpr float kPi = 3.14159265358979323846f;
+    static constexpr float kMinDamp = 0.05f;
+
+    float sampleRate_ = 48000.0f;
+    FdnLines *lines_ = nullptr;
+    size_t lineCount_ = 4;
+    FdnCoupling coupling_{};
+    DelayInterpolation interpolation_ = DelayInterpolation::Linear;
+    float feedback_ = 0.8f;
+    float level_ = 0.2f;
+    float loopLatency_ = 0.0f;
+
+    float period_[kFdnMaxLines]{};
+    float a1_[kFdnMaxLines]{};
+    float a2_[kFdnMaxLines]{};
+    float a3_[kFdnMaxLines]{};
+    float ic1_[kFdnMaxLines]{};
+    float ic2_[kFdnMaxLines]{};
+    float inPeak_[kFdnMaxLines]{};
+    float outPeak_[kFdnMaxLines]{};
+    DistortionChannel shapers_[kFdnMaxLines]{};
+};
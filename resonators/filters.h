@@ -65,9 +65,3 @@ struct FeedFilters
         return dry + (wet - dry) * mix;
     }
 };
-
-inline float SoftClipSample(float x)
-{
-    const float absx = fabsf(x);
-    return x / (1.0f + absx);
-}
@@ -5,10 +5,13 @@
 #include "kxmx_bluemchen.h"
 #include "util/PersistentStorage.h"
 
+#include "control_scheduler.h"
 #include "delay_lines.h"
 #include "display.h"
 #include "distortion.h"
 #include "encoder_handler.h"
+#include "fast_exp2.h"
+#include "fdn.h"
 #include "filters.h"
 #include "menu_system.h"
 
@@ -21,8 +24,8 @@ namespace
 #define M_PI 3.14159265358979323846f
 #endif
 
-    constexpr float kMinFreq = 10.0f;
-    constexpr float kMaxFreq = 8000.0f;
+    constexpr float kMinFreq = kResonatorMinFreq;
+    constexpr float kMaxFreq = kResonatorMaxFreq;
     constexpr float kMaxFeed = 0.99f;
     constexpr float kCalibTone = 440.0f;
     constexpr float kTwoPi = 2.0f * static_cast<float>(M_PI);
@@ -51,12 +54,24 @@ namespace
         int folds = 3;
         float foldMix = 1.0f;
         float driveMix = 0.0f;
+        int oversample = 0;
+        int adaa = 0;
     };
 
     struct ResonatorParams
     {
         float ratio = 1.0f;
         float mix = 1.0f;
+        int interp = 0; // DelayInterpolation: 0 = linear, 1 = Hermite, 2 = Lagrange, 3 = Thiran
+    };
+
+    struct NetworkParams
+    {
+        int size = 0; // 0 = 2-line pair, 1 = 4-line FDN, 2 = 8-line FDN
+        float spread = 0.0f;
+        int matrix = 0; // 0 = Householder, 1 = Hadamard
+        float coupling = 0.5f;
+        float feedback = 0.8f;
     };
 
     struct FilterParams
@@ -66,24 +81,35 @@ namespace
         float q = 0.7f;
     };
 
-    float MapExpo(float value, float minVal, float maxVal)
+    // Resonator pitch in octaves above 1 Hz: pot 1 spans kMinFreq..kMaxFreq
+    // exponentially and CV 1 adds 1V/oct through the calibration. The result
+    // stops at maxFreq, the highest pitch the loop can currently reach.
+    float PitchOctaves(float pot1, float cv1, float scale, float offset, float maxFreq)
     {
-        value = std::clamp(value, 0.0f, 1.0f);
-        return minVal * powf(maxVal / minVal, value);
+        const float minOct = std::log2(kMinFreq);
+        const float maxOct = std::log2(kMaxFreq);
+        const float base = minOct + std::clamp(pot1, 0.0f, 1.0f) * (maxOct - minOct);
+        return std::clamp(base + offset + cv1 * 5.0f * scale, minOct, std::log2(maxFreq));
     }
 } // namespace
 
 Bluemchen hw;
-DelayLinePair delays;
+// The pair is read every sample at arbitrary offsets, so it lives in
+// zero-wait DTCM; the longer network lines go to SDRAM.
+DelayLinePair DTCM_MEM_SECTION delays;
 FeedFilters feedFilters;
 DistortionChannel distortionX;
 DistortionChannel distortionY;
+FdnLines DSY_SDRAM_BSS networkLines;
+FeedbackDelayNetwork network;
+ControlScheduler scheduler;
 EncoderState encoderState;
 MenuState menuState;
 
 WiringParams wiringParams;
 DistortionParams distortionParams;
 ResonatorParams resonatorParams;
+NetworkParams networkParams;
 FilterParams filterParams;
 
 MenuItem wiringItems[] = {
@@ -96,12 +122,17 @@ MenuItem wiringItems[] = {
 MenuItem resonatorItems[] = {
     {"Ratio", MenuItemType::Ratio, &resonatorParams.ratio, nullptr, 0.25f, 4.0f, 0.05f},
     {"Mix", MenuItemType::Percent, &resonatorParams.mix, nullptr, 0.0f, 1.0f, 0.02f},
+    {"Intrp", MenuItemType::Int, nullptr, &resonatorParams.interp, 0.0f,
+     static_cast<float>(kDelayInterpolationCount - 1), 1.0f},
 };
 
 MenuItem distortionItems[] = {
     {"Fold", MenuItemType::Percent, &distortionParams.foldMix, nullptr, 0.0f, 1.0f, 0.02f},
     {"Drive", MenuItemType::Percent, &distortionParams.driveMix, nullptr, 0.0f, 1.0f, 0.02f},
     {"NFold", MenuItemType::Int, nullptr, &distortionParams.folds, 1.0f, 5.0f, 1.0f},
+    {"OS", MenuItemType::Int, nullptr, &distortionParams.oversample, 0.0f,
+     static_cast<float>(Oversampler::kMaxFactorIndex), 1.0f},
+    {"ADAA", MenuItemType::Int, nullptr, &distortionParams.adaa, 0.0f, 1.0f, 1.0f},
 };
 
 MenuItem filterItems[] = {
@@ -110,11 +141,20 @@ MenuItem filterItems[] = {
     {"Q", MenuItemType::Ratio, &filterParams.q, nullptr, 0.5f, 2.0f, 0.05f},
 };
 
+MenuItem networkItems[] = {
+    {"Lines", MenuItemType::Int, nullptr, &networkParams.size, 0.0f, 2.0f, 1.0f},
+    {"Sprd", MenuItemType::Percent, &networkParams.spread, nullptr, 0.0f, 1.0f, 0.02f},
+    {"Mtx", MenuItemType::Int, nullptr, &networkParams.matrix, 0.0f, 1.0f, 1.0f},
+    {"Coup", MenuItemType::Percent, &networkParams.coupling, nullptr, 0.0f, 1.0f, 0.02f},
+    {"Feed", MenuItemType::Percent, &networkParams.feedback, nullptr, 0.0f, kMaxFeed, 0.02f},
+};
+
 MenuPage menuPages[] = {
     {"Wiring", wiringItems, sizeof(wiringItems) / sizeof(wiringItems[0])},
     {"Resonate", resonatorItems, sizeof(resonatorItems) / sizeof(resonatorItems[0])},
     {"Distort", distortionItems, sizeof(distortionItems) / sizeof(distortionItems[0])},
     {"Filter", filterItems, sizeof(filterItems) / sizeof(filterItems[0])},
+    {"Network", networkItems, sizeof(networkItems) / sizeof(networkItems[0])},
 };
 
 constexpr size_t kMenuPageCount = sizeof(menuPages) / sizeof(menuPages[0]);
@@ -124,6 +164,12 @@ float currentFreq2 = 440.0f;
 float pitchScale = 1.0f;
 float pitchOffset = 0.0f;
 float waveDepth = 0.0f;
+float pitchOctaves = 0.0f; // Audio thread: pitch at the end of the last block
+// Audio thread: the pair's shaper levels since the last control tick.
+float pairInPeakX = 0.0f;
+float pairInPeakY = 0.0f;
+float pairOutPeakX = 0.0f;
+float pairOutPeakY = 0.0f;
 
 bool calibMode = false;
 uint32_t lastCalibChangeMs = 0;
@@ -141,10 +187,11 @@ uint32_t lastHeartbeatMs = 0;
 bool ledOn = false;
 uint32_t lastLedMs = 0;
 
-void UpdateControls()
+// Audio callback, at the control rate: knobs and CV are sampled at a fixed
+// rate whatever the display is doing.
+void UpdateAnalogControls()
 {
     hw.ProcessAnalogControls();
-    hw.ProcessDigitalControls();
 
     const float pot1 = hw.GetKnobValue(Bluemchen::CTRL_1);
     const float pot2 = hw.GetKnobValue(Bluemchen::CTRL_2);
@@ -159,7 +206,28 @@ void UpdateControls()
         const float base = kCalibTone * powf(2.0f, pitchOffset);
         currentFreq = base * powf(2.0f, cvOct * 0.5f * pitchScale);
         currentFreq2 = currentFreq;
+    }
+    else
+    {
+        // currentFreq and currentFreq2 are set per block from pot 1 and CV 1.
+        const float waveControl = std::clamp((pot2 - 0.5f) * 2.0f + (cv2 - 0.5f) * 2.0f, -1.0f, 1.0f);
+        waveDepth = std::clamp(0.5f + waveControl * 0.8f, 0.0f, 1.0f);
+    }
+
+    feedFilters.SetParams(filterParams.level,
+                          filterParams.freqRatio,
+                          filterParams.q,
+                          currentFreq,
+                          currentFreq2);
+}
 
+// Main loop: encoder, menus, and noticing calibration changes to save.
+void UpdateControls()
+{
+    hw.ProcessDigitalControls();
+
+    if (calibMode)
+    {
         const uint32_t now = System::GetNow();
         if (fabsf(pitchScale - savedCalib.scale) > 0.0005f || fabsf(pitchOffset - savedCalib.offset) > 0.005f)
         {
@@ -167,16 +235,6 @@ void UpdateControls()
             lastCalibChangeMs = now;
         }
     }
-    else
-    {
-        const float baseFreq = MapExpo(pot1, kMinFreq, kMaxFreq);
-        const float cvOct = cv1 * 5.0f * pitchScale;
-        const float pitchMultiplier = powf(2.0f, pitchOffset + cvOct);
-        currentFreq = std::clamp(baseFreq * pitchMultiplier, kMinFreq, kMaxFreq);
-        currentFreq2 = std::clamp(currentFreq * resonatorParams.ratio, kMinFreq, kMaxFreq);
-        const float waveControl = std::clamp((pot2 - 0.5f) * 2.0f + (cv2 - 0.5f) * 2.0f, -1.0f, 1.0f);
-        waveDepth = std::clamp(0.5f + waveControl * 0.8f, 0.0f, 1.0f);
-    }
 
     const int encInc = hw.encoder.Increment();
     const EncoderPress press = UpdateEncoder(hw, encoderState);
@@ -202,12 +260,6 @@ void UpdateControls()
             MenuRotate(menuState, encInc, menuPages, kMenuPageCount);
         }
     }
-
-    feedFilters.SetParams(filterParams.level,
-                          filterParams.freqRatio,
-                          filterParams.q,
-                          currentFreq,
-                          currentFreq2);
 }
 
 void HandleCalibrationSave()
@@ -245,6 +297,7 @@ DisplayData BuildDisplayData()
     data.currentFreq = currentFreq;
     data.showSaveConfirm = showSaveConfirm;
     data.heartbeatOn = heartbeatOn;
+    data.deadlineMisses = scheduler.DeadlineMisses();
 
     if (!calibMode)
     {
@@ -256,24 +309,127 @@ DisplayData BuildDisplayData()
     return data;
 }
 
+// Audio callback, at the control rate: the makeup gains follow the shaper
+// levels seen since the last tick, so their time constants hold whatever
+// the block size. Calibration leaves them where they were.
+void UpdateMakeup()
+{
+    if (!calibMode && networkParams.size > 0)
+    {
+        network.UpdateMakeup();
+    }
+    else if (!calibMode)
+    {
+        distortionX.UpdateMakeup(pairInPeakX, pairOutPeakX);
+        distortionY.UpdateMakeup(pairInPeakY, pairOutPeakY);
+    }
+    pairInPeakX = 0.0f;
+    pairInPeakY = 0.0f;
+    pairOutPeakX = 0.0f;
+    pairOutPeakY = 0.0f;
+}
+
+// 4- and 8-line modes: the same input, shaping and mix as the pair, with
+// the Network page standing in for the Wiring page.
+void ProcessNetwork(AudioHandle::InputBuffer in,
+                    AudioHandle::OutputBuffer out,
+                    size_t size,
+                    const FoldDriveSettings &shape,
+                    float octaveStep)
+{
+    network.SetLineCount(networkParams.size == 1 ? 4 : kFdnMaxLines);
+
+    FeedbackDelayNetwork::Settings settings;
+    settings.freqX = currentFreq;
+    settings.freqY = currentFreq2;
+    settings.spread = networkParams.spread;
+    settings.feedback = networkParams.feedback;
+    settings.coupling = networkParams.coupling;
+    settings.matrix = networkParams.matrix == 1 ? FdnMatrix::Hadamard : FdnMatrix::Householder;
+    settings.filterLevel = filterParams.level;
+    settings.filterRatio = filterParams.freqRatio;
+    settings.filterQ = filterParams.q;
+    settings.interpolation = static_cast<DelayInterpolation>(resonatorParams.interp);
+    network.Prepare(settings, shape, distortionParams.oversample);
+
+    const float resMix = resonatorParams.mix;
+    const float dryMix = 1.0f - resMix;
+    for (size_t i = 0; i < size; i++)
+    {
+        const float inX = SoftClipSample(in[0][i]);
+        const float inY = SoftClipSample(in[1][i]);
+        float resX = 0.0f;
+        float resY = 0.0f;
+        const float periodScale = FastExp2(octaveStep * static_cast<float>(size - 1 - i));
+        network.ProcessSample(inX, inY, shape, resX, resY, periodScale);
+        out[0][i] = dryMix * inX + resMix * resX;
+        out[1][i] = dryMix * inY + resMix * resY;
+    }
+}
+
 void AudioCallback(AudioHandle::InputBuffer in,
                    AudioHandle::OutputBuffer out,
                    size_t size)
 {
-    const float delaySamples1 = sampleRate / std::max(currentFreq, 1.0f);
-    const float delaySamples2 = sampleRate / std::max(currentFreq2, 1.0f);
+    for (size_t ticks = scheduler.BeginBlock(size, System::GetTick()); ticks > 0; --ticks)
+    {
+        UpdateAnalogControls();
+        UpdateMakeup();
+    }
 
-    delays.SetDelayTimes(delaySamples1, delaySamples2);
+    FoldDriveSettings shape;
+    shape.depth = waveDepth;
+    shape.folds = distortionParams.folds;
+    shape.foldMix = distortionParams.foldMix;
+    shape.driveMix = distortionParams.driveMix;
+    shape.adaa = distortionParams.adaa != 0;
+
+    distortionX.Prepare(distortionParams.oversample);
+    distortionY.Prepare(distortionParams.oversample);
+
+    // The oversampler and ADAA sit inside the feedback loop, so their delay
+    // is taken off the delay lines to keep the loop on pitch. The lines
+    // cannot get shorter than the interpolator's minimum, which puts a
+    // ceiling on the pitch (4.2 kHz at 2x down to 2.9 kHz at 8x with ADAA
+    // and a cubic), so pitch is held at it instead of stalling there
+    // unannounced. The network's shapers run at the same factor.
+    const float loopLatency = distortionX.Latency(shape.adaa);
+    const DelayInterpolation interp = static_cast<DelayInterpolation>(resonatorParams.interp);
+    const float maxFreq = std::min(kMaxFreq, MaxLoopFreq(sampleRate, loopLatency, interp));
+
+    // Pitch is read once per block and ramped in octaves across it, so CV
+    // moves the resonance smoothly instead of in block-sized steps. Sample i
+    // sits octaveStep * (size - 1 - i) below the block's target, so its
+    // period is the target period times 2^(that).
+    float targetOctaves = pitchOctaves;
+    if (!calibMode)
+    {
+        targetOctaves = PitchOctaves(hw.GetKnobValue(Bluemchen::CTRL_1),
+                                     hw.GetKnobValue(Bluemchen::CTRL_3),
+                                     pitchScale,
+                                     pitchOffset,
+                                     maxFreq);
+        currentFreq = FastExp2(targetOctaves);
+        currentFreq2 = std::clamp(currentFreq * resonatorParams.ratio, kMinFreq, maxFreq);
+    }
+    const float octaveStep = (targetOctaves - pitchOctaves) / static_cast<float>(size);
+    pitchOctaves = targetOctaves;
+
+    if (!calibMode && networkParams.size > 0)
+    {
+        ProcessNetwork(in, out, size, shape, octaveStep);
+        return;
+    }
+
+    const float period1 = sampleRate / std::max(currentFreq, 1.0f);
+    const float period2 = sampleRate / std::max(currentFreq2, 1.0f);
 
-    const float foldMix = distortionParams.foldMix;
-    const float driveMix = distortionParams.driveMix;
     const float resMix = resonatorParams.mix;
     const float dryMix = 1.0f - resMix;
     const float feedXX = wiringParams.feedXX;
     const float feedYY = wiringParams.feedYY;
     const float feedXY = wiringParams.feedXY;
     const float feedYX = wiringParams.feedYX;
-    const int folds = distortionParams.folds;
 
     float inPeakX = 0.0f;
     float inPeakY = 0.0f;
@@ -297,8 +453,9 @@ void AudioCallback(AudioHandle::InputBuffer in,
         const float inX = SoftClipSample(in[0][i]);
         const float inY = SoftClipSample(in[1][i]);
 
-        const float resX = delays.Read1();
-        const float resY = delays.Read2();
+        const float periodScale = FastExp2(octaveStep * static_cast<float>(size - 1 - i));
+        const float resX = delays.ReadAt1(interp, period1 * periodScale - loopLatency);
+        const float resY = delays.ReadAt2(interp, period2 * periodScale - loopLatency);
 
         const float filteredX = feedFilters.ProcessX(resX);
         const float filteredY = feedFilters.ProcessY(resY);
@@ -307,15 +464,8 @@ void AudioCallback(AudioHandle::InputBuffer in,
         const float preDistX = inX + filteredX * feedXX + filteredY * feedYX;
         const float preDistY = inY + filteredY * feedYY + filteredX * feedXY;
 
-        const float foldX = ApplyWavefolder(preDistX, waveDepth, folds);
-        const float foldY = ApplyWavefolder(preDistY, waveDepth, folds);
-        const float foldMixX = preDistX + (foldX - preDistX) * foldMix;
-        const float foldMixY = preDistY + (foldY - preDistY) * foldMix;
-
-        const float driveX = ApplyOverdrive(foldMixX, waveDepth);
-        const float driveY = ApplyOverdrive(foldMixY, waveDepth);
-        const float driveMixX = foldMixX + (driveX - foldMixX) * driveMix;
-        const float driveMixY = foldMixY + (driveY - foldMixY) * driveMix;
+        const float driveMixX = distortionX.Shape(preDistX, shape);
+        const float driveMixY = distortionY.Shape(preDistY, shape);
 
         inPeakX = std::max(inPeakX, std::fabs(preDistX));
         inPeakY = std::max(inPeakY, std::fabs(preDistY));
@@ -325,19 +475,18 @@ void AudioCallback(AudioHandle::InputBuffer in,
         const float makeupX = distortionX.ApplyMakeup(driveMixX);
         const float makeupY = distortionY.ApplyMakeup(driveMixY);
 
-        // Blend folded and overdriven signals before the resonators.
-        delays.Write1(SoftClipSample(makeupX));
-        delays.Write2(SoftClipSample(makeupY));
+        // Soft clip the made-up signal before the resonators.
+        delays.Write1(distortionX.Clip(makeupX, shape.adaa));
+        delays.Write2(distortionY.Clip(makeupY, shape.adaa));
 
         out[0][i] = dryMix * inX + resMix * resX;
         out[1][i] = dryMix * inY + resMix * resY;
     }
 
-    if (!calibMode)
-    {
-        distortionX.UpdateMakeup(inPeakX, outPeakX);
-        distortionY.UpdateMakeup(inPeakY, outPeakY);
-    }
+    pairInPeakX = std::max(pairInPeakX, inPeakX);
+    pairInPeakY = std::max(pairInPeakY, inPeakY);
+    pairOutPeakX = std::max(pairOutPeakX, outPeakX);
+    pairOutPeakY = std::max(pairOutPeakY, outPeakY);
 }
 
 int main(void)
@@ -346,9 +495,11 @@ int main(void)
     hw.StartAdc();
 
     sampleRate = hw.AudioSampleRate();
+    pitchOctaves = std::log2(currentFreq);
 
     delays.Init();
     feedFilters.Init(sampleRate);
+    network.Init(sampleRate, &networkLines);
 
     distortionX.Reset();
     distortionY.Reset();
@@ -370,9 +521,14 @@ int main(void)
     hw.display.WriteString("Booting...", Font_6x8, true);
     hw.display.Update();
 
+    scheduler.Init(sampleRate, System::GetTickFreq());
+    const float makeupSettle = scheduler.SmoothingCoefficient(DistortionChannel::kMakeupSettleSeconds);
+    const float makeupTrack = scheduler.SmoothingCoefficient(DistortionChannel::kMakeupTrackSeconds);
+    distortionX.SetMakeupCoefficients(makeupSettle, makeupTrack);
+    distortionY.SetMakeupCoefficients(makeupSettle, makeupTrack);
+    network.SetMakeupCoefficients(makeupSettle, makeupTrack);
     hw.StartAudio(AudioCallback);
 
-    uint32_t lastDisplayUpdate = 0;
     while (1)
     {
         UpdateControls();
@@ -390,14 +546,13 @@ int main(void)
             hw.seed.SetLed(ledOn);
             lastLedMs = now;
         }
-        if (now - lastDisplayUpdate > 33)
+        if (scheduler.UiDue(System::GetTick()))
         {
             if (showSaveConfirm && now > saveConfirmUntilMs)
             {
                 showSaveConfirm = false;
             }
             RenderDisplay(hw, BuildDisplayData());
-            lastDisplayUpdate = now;
         }
     }
 }
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#include "fdn.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBenchSamples = 48000;
+constexpr int kPasses = 3;
+constexpr size_t kBlockSize = 48;
+constexpr float kNormTolerance = 1.0e-5f;
+constexpr size_t kLineCounts[] = {4, 8};
+constexpr float kCouplings[] = {0.0f, 0.25f, 0.5f, 0.75f, 1.0f};
+constexpr float kDecayFeedback = 0.9f;
+
+using Clock = std::chrono::steady_clock;
+
+FdnLines s_lines;
+
+struct MatrixCase
+{
+    const char *name;
+    FdnMatrix matrix;
+};
+
+const MatrixCase kMatrices[] = {
+    {"householder", FdnMatrix::Householder},
+    {"hadamard", FdnMatrix::Hadamard},
+};
+
+// The mix must stay orthogonal at every coupling, or the network gains or
+// loses energy through the matrix alone. This runs the blend exactly as
+// ProcessSample() applies it.
+float MaxNormError(FdnMatrix matrix, size_t count)
+{
+    float maxErr = 0.0f;
+    for (float coupling : kCouplings)
+    {
+        FdnCoupling mix;
+        mix.Set(matrix, coupling);
+        for (int trial = 0; trial < 100; ++trial)
+        {
+            float v[kFdnMaxLines];
+            float before = 0.0f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                v[i] = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+                before += v[i] * v[i];
+            }
+            mix.Apply(v, count);
+            float after = 0.0f;
+            for (size_t i = 0; i < count; ++i)
+                after += v[i] * v[i];
+            maxErr = std::max(maxErr, std::fabs(after - before) / before);
+        }
+    }
+    return maxErr;
+}
+
+// Smallest entry of the full-coupling matrix: every line must feed every
+// other, not just be permuted.
+float MinCoupling(FdnMatrix matrix, size_t count)
+{
+    FdnCoupling mix;
+    mix.Set(matrix, 1.0f);
+    float smallest = 1.0f;
+    for (size_t j = 0; j < count; ++j)
+    {
+        float v[kFdnMaxLines]{};
+        v[j] = 1.0f;
+        mix.Apply(v, count);
+        for (size_t i = 0; i < count; ++i)
+            smallest = std::min(smallest, std::fabs(v[i]));
+    }
+    return smallest;
+}
+
+FeedbackDelayNetwork::Settings BenchSettings(FdnMatrix matrix)
+{
+    FeedbackDelayNetwork::Settings settings;
+    settings.freqX = 110.0f;
+    settings.freqY = 165.0f;
+    settings.spread = 0.7f;
+    settings.feedback = 0.95f;
+    settings.coupling = 1.0f;
+    settings.matrix = matrix;
+    return settings;
+}
+
+FoldDriveSettings BenchShape()
+{
+    FoldDriveSettings shape;
+    shape.depth = 0.5f;
+    shape.folds = 3;
+    shape.foldMix = 0.5f;
+    shape.driveMix = 0.3f;
+    return shape;
+}
+
+double NsPerSample(size_t lines, FdnMatrix matrix)
+{
+    static FeedbackDelayNetwork fdn;
+    const FeedbackDelayNetwork::Settings settings = BenchSettings(matrix);
+    const FoldDriveSettings shape = BenchShape();
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        fdn.Init(kSampleRate, &s_lines);
+        fdn.SetLineCount(lines);
+        float sum = 0.0f;
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kBenchSamples; n += kBlockSize)
+        {
+            fdn.Prepare(settings, shape, 0);
+            for (size_t i = 0; i < kBlockSize; ++i)
+            {
+                // A short noise burst, then the tail rings out.
+                const bool excite = n + i < 480;
+                const float inX = excite ? static_cast<float>(rand()) / RAND_MAX - 0.5f : 0.0f;
+                const float inY = excite ? static_cast<float>(rand()) / RAND_MAX - 0.5f : 0.0f;
+                float outX = 0.0f;
+                float outY = 0.0f;
+                fdn.ProcessSample(inX, inY, shape, outX, outY);
+                sum += outX + outY;
+            }
+            fdn.UpdateMakeup();
+        }
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        if (!std::isfinite(sum))
+            return -1.0;
+    }
+    return best / kBenchSamples;
+}
+
+// Energy of the last quarter of the tail over the third, in dB, for the
+// slowest-decaying coupling. Shaping is off and feedback fixed below one,
+// so with a lossless mix the tail has to fall at least as fast as the
+// longest line alone would at that feedback.
+double TailDecayDb(size_t lines, FdnMatrix matrix)
+{
+    static FeedbackDelayNetwork fdn;
+    FeedbackDelayNetwork::Settings settings = BenchSettings(matrix);
+    settings.feedback = kDecayFeedback;
+    settings.filterLevel = 0.0f; // The damping filter's delay would lengthen the loops
+    const FoldDriveSettings shape;
+    double worst = -1.0e30;
+    for (float coupling : kCouplings)
+    {
+        settings.coupling = coupling;
+        fdn.Init(kSampleRate, &s_lines);
+        fdn.SetLineCount(lines);
+        double third = 0.0;
+        double fourth = 0.0;
+        for (size_t n = 0; n < kBenchSamples; n += kBlockSize)
+        {
+            fdn.Prepare(settings, shape, 0);
+            for (size_t i = 0; i < kBlockSize; ++i)
+            {
+                const bool excite = n + i < 480;
+                const float inX = excite ? static_cast<float>(rand()) / RAND_MAX - 0.5f : 0.0f;
+                const float inY = excite ? static_cast<float>(rand()) / RAND_MAX - 0.5f : 0.0f;
+                float outX = 0.0f;
+                float outY = 0.0f;
+                fdn.ProcessSample(inX, inY, shape, outX, outY);
+                const double energy = static_cast<double>(outX) * outX + static_cast<double>(outY) * outY;
+                if (n + i >= 3 * kBenchSamples / 4)
+                    fourth += energy;
+                else if (n + i >= kBenchSamples / 2)
+                    third += energy;
+            }
+            fdn.UpdateMakeup();
+        }
+        if (!(third > 0.0) || !std::isfinite(fourth))
+            return 0.0;
+        worst = std::max(worst, 10.0 * std::log10(std::max(fourth, 1.0e-300) / third));
+    }
+    return worst;
+}
+
+// Decay over one quarter of the longest line's loop at kDecayFeedback.
+double MaxTailDecayDb(FdnMatrix matrix)
+{
+    const FeedbackDelayNetwork::Settings settings = BenchSettings(matrix);
+    const double longestPeriod = kSampleRate / std::min(settings.freqX, settings.freqY);
+    const double trips = static_cast<double>(kBenchSamples / 4) / longestPeriod;
+    return 20.0 * trips * std::log10(static_cast<double>(kDecayFeedback));
+}
+} // namespace
+
+int main()
+{
+    srand(1);
+    std::printf("FDN resonator, stereo, %zu-sample blocks, best of %d passes\n", kBlockSize, kPasses);
+    std::printf("Tail: last quarter over third at feedback %.2f, shaping off, worst coupling\n",
+                static_cast<double>(kDecayFeedback));
+    std::printf("%6s%13s%12s%10s%12s%12s%10s%10s\n", "lines", "matrix", "norm err", "min coup", "ns/sample",
+                "ns/line", "tail dB", "max dB");
+
+    bool ok = true;
+    for (size_t lines : kLineCounts)
+    {
+        for (const MatrixCase &m : kMatrices)
+        {
+            const float normErr = MaxNormError(m.matrix, lines);
+            const float minCoupling = MinCoupling(m.matrix, lines);
+            const double ns = NsPerSample(lines, m.matrix);
+            const double tailDb = TailDecayDb(lines, m.matrix);
+            const double maxTailDb = MaxTailDecayDb(m.matrix);
+            const bool pass = ns >= 0.0 && normErr <= kNormTolerance
+                              && minCoupling >= 1.0f / static_cast<float>(lines) && tailDb <= maxTailDb;
+            ok = ok && pass;
+            std::printf("%6zu%13s%12.1e%10.3f%12.1f%12.1f%10.1f%10.1f%s\n", lines, m.name,
+                        static_cast<double>(normErr), static_cast<double>(minCoupling), ns,
+                        ns / static_cast<double>(lines), tailDb, maxTailDb, pass ? "" : "  FAIL");
+        }
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "FDN bench failed (mix not orthogonal or not fully coupled, tail decaying too slowly "
+                             "or non-finite output).\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+#include "delay_lines.h"
+#include "distortion.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kDelaySize = 1024;
+constexpr double kPi = 3.14159265358979323846;
+constexpr size_t kSettle = 256;
+constexpr size_t kWindow = 8192;
+constexpr float kProbeAmp = 1.0e-3f;    // Small enough that the soft clip is linear
+constexpr float kAboveCeiling = 1.19f;  // A quarter octave past the ceiling
+constexpr double kMaxCentsError = 15.0; // Thiran detunes near the top, see interp-bench
+
+const char *const kInterpNames[kDelayInterpolationCount] = {"linear", "hermite", "lagrange", "thiran"};
+const char *const kFactorNames[Oversampler::kMaxFactorIndex + 1] = {"off", "2x", "4x", "8x"};
+
+// The pair's loop as main.cpp runs it, opened up and without the feed
+// filters: a sine at `probe` Hz is shaped (linear here), soft clipped and
+// written to the line, which is read `latency` samples short of the period
+// for `freq`. Returns the delay round the loop at the probe frequency, in
+// samples. The loop rings at `probe` when that is exactly one period of
+// it; phase is what tunes a comb, whatever its damping does to the peak.
+double LoopDelay(int oversample, bool adaa, DelayInterpolation interp, float freq, float probe)
+{
+    static DelayBuffer<kDelaySize> line;
+    line.Init();
+    DistortionChannel channel;
+    channel.Reset();
+    channel.Prepare(oversample);
+    FoldDriveSettings shape;
+    shape.adaa = adaa;
+
+    const float delay = kSampleRate / freq - channel.Latency(adaa);
+    const double omega = 2.0 * kPi * probe / kSampleRate;
+    double inRe = 0.0;
+    double inIm = 0.0;
+    double outRe = 0.0;
+    double outIm = 0.0;
+    for (size_t n = 0; n < kSettle + kWindow; ++n)
+    {
+        const double phase = omega * static_cast<double>(n);
+        const float in = kProbeAmp * static_cast<float>(std::sin(phase));
+        const float out = line.ReadAt(interp, delay);
+        line.Write(channel.Clip(channel.Shape(in, shape), adaa));
+        if (n < kSettle)
+            continue;
+        inRe += in * std::cos(phase);
+        inIm -= in * std::sin(phase);
+        outRe += out * std::cos(phase);
+        outIm -= out * std::sin(phase);
+    }
+
+    // Phase lag of out behind in, taken as the offset from one period.
+    const double lag = std::atan2(inIm * outRe - inRe * outIm, inRe * outRe + inIm * outIm);
+    return kSampleRate / probe + lag / omega;
+}
+
+// Pitch error of a loop `delay` samples long against `target` Hz.
+double Cents(double delay, float target)
+{
+    return 1200.0 * std::log2(kSampleRate / (delay * target));
+}
+} // namespace
+
+int main()
+{
+    std::printf("Loop pitch at the top of the range, cents off; above: a request %.0f%% past the ceiling\n",
+                (kAboveCeiling - 1.0f) * 100.0f);
+    std::printf("%8s%6s%10s%10s%10s%16s\n", "OS", "ADAA", "interp", "top Hz", "cents", "above: cents");
+
+    bool ok = true;
+    for (int oversample = 0; oversample <= Oversampler::kMaxFactorIndex; ++oversample)
+    {
+        for (int adaa = 0; adaa <= 1; ++adaa)
+        {
+            for (int mode = 0; mode < kDelayInterpolationCount; ++mode)
+            {
+                const DelayInterpolation interp = static_cast<DelayInterpolation>(mode);
+                DistortionChannel channel;
+                channel.Prepare(oversample);
+                const float ceiling = MaxLoopFreq(kSampleRate, channel.Latency(adaa != 0), interp);
+                const float top = std::min(kResonatorMaxFreq, ceiling);
+
+                // The top of the range is on pitch. Where the ceiling is what
+                // sets it, a higher request still rings at the ceiling: that
+                // is where the read delay clamps, so the limit is not
+                // stricter than it has to be.
+                const double atTop = Cents(LoopDelay(oversample, adaa != 0, interp, top, top), top);
+                bool pass = std::fabs(atTop) <= kMaxCentsError;
+                char above[16] = "-";
+                if (ceiling < kResonatorMaxFreq)
+                {
+                    const double cents =
+                        Cents(LoopDelay(oversample, adaa != 0, interp, ceiling * kAboveCeiling, ceiling), ceiling);
+                    pass = pass && std::fabs(cents) <= kMaxCentsError;
+                    std::snprintf(above, sizeof(above), "%.1f", cents);
+                }
+                ok = ok && pass;
+                std::printf("%8s%6s%10s%10.0f%10.1f%16s%s\n", kFactorNames[oversample], adaa ? "on" : "off",
+                            kInterpNames[mode], top, atTop, above, pass ? "" : "  FAIL");
+            }
+        }
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "Loop pitch test failed (off pitch at the ceiling, or the ceiling is not where it stalls).\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#include "delay_lines.h"
+#include "fast_exp2.h"
+
+namespace
+{
+constexpr float kMinOctaves = -12.0f; // Period scales for the largest in-block sweeps
+constexpr float kMaxOctaves = 14.0f;  // ~16 kHz
+constexpr size_t kSweepPoints = 1 << 20;
+constexpr size_t kBenchSamples = 1 << 16;
+constexpr int kPasses = 5;
+constexpr double kMaxCentsError = 0.01;
+constexpr size_t kDelaySize = 8192;
+
+using Clock = std::chrono::steady_clock;
+
+double MaxCentsError()
+{
+    double worst = 0.0;
+    for (size_t n = 0; n <= kSweepPoints; ++n)
+    {
+        const float x = kMinOctaves + (kMaxOctaves - kMinOctaves) * static_cast<float>(n) / kSweepPoints;
+        const double exact = std::exp2(static_cast<double>(x));
+        const double cents = 1200.0 * std::fabs(std::log2(static_cast<double>(FastExp2(x)) / exact));
+        worst = std::max(worst, cents);
+    }
+    // Just below integers, where the fraction can round up to one.
+    for (int k = -12; k <= 14; ++k)
+    {
+        const float x = std::nextafter(static_cast<float>(k), -100.0f);
+        const double cents = 1200.0 * std::fabs(std::log2(static_cast<double>(FastExp2(x)) / std::exp2(static_cast<double>(x))));
+        worst = std::max(worst, cents);
+    }
+    return worst;
+}
+
+template <typename Fn>
+double NsPerCall(Fn fn)
+{
+    static float in[kBenchSamples];
+    srand(1);
+    for (float &v : in)
+        v = kMinOctaves + (kMaxOctaves - kMinOctaves) * static_cast<float>(rand()) / RAND_MAX;
+
+    double best = 1.0e30;
+    volatile float sink = 0.0f;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        float acc = 0.0f;
+        const auto start = Clock::now();
+        for (float x : in)
+            acc += fn(x);
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        sink = acc;
+    }
+    (void)sink;
+    return best / kBenchSamples;
+}
+
+// ReadAt with the stored delay must match Read exactly, and must clamp the
+// same way SetDelay does.
+bool ReadAtMatchesRead()
+{
+    static DelayBuffer<kDelaySize> line;
+    line.Init();
+    srand(2);
+    for (size_t n = 0; n < 3 * kDelaySize; ++n)
+    {
+        const float delay = static_cast<float>(rand()) / RAND_MAX * (kDelaySize + 200.0f) - 100.0f;
+        line.SetDelay(delay);
+        if (line.Read() != line.ReadAt(delay))
+            return false;
+        line.Write(static_cast<float>(rand()) / RAND_MAX - 0.5f);
+    }
+    return true;
+}
+} // namespace
+
+int main()
+{
+    const double cents = MaxCentsError();
+    const bool exact = ReadAtMatchesRead();
+    const double fastNs = NsPerCall([](float x) { return FastExp2(x); });
+    const double libNs = NsPerCall([](float x) { return std::exp2(x); });
+    const double powNs = NsPerCall([](float x) { return std::pow(2.0f, x); });
+
+    std::printf("FastExp2 over [%.0f, %.0f] octaves: max error %.5f cents%s\n",
+                static_cast<double>(kMinOctaves), static_cast<double>(kMaxOctaves), cents,
+                cents <= kMaxCentsError ? "" : "  FAIL");
+    std::printf("ns/call: FastExp2 %.2f, exp2f %.2f, powf %.2f\n", fastNs, libNs, powNs);
+    std::printf("DelayBuffer::ReadAt matches Read: %s\n", exact ? "yes" : "no  FAIL");
+
+    if (cents > kMaxCentsError || !exact)
+    {
+        std::fprintf(stderr, "Pitch bench failed (FastExp2 accuracy or ReadAt mismatch).\n");
+        return 1;
+    }
+    return 0;
+}
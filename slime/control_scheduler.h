@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-rate control scheduling between the audio interrupt and the main
+// loop.
+//
+// The control task (knobs, CV and the parameters mapped from them) runs in
+// the audio callback once every SamplesPerTick() samples. The audio clock is
+// the timer, so the control rate stays at ControlRate() however long the
+// main loop spends on an OLED frame, and anything smoothed once per tick can
+// take its coefficient from a time constant. The UI task (encoder, menus,
+// display, storage) stays in the main loop at UiRate(), where the audio
+// interrupt preempts it.
+//
+// A control tick misses its deadline when it runs one control period or more
+// after it was due. Blocks are timed on a free-running counter
+// (System::GetTick() on the Daisy). A callback that starts that much later
+// than the block before it implies was held off or followed an overrun, and
+// the ticks that fell in the gap are counted as misses.
+class ControlScheduler
+{
+public:
+    static constexpr float kControlRate = 1000.0f;
+    static constexpr float kUiRate = 30.0f;
+
+    void Init(float sampleRate, uint32_t tickFrequency, float controlRate = kControlRate,
+              float uiRate = kUiRate)
+    {
+        const float samples = std::round(sampleRate / controlRate);
+        samplesPerTick_ = samples >= 1.0f ? static_cast<uint32_t>(samples) : 1u;
+        controlRate_ = sampleRate / static_cast<float>(samplesPerTick_);
+        uiRate_ = uiRate;
+        ticksPerSample_ = static_cast<float>(tickFrequency) / sampleRate;
+        controlPeriodTicks_ = PeriodTicks(tickFrequency, controlRate_);
+        uiPeriodTicks_ = PeriodTicks(tickFrequency, uiRate);
+        samplesToTick_ = 0;
+        blockTicks_ = 0;
+        lastBlockTick_ = 0;
+        blockStarted_ = false;
+        lastUiTick_ = 0;
+        uiStarted_ = false;
+        controlTicks_.store(0, std::memory_order_relaxed);
+        misses_.store(0, std::memory_order_relaxed);
+    }
+
+    // Audio callback, on entry, with the counter read there. Returns how many
+    // control ticks fall due before the end of this block of `size` samples.
+    // Run them, then render the block.
+    size_t BeginBlock(size_t size, uint32_t tick)
+    {
+        if (blockStarted_)
+        {
+            const int32_t late = static_cast<int32_t>(tick - lastBlockTick_ - blockTicks_);
+            if (late >= static_cast<int32_t>(controlPeriodTicks_))
+            {
+                misses_.fetch_add(static_cast<uint32_t>(late) / controlPeriodTicks_, std::memory_order_relaxed);
+            }
+        }
+        blockStarted_ = true;
+        lastBlockTick_ = tick;
+        blockTicks_ = static_cast<uint32_t>(static_cast<float>(size) * ticksPerSample_);
+
+        size_t due = 0;
+        while (samplesToTick_ < size)
+        {
+            samplesToTick_ += samplesPerTick_;
+            ++due;
+        }
+        samplesToTick_ -= static_cast<uint32_t>(size);
+        controlTicks_.fetch_add(static_cast<uint32_t>(due), std::memory_order_relaxed);
+        return due;
+    }
+
+    // Main loop: true once a UI period has passed since the last frame.
+    bool UiDue(uint32_t tick)
+    {
+        if (uiStarted_ && tick - lastUiTick_ < uiPeriodTicks_)
+        {
+            return false;
+        }
+        uiStarted_ = true;
+        lastUiTick_ = tick;
+        return true;
+    }
+
+    // One-pole coefficient for a time constant in seconds, applied once per
+    // control tick as y += (x - y) * coefficient.
+    float SmoothingCoefficient(float seconds) const
+    {
+        if (seconds <= 0.0f)
+        {
+            return 1.0f;
+        }
+        return 1.0f - std::exp(-1.0f / (seconds * controlRate_));
+    }
+
+    float ControlRate() const
+    {
+        return controlRate_;
+    }
+
+    float UiRate() const
+    {
+        return uiRate_;
+    }
+
+    uint32_t SamplesPerTick() const
+    {
+        return samplesPerTick_;
+    }
+
+    uint32_t ControlTicks() const
+    {
+        return controlTicks_.load(std::memory_order_relaxed);
+    }
+
+    uint32_t DeadlineMisses() const
+    {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static uint32_t PeriodTicks(uint32_t tickFrequency, float rate)
+    {
+        const uint32_t ticks = static_cast<uint32_t>(static_cast<float>(tickFrequency) / rate);
+        return ticks > 0 ? ticks : 1u;
+    }
+
+    uint32_t samplesPerTick_ = 48;
+    float controlRate_ = kControlRate;
+    float uiRate_ = kUiRate;
+    float ticksPerSample_ = 1.0f;
+    uint32_t controlPeriodTicks_ = 1;
+    uint32_t uiPeriodTicks_ = 1;
+
+    // Audio callback side.
+    uint32_t samplesToTick_ = 0;
+    uint32_t blockTicks_ = 0;
+    uint32_t lastBlockTick_ = 0;
+    bool blockStarted_ = false;
+
+    // Main loop side.
+    uint32_t lastUiTick_ = 0;
+    bool uiStarted_ = false;
+
+    std::atomic<uint32_t> controlTicks_{0};
+    std::atomic<uint32_t> misses_{0};
+};
@@ -74,15 +74,18 @@ void RenderDisplay(Bluemchen &hw, const DisplayData &data)
         snprintf(buf, sizeof(buf), "LIM %s", data.limitSpectrum ? "ON" : "OFF");
         break;
     case 14:
-        snprintf(buf, sizeof(buf), "IN");
+        snprintf(buf, sizeof(buf), "F%d", data.fftSize);
         break;
     case 15:
-        snprintf(buf, sizeof(buf), "WET");
+        snprintf(buf, sizeof(buf), "IN");
         break;
     case 16:
-        snprintf(buf, sizeof(buf), "CPU");
+        snprintf(buf, sizeof(buf), "WET");
         break;
     case 17:
+        snprintf(buf, sizeof(buf), "CPU");
+        break;
+    case 18:
         snprintf(buf, sizeof(buf), "KNB");
         break;
     default:
@@ -92,6 +95,19 @@ void RenderDisplay(Bluemchen &hw, const DisplayData &data)
     hw.display.WriteString(buf, Font_6x8, true);
 
     if (data.menuPage == 14)
+    {
+        // FFT size page: latency of one frame and the load it costs.
+        const int latency = static_cast<int>(data.latencyMs + 0.5f);
+        const int load = static_cast<int>(data.cpuPercent + 0.5f);
+        hw.display.SetCursor(0, 8);
+        snprintf(buf, sizeof(buf), "LT%3d", latency);
+        hw.display.WriteString(buf, Font_6x8, true);
+
+        hw.display.SetCursor(0, 16);
+        snprintf(buf, sizeof(buf), "LD%3d", load);
+        hw.display.WriteString(buf, Font_6x8, true);
+    }
+    else if (data.menuPage == 15)
     {
         const int pin = static_cast<int>(data.peakIn * 1000.0f + 0.5f);
         const int pclip = static_cast<int>(data.peakInClip * 1000.0f + 0.5f);
@@ -108,7 +124,7 @@ void RenderDisplay(Bluemchen &hw, const DisplayData &data)
         snprintf(buf, sizeof(buf), "OT%4d", pout);
         hw.display.WriteString(buf, Font_6x8, true);
     }
-    else if (data.menuPage == 15)
+    else if (data.menuPage == 16)
     {
         const int pwet = static_cast<int>(data.peakWet * 1000.0f + 0.5f);
         const int p1 = static_cast<int>(data.peak1 * 1000.0f + 0.5f);
@@ -125,7 +141,7 @@ void RenderDisplay(Bluemchen &hw, const DisplayData &data)
         snprintf(buf, sizeof(buf), "M2%4d", p2);
         hw.display.WriteString(buf, Font_6x8, true);
     }
-    else if (data.menuPage == 16)
+    else if (data.menuPage == 17)
     {
         const int load = static_cast<int>(data.cpuPercent + 0.5f);
         const int ms = static_cast<int>(data.cpuMs * 10.0f + 0.5f);
@@ -134,6 +150,11 @@ void RenderDisplay(Bluemchen &hw, const DisplayData &data)
         snprintf(buf, sizeof(buf), "LD%3d", load);
         hw.display.WriteString(buf, Font_6x8, true);
 
+        // Control ticks run late since boot, pinned at 99.
+        hw.display.SetCursor(40, 8);
+        snprintf(buf, sizeof(buf), "DM%2u", static_cast<unsigned>(std::min<uint32_t>(data.deadlineMisses, 99)));
+        hw.display.WriteString(buf, Font_6x8, true);
+
         hw.display.SetCursor(0, 16);
         snprintf(buf, sizeof(buf), "MS%3d", ms);
         hw.display.WriteString(buf, Font_6x8, true);
@@ -142,7 +163,7 @@ void RenderDisplay(Bluemchen &hw, const DisplayData &data)
         snprintf(buf, sizeof(buf), "BD%3d", budget);
         hw.display.WriteString(buf, Font_6x8, true);
     }
-    else if (data.menuPage == 17)
+    else if (data.menuPage == 18)
     {
         hw.display.SetCursor(0, 8);
         snprintf(buf, sizeof(buf), "K1%04X", data.rawK1);
@@ -21,6 +21,9 @@ struct DisplayData
     float       cpuPercent = 0.0f;
     float       cpuMs = 0.0f;
     float       cpuBudgetMs = 0.0f;
+    uint32_t    deadlineMisses = 0;
+    int         fftSize = 1024;
+    float       latencyMs = 0.0f;
     float       preserve = 0.2f;
     float       spectralGain = 1.0f;
     float       ifftGain = 1.0f;
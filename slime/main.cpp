@@ -4,6 +4,7 @@
 #include "daisy_seed.h"
 #include "kxmx_bluemchen.h"
 
+#include "control_scheduler.h"
 #include "display.h"
 #include "encoder_handler.h"
 #include "spectral_processor.h"
@@ -23,7 +24,9 @@ constexpr float kInputGain = 1.2f;  // Balanced to prevent distortion while main
 constexpr float kOutputGain = 0.9f;
 constexpr float kWetTrim = 0.8f;
 constexpr float kPeakDecay = 0.95f;
-constexpr size_t kDryDelaySamples = SpectralChannel::kFftSize;
+constexpr size_t kWindowSize = SpectralChannel::kMaxFftSize;
+constexpr size_t kDryDelaySamples = SpectralChannel::kMaxFftSize;
+constexpr int kMenuPageCount = 19;
 
 float MapExpo(float value, float minVal, float maxVal)
 {
@@ -31,12 +34,14 @@ float MapExpo(float value, float minVal, float maxVal)
     return minVal * powf(maxVal / minVal, value);
 }
 
-float windowSqrtHann[1024];
-float windowHann[1024];
-float windowBlackman[1024];
-float windowSine[1024];
-float windowRect[1024];
-float windowKaiser[1024];
+// Windows are built at the largest FFT size; smaller frames read them at a
+// stride. Too big for internal SRAM alongside the channel pools, so SDRAM.
+float DSY_SDRAM_BSS windowSqrtHann[kWindowSize];
+float DSY_SDRAM_BSS windowHann[kWindowSize];
+float DSY_SDRAM_BSS windowBlackman[kWindowSize];
+float DSY_SDRAM_BSS windowSine[kWindowSize];
+float DSY_SDRAM_BSS windowRect[kWindowSize];
+float DSY_SDRAM_BSS windowKaiser[kWindowSize];
 float kaiserBeta = 6.0f;
 
 float BesselI0(float x)
@@ -77,9 +82,9 @@ void BuildKaiserWindow(float beta, float *out, size_t size)
 
 void BuildWindows()
 {
-    for (size_t i = 0; i < 1024; ++i)
+    for (size_t i = 0; i < kWindowSize; ++i)
     {
-        const float phase = static_cast<float>(i) / 1024.0f;
+        const float phase = static_cast<float>(i) / static_cast<float>(kWindowSize);
         const float hann = 0.5f - 0.5f * cosf(2.0f * static_cast<float>(M_PI) * phase);
         windowHann[i] = hann;
         windowSqrtHann[i] = sqrtf(std::max(hann, 0.0f));
@@ -93,7 +98,7 @@ void BuildWindows()
         windowSine[i] = sinf(static_cast<float>(M_PI) * phase);
         windowRect[i] = 1.0f;
     }
-    BuildKaiserWindow(kaiserBeta, windowKaiser, 1024);
+    BuildKaiserWindow(kaiserBeta, windowKaiser, kWindowSize);
 }
 
 float SoftClipInput(float sample)
@@ -122,8 +127,11 @@ float ApplyWetClamp(float sample, int mode)
 } // namespace
 
 Bluemchen hw;
+SpectralChannelBuffers DSY_SDRAM_BSS channelBuffers1;
+SpectralChannelBuffers DSY_SDRAM_BSS channelBuffers2;
 SpectralChannel channel1;
 SpectralChannel channel2;
+ControlScheduler scheduler;
 
 EncoderState encoderState;
 int menuPageIndex = 0;
@@ -144,6 +152,7 @@ bool phaseContinuity = true;
 int wetClampMode = 1;
 bool normalizeSpectrum = true;
 bool limitSpectrum = true;
+int fftSizeIndex = 2;
 float peak1 = 0.0f;
 float peak2 = 0.0f;
 float peakIn = 0.0f;
@@ -158,8 +167,8 @@ uint16_t rawK1 = 0;
 uint16_t rawK2 = 0;
 uint16_t rawCv1 = 0;
 uint16_t rawCv2 = 0;
-float dryDelayL[kDryDelaySamples]{};
-float dryDelayR[kDryDelaySamples]{};
+float DSY_SDRAM_BSS dryDelayL[kDryDelaySamples];
+float DSY_SDRAM_BSS dryDelayR[kDryDelaySamples];
 size_t dryDelayIndex = 0;
 
 const float *windowPtrs[] = {windowSqrtHann, windowHann, windowBlackman, windowSine, windowRect, windowKaiser};
@@ -220,7 +229,7 @@ void UpdateControls()
         }
         case 9:
             kaiserBeta = std::clamp(kaiserBeta + inc * 0.5f, 0.0f, 12.0f);
-            BuildKaiserWindow(kaiserBeta, windowKaiser, 1024);
+            BuildKaiserWindow(kaiserBeta, windowKaiser, kWindowSize);
             if (windowIndex == 5)
             {
                 channel1.SetWindow(windowKaiser);
@@ -239,14 +248,20 @@ void UpdateControls()
         case 13:
             limitSpectrum = !limitSpectrum;
             break;
+        case 14:
+            fftSizeIndex = std::clamp(fftSizeIndex + inc, 0, static_cast<int>(kSpectralNumFftSizes) - 1);
+            channel1.SetFftSize(SpectralFftSizeAt(fftSizeIndex));
+            channel2.SetFftSize(SpectralFftSizeAt(fftSizeIndex));
+            break;
         default:
             break;
         }
     }
 
-    UpdateEncoder(hw, encoderState, 18, menuPageIndex);
+    UpdateEncoder(hw, encoderState, kMenuPageCount, menuPageIndex);
 }
 
+// Audio callback, at the control rate.
 void UpdateAnalogControls()
 {
     hw.ProcessAnalogControls();
@@ -279,6 +294,10 @@ void AudioCallback(AudioHandle::InputBuffer in,
                    size_t size)
 {
     const uint32_t callbackStart = System::GetNow();
+    for (size_t ticks = scheduler.BeginBlock(size, System::GetTick()); ticks > 0; --ticks)
+    {
+        UpdateAnalogControls();
+    }
     const float time1 = std::clamp(timeBase, kMinTime, kMaxTime);
     const float time2 = std::clamp(timeBase * timeRatio, kMinTime, kMaxTime);
     const float wetMix = mix;
@@ -290,6 +309,8 @@ void AudioCallback(AudioHandle::InputBuffer in,
     float localPeakOut = 0.0f;
     float localPeakInClip = 0.0f;
     float localPeakWet = 0.0f;
+    // Keep the dry path aligned with the wet path's one-frame latency.
+    const size_t dryDelay = channel1.FftSize();
 
     for (size_t i = 0; i < size; ++i)
     {
@@ -313,8 +334,9 @@ void AudioCallback(AudioHandle::InputBuffer in,
             out[1][i] = SoftClip(sample2);
             continue;
         }
-        const float dry1 = dryDelayL[dryDelayIndex];
-        const float dry2 = dryDelayR[dryDelayIndex];
+        const size_t dryRead = (dryDelayIndex + kDryDelaySamples - dryDelay) % kDryDelaySamples;
+        const float dry1 = dryDelayL[dryRead];
+        const float dry2 = dryDelayR[dryRead];
         dryDelayL[dryDelayIndex] = in1;
         dryDelayR[dryDelayIndex] = in2;
         dryDelayIndex = (dryDelayIndex + 1) % kDryDelaySamples;
@@ -410,6 +432,9 @@ DisplayData BuildDisplay()
     data.cpuPercent = cpuPercent;
     data.cpuMs = cpuMs;
     data.cpuBudgetMs = cpuBudgetMs;
+    data.deadlineMisses = scheduler.DeadlineMisses();
+    data.fftSize = static_cast<int>(channel1.FftSize());
+    data.latencyMs = 1000.0f * static_cast<float>(channel1.FftSize()) / sampleRate;
     return data;
 }
 
@@ -420,16 +445,19 @@ int main(void)
     sampleRate = hw.AudioSampleRate();
 
     BuildWindows();
-    channel1.Init(sampleRate, windowSqrtHann);
-    channel2.Init(sampleRate, windowSqrtHann);
+    std::fill(&dryDelayL[0], &dryDelayL[kDryDelaySamples], 0.0f);
+    std::fill(&dryDelayR[0], &dryDelayR[kDryDelaySamples], 0.0f);
+    channel1.Init(sampleRate, windowSqrtHann, &channelBuffers1);
+    channel2.Init(sampleRate, windowSqrtHann, &channelBuffers2);
+    scheduler.Init(sampleRate, System::GetTickFreq());
 
     hw.StartAudio(AudioCallback);
 
-    uint32_t lastDisplayUpdate = 0;
+    // Knobs and CV are read in the audio callback; the loop keeps the
+    // encoder, menus and display.
     while (1)
     {
         UpdateControls();
-        UpdateAnalogControls();
 
         const uint32_t now = System::GetNow();
         if (now - lastHeartbeatMs > 250)
@@ -437,10 +465,9 @@ int main(void)
             heartbeatOn = !heartbeatOn;
             lastHeartbeatMs = now;
         }
-        if (now - lastDisplayUpdate > 33)
+        if (scheduler.UiDue(System::GetTick()))
         {
             RenderDisplay(hw, BuildDisplay());
-            lastDisplayUpdate = now;
         }
     }
 }
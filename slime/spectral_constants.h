@@ -2,7 +2,19 @@
 
 #include <cstddef>
 
+// FFT size is selectable at runtime from 256 to 4096 in powers of two. Buffers
+// are sized for the largest frame; kSpectralFftSize is the power-on default.
+constexpr size_t kSpectralMinFftSize = 256;
+constexpr size_t kSpectralMaxFftSize = 4096;
+constexpr size_t kSpectralNumFftSizes = 5;
 constexpr size_t kSpectralFftSize = 1024;
+constexpr size_t kSpectralOverlap = 4;
 
-constexpr size_t kSpectralHopSize = 256;
+constexpr size_t kSpectralHopSize = kSpectralFftSize / kSpectralOverlap;
 constexpr size_t kSpectralNumBins = kSpectralFftSize / 2 + 1;
+constexpr size_t kSpectralMaxNumBins = kSpectralMaxFftSize / 2 + 1;
+
+constexpr size_t SpectralFftSizeAt(int index)
+{
+    return kSpectralMinFftSize << index;
+}
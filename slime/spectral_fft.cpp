@@ -7,18 +7,122 @@
 #define M_PI 3.14159265358979323846f
 #endif
 
+namespace
+{
+bool ValidSize(size_t size)
+{
+    return size >= kSpectralMinFftSize && size <= kSpectralMaxFftSize && (size & (size - 1)) == 0;
+}
+} // namespace
+
+bool SpectralFft::tablesBuilt_ = false;
+
+#if defined(SPECTRAL_FFT_CMSIS)
+
+arm_rfft_fast_instance_f32 SpectralFft::rfft_[kSpectralNumFftSizes]{};
+
+namespace
+{
+size_t SizeIndex(size_t size)
+{
+    size_t index = 0;
+    for (size_t n = kSpectralMinFftSize; n < size; n <<= 1)
+    {
+        ++index;
+    }
+    return index;
+}
+} // namespace
+
+const char *SpectralFft::BackendName()
+{
+    return "cmsis";
+}
+
+void SpectralFft::Init()
+{
+    if (tablesBuilt_)
+        return;
+    for (size_t i = 0; i < kSpectralNumFftSizes; ++i)
+    {
+        arm_rfft_fast_init_f32(&rfft_[i], static_cast<uint16_t>(SpectralFftSizeAt(static_cast<int>(i))));
+    }
+    tablesBuilt_ = true;
+}
+
+void SpectralFft::ForwardReal(float *re, float *im, size_t size)
+{
+    if (!ValidSize(size))
+        return;
+
+    // arm_rfft_fast_f32 consumes its input and packs the result as
+    // {DC, Nyquist, Re1, Im1, Re2, Im2, ...}; pack into im, then spread it out.
+    // Every read is at or beyond the slot being written, so this works in place.
+    arm_rfft_fast_f32(&rfft_[SizeIndex(size)], re, im, 0);
+    const float scale = 1.0f / static_cast<float>(size);
+    const size_t half = size / 2;
+    const float dc = im[0];
+    const float nyquist = im[1];
+    for (size_t k = 1; k < half; ++k)
+    {
+        re[k] = im[2 * k] * scale;
+        im[k] = im[2 * k + 1] * scale;
+    }
+    re[0] = dc * scale;
+    im[0] = 0.0f;
+    re[half] = nyquist * scale;
+    im[half] = 0.0f;
+}
+
+void SpectralFft::InverseReal(float *re, float *im, size_t size)
+{
+    if (!ValidSize(size))
+        return;
+
+    // Pack into im in the CMSIS layout, walking down so nothing is overwritten
+    // before it is read. CMSIS scales its inverse by 1/N; undo that here.
+    const float scale = static_cast<float>(size);
+    const size_t half = size / 2;
+    for (size_t k = half - 1; k >= 1; --k)
+    {
+        im[2 * k + 1] = im[k] * scale;
+        im[2 * k] = re[k] * scale;
+    }
+    im[0] = re[0] * scale;
+    im[1] = re[half] * scale;
+    arm_rfft_fast_f32(&rfft_[SizeIndex(size)], im, re, 1);
+}
+
+#else
+
+float    SpectralFft::cosTable_[kSpectralMaxFftSize / 2]{};
+float    SpectralFft::sinTable_[kSpectralMaxFftSize / 2]{};
+uint16_t SpectralFft::bitRev_[kSpectralMaxFftSize]{};
+
+const char *SpectralFft::BackendName()
+{
+    return "portable";
+}
+
 void SpectralFft::Init()
 {
-    for (size_t i = 0; i < kSpectralFftSize / 2; ++i)
+    if (tablesBuilt_)
+        return;
+
+    for (size_t i = 0; i < kSpectralMaxFftSize / 2; ++i)
     {
         const float phase = 2.0f * static_cast<float>(M_PI) * static_cast<float>(i)
-                            / static_cast<float>(kSpectralFftSize);
+                            / static_cast<float>(kSpectralMaxFftSize);
         cosTable_[i] = std::cos(phase);
         sinTable_[i] = std::sin(phase);
     }
 
-    const size_t bits = 10;
-    for (size_t i = 0; i < kSpectralFftSize; ++i)
+    size_t bits = 0;
+    for (size_t n = kSpectralMaxFftSize; n > 1; n >>= 1)
+    {
+        ++bits;
+    }
+    for (size_t i = 0; i < kSpectralMaxFftSize; ++i)
     {
         size_t x = i;
         size_t y = 0;
@@ -29,13 +133,45 @@ void SpectralFft::Init()
         }
         bitRev_[i] = static_cast<uint16_t>(y);
     }
+    tablesBuilt_ = true;
 }
 
-void SpectralFft::Execute(float *re, float *im, bool inverse)
+void SpectralFft::ForwardReal(float *re, float *im, size_t size)
 {
-    for (size_t i = 0; i < kSpectralFftSize; ++i)
+    if (!ValidSize(size))
+        return;
+    std::fill(&im[0], &im[size], 0.0f);
+    Execute(re, im, size, false);
+    im[0] = 0.0f;
+    im[size / 2] = 0.0f;
+}
+
+void SpectralFft::InverseReal(float *re, float *im, size_t size)
+{
+    if (!ValidSize(size))
+        return;
+    // Rebuild the conjugate-symmetric upper half the complex transform needs.
+    const size_t half = size / 2;
+    im[0] = 0.0f;
+    im[half] = 0.0f;
+    for (size_t k = 1; k < half; ++k)
     {
-        const size_t j = bitRev_[i];
+        re[size - k] = re[k];
+        im[size - k] = -im[k];
+    }
+    Execute(re, im, size, true);
+}
+
+void SpectralFft::Execute(float *re, float *im, size_t size, bool inverse)
+{
+    // Reversing log2(max) bits and dropping the low ones equals reversing
+    // log2(size) bits.
+    size_t shift = 0;
+    for (size_t n = kSpectralMaxFftSize; n > size; n >>= 1)
+        ++shift;
+    for (size_t i = 0; i < size; ++i)
+    {
+        const size_t j = bitRev_[i] >> shift;
         if (j > i)
         {
             std::swap(re[i], re[j]);
@@ -43,11 +179,11 @@ void SpectralFft::Execute(float *re, float *im, bool inverse)
         }
     }
 
-    for (size_t size = 2; size <= kSpectralFftSize; size <<= 1)
+    for (size_t span = 2; span <= size; span <<= 1)
     {
-        const size_t half = size >> 1;
-        const size_t step = kSpectralFftSize / size;
-        for (size_t start = 0; start < kSpectralFftSize; start += size)
+        const size_t half = span >> 1;
+        const size_t step = kSpectralMaxFftSize / span;
+        for (size_t start = 0; start < size; start += span)
         {
             for (size_t k = 0; k < half; ++k)
             {
@@ -72,11 +208,13 @@ void SpectralFft::Execute(float *re, float *im, bool inverse)
     // Inverse FFT is not scaled, maintaining unity gain through FFT/IFFT pair
     if (!inverse)
     {
-        const float scale = 1.0f / static_cast<float>(kSpectralFftSize);
-        for (size_t i = 0; i < kSpectralFftSize; ++i)
+        const float scale = 1.0f / static_cast<float>(size);
+        for (size_t i = 0; i < size; ++i)
         {
             re[i] *= scale;
             im[i] *= scale;
         }
     }
 }
+
+#endif
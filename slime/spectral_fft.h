@@ -5,14 +5,44 @@
 
 #include "spectral_constants.h"
 
+#if defined(SPECTRAL_FFT_CMSIS)
+#include "arm_math.h"
+#endif
+
+// Real FFT for any power-of-two size from kSpectralMinFftSize up to
+// kSpectralMaxFftSize. Forward transforms are scaled by 1/N, inverse ones are
+// not, so a round trip has unity gain.
+//
+// Two backends sit behind the same calls. Firmware builds define
+// SPECTRAL_FFT_CMSIS and use arm_rfft_fast_f32, which is tuned for the M7.
+// Host builds use the portable radix-2 transform below, whose twiddle and
+// bit-reversal tables are built once at the largest size and shared: a size-N
+// transform strides through the twiddles by kSpectralMaxFftSize / N and shifts
+// the bit-reversed index down.
 class SpectralFft
 {
   public:
     void Init();
-    void Execute(float *re, float *im, bool inverse);
+
+    // re holds size real samples on entry. On return re/im[0..size/2] hold the
+    // half spectrum with im[0] and im[size/2] zero. Both arrays are used as
+    // scratch up to size.
+    void ForwardReal(float *re, float *im, size_t size);
+    // Takes the half spectrum in re/im[0..size/2] and leaves size real
+    // samples in re. Both arrays are used as scratch up to size.
+    void InverseReal(float *re, float *im, size_t size);
+
+    static const char *BackendName();
 
   private:
-    float    cosTable_[kSpectralFftSize / 2]{};
-    float    sinTable_[kSpectralFftSize / 2]{};
-    uint16_t bitRev_[kSpectralFftSize]{};
+#if defined(SPECTRAL_FFT_CMSIS)
+    static arm_rfft_fast_instance_f32 rfft_[kSpectralNumFftSizes];
+#else
+    void Execute(float *re, float *im, size_t size, bool inverse);
+
+    static float    cosTable_[kSpectralMaxFftSize / 2];
+    static float    sinTable_[kSpectralMaxFftSize / 2];
+    static uint16_t bitRev_[kSpectralMaxFftSize];
+#endif
+    static bool tablesBuilt_;
 };
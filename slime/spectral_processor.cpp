@@ -18,6 +18,9 @@ constexpr bool kEnableTimeSmoothing = false;
 constexpr float kTimeSmoothMaxScale = 3.0f;
 constexpr float kNormMinScale = 0.25f;
 constexpr float kNormMaxScale = 4.0f;
+constexpr float kSilenceThreshold = 1.0e-4f;  // Hop peak below ~-80 dBFS counts as silent
+constexpr float kSilenceTailMag = 1.0e-5f;    // Smear/freeze tails below this are inaudible
+constexpr float kMinWindowSum = 1.0e-2f;      // Floor for OLA normalisation at window edges
 
 void LimitSpectrum(float *re, float *im, size_t count)
 {
@@ -64,18 +67,27 @@ void NormalizeSpectrum(float *re, float *im, size_t count, float targetRms)
 }
 } // namespace
 
-void SpectralChannel::Init(float sampleRate, const float *window)
+void SpectralChannel::Init(float sampleRate, const float *window, SpectralChannelBuffers *buffers)
 {
     (void)sampleRate;
+    buf_ = buffers;
     fft_.Init();
-    std::fill(&outputRing_[0], &outputRing_[kOutputBufferSize], 0.0f);
-    std::fill(&smoothMag_[0], &smoothMag_[kNumBins], 0.0f);
-    std::fill(&freezeMag_[0], &freezeMag_[kNumBins], 0.0f);
-    std::fill(&prevPhase_[0], &prevPhase_[kNumBins], 0.0f);
-    std::fill(&sumPhase_[0], &sumPhase_[kNumBins], 0.0f);
+    std::fill(&buf_->inputRing[0], &buf_->inputRing[kMaxFftSize], 0.0f);
+    std::fill(&buf_->outputRing[0], &buf_->outputRing[kSpectralOutputBufferSize], 0.0f);
+    std::fill(&buf_->windowSumRing[0], &buf_->windowSumRing[kSpectralOutputBufferSize], 0.0f);
+    std::fill(&buf_->smoothMag[0], &buf_->smoothMag[kMaxNumBins], 0.0f);
+    std::fill(&buf_->freezeMag[0], &buf_->freezeMag[kMaxNumBins], 0.0f);
+    std::fill(&buf_->prevPhase[0], &buf_->prevPhase[kMaxNumBins], 0.0f);
+    std::fill(&buf_->sumPhase[0], &buf_->sumPhase[kMaxNumBins], 0.0f);
+    pendingFftSize_ = fftSize_;
+    inputWrite_ = 0;
+    hopCounter_ = 0;
     outputPrimed_ = false;
     outputRead_ = 0;
     outputWrite_ = 0;
+    hopPeak_ = 0.0f;
+    silentHops_ = 0;
+    idle_ = false;
 
     SetWindow(window);
 }
@@ -83,19 +95,57 @@ void SpectralChannel::Init(float sampleRate, const float *window)
 void SpectralChannel::SetWindow(const float *window)
 {
     window_ = window;
-    if (!window_)
+}
+
+void SpectralChannel::SetFftSize(size_t size)
+{
+    size_t clamped = kSpectralMinFftSize;
+    while (clamped < size && clamped < kMaxFftSize)
+        clamped <<= 1;
+    pendingFftSize_ = clamped;
+}
+
+void SpectralChannel::ApplyPendingFftSize()
+{
+    if (pendingFftSize_ == fftSize_)
         return;
-    const size_t overlap = kFftSize / kHopSize;
-    for (size_t i = 0; i < kHopSize; ++i)
+    fftSize_ = pendingFftSize_;
+    hopSize_ = fftSize_ / kSpectralOverlap;
+    numBins_ = fftSize_ / 2 + 1;
+    windowStride_ = kMaxFftSize / fftSize_;
+    std::fill(&buf_->smoothMag[0], &buf_->smoothMag[kMaxNumBins], 0.0f);
+    std::fill(&buf_->freezeMag[0], &buf_->freezeMag[kMaxNumBins], 0.0f);
+    std::fill(&buf_->prevPhase[0], &buf_->prevPhase[kMaxNumBins], 0.0f);
+    std::fill(&buf_->sumPhase[0], &buf_->sumPhase[kMaxNumBins], 0.0f);
+    silentHops_ = 0;
+    idle_ = false;
+
+    // Frames of the old size are still queued at the old latency. Fade them
+    // out over one new frame; scaling the window sum along with the samples
+    // keeps their level where they play alone, and keeps the stretch where
+    // both latencies overlap (and can comb) short.
+    size_t position = outputRead_;
+    const float fadeStep = 1.0f / static_cast<float>(fftSize_);
+    for (size_t i = 0; i < kMaxFftSize; ++i)
     {
-        float sum = 0.0f;
-        for (size_t m = 0; m < overlap; ++m)
-        {
-            const size_t idx = i + m * kHopSize;
-            const float w = window_[idx];
-            sum += w * w;
-        }
-        overlapInv_[i] = (sum > kEps) ? (1.0f / sum) : 1.0f;
+        const float gain = (i < fftSize_) ? 1.0f - static_cast<float>(i) * fadeStep : 0.0f;
+        buf_->outputRing[position] *= gain;
+        buf_->windowSumRing[position] *= gain;
+        position = (position + 1) % kSpectralOutputBufferSize;
+    }
+}
+
+void SpectralChannel::AccumulateWindowSum(size_t frameStart)
+{
+    // Overlap-add is normalised by the summed squared window of whatever
+    // frames actually landed on each output sample, so frames of different
+    // sizes can overlap while the size changes without a level dip.
+    size_t destination = frameStart;
+    for (size_t i = 0; i < fftSize_; ++i)
+    {
+        const float w = window_[i * windowStride_];
+        buf_->windowSumRing[destination] += w * w;
+        destination = (destination + 1) % kSpectralOutputBufferSize;
     }
 }
 
@@ -111,21 +161,36 @@ float SpectralChannel::ProcessSample(float input,
                                      bool  normalizeSpectrum,
                                      bool  limitSpectrum)
 {
-    inputRing_[inputWrite_] = input;
-    inputWrite_ = (inputWrite_ + 1) % kFftSize;
+    buf_->inputRing[inputWrite_] = input;
+    inputWrite_ = (inputWrite_ + 1) % kMaxFftSize;
+    hopPeak_ = std::max(hopPeak_, std::fabs(input));
 
     float output = 0.0f;
     if (outputPrimed_)
     {
-        output = outputRing_[outputRead_];
-        outputRing_[outputRead_] = 0.0f;
-        outputRead_ = (outputRead_ + 1) % kOutputBufferSize;
+        const float norm = 1.0f / std::max(buf_->windowSumRing[outputRead_], kMinWindowSum);
+        output = buf_->outputRing[outputRead_] * norm;
+        buf_->outputRing[outputRead_] = 0.0f;
+        buf_->windowSumRing[outputRead_] = 0.0f;
+        outputRead_ = (outputRead_ + 1) % kSpectralOutputBufferSize;
     }
 
     hopCounter_++;
-    if (hopCounter_ >= kHopSize)
+    if (hopCounter_ >= hopSize_)
     {
         hopCounter_ = 0;
+        silentHops_ = (hopPeak_ < kSilenceThreshold) ? silentHops_ + 1 : 0;
+        hopPeak_ = 0.0f;
+        ApplyPendingFftSize();
+        if (CanSkipFrame(process))
+        {
+            // Nothing left to synthesise; keep the OLA write head in step with
+            // the reader so the first non-silent frame lands where it should.
+            AccumulateWindowSum(outputWrite_);
+            outputWrite_ = (outputWrite_ + hopSize_) % kSpectralOutputBufferSize;
+            return output;
+        }
+        idle_ = false;
         ProcessFrame(process,
                      timeRatio,
                      vibe,
@@ -141,6 +206,34 @@ float SpectralChannel::ProcessSample(float input,
     return output;
 }
 
+bool SpectralChannel::CanSkipFrame(SpectralProcess process)
+{
+    // Only skip once a whole window of input is silent, so the last frame with
+    // signal in it has been synthesised and the ring drains naturally.
+    if (!outputPrimed_ || silentHops_ < fftSize_ / hopSize_)
+        return false;
+    if (idle_ && process == idleProcess_)
+        return true;
+
+    // Processors that hold magnitudes between frames keep running until their
+    // tails have decayed. Thru ignores both, Freeze only uses buf_->freezeMag.
+    const bool usesSmooth = process != SpectralProcess::Thru && process != SpectralProcess::Freeze;
+    const bool usesFreeze = process == SpectralProcess::Freeze;
+    for (size_t k = 0; k < numBins_; ++k)
+    {
+        if ((usesSmooth && buf_->smoothMag[k] >= kSilenceTailMag)
+            || (usesFreeze && buf_->freezeMag[k] >= kSilenceTailMag))
+            return false;
+    }
+    if (usesSmooth)
+        std::fill(&buf_->smoothMag[0], &buf_->smoothMag[numBins_], 0.0f);
+    if (usesFreeze)
+        std::fill(&buf_->freezeMag[0], &buf_->freezeMag[numBins_], 0.0f);
+    idle_ = true;
+    idleProcess_ = process;
+    return true;
+}
+
 void SpectralChannel::ProcessFrame(SpectralProcess process,
                                    float timeRatio,
                                    float vibe,
@@ -152,39 +245,43 @@ void SpectralChannel::ProcessFrame(SpectralProcess process,
                                    bool  normalizeSpectrum,
                                    bool  limitSpectrum)
 {
-    size_t source = inputWrite_;
-    for (size_t i = 0; i < kFftSize; ++i)
+    // The input ring always holds kMaxFftSize samples; analyse the newest
+    // fftSize_ of them.
+    size_t source = (inputWrite_ + kMaxFftSize - fftSize_) % kMaxFftSize;
+    for (size_t i = 0; i < fftSize_; ++i)
     {
-        fftRe_[i] = window_[i] * inputRing_[source];
-        fftIm_[i] = 0.0f;
-        source = (source + 1) % kFftSize;
+        buf_->fftRe[i] = window_[i * windowStride_] * buf_->inputRing[source];
+        source = (source + 1) % kMaxFftSize;
     }
 
-    fft_.Execute(fftRe_, fftIm_, false);
+    fft_.ForwardReal(buf_->fftRe, buf_->fftIm, fftSize_);
 
     UnpackSpectrum();
-    const float preRms = ComputeMagRms(re_, im_, kNumBins);
-    for (size_t k = 0; k < kNumBins; ++k)
+    const float preRms = ComputeMagRms(buf_->re, buf_->im, numBins_);
+    for (size_t k = 0; k < numBins_; ++k)
     {
-        const float re = re_[k];
-        const float im = im_[k];
-        mag_[k] = std::sqrt(re * re + im * im);
-        phase_[k] = std::atan2(im, re);
-        origRe_[k] = re_[k];
-        origIm_[k] = im_[k];
+        const float re = buf_->re[k];
+        const float im = buf_->im[k];
+        buf_->mag[k] = std::sqrt(re * re + im * im);
+        buf_->phase[k] = std::atan2(im, re);
+        buf_->origRe[k] = buf_->re[k];
+        buf_->origIm[k] = buf_->im[k];
     }
     SpectralFrame frame;
-    frame.bins = kNumBins;
-    frame.re = re_;
-    frame.im = im_;
-    frame.mag = mag_;
-    frame.phase = phase_;
-    frame.temp = temp_;
-    frame.tempIm = tempIm_;
-    frame.smoothMag = smoothMag_;
-    frame.freezeMag = freezeMag_;
-
-    GetProcessor(static_cast<int>(process)).Process(frame, timeRatio, vibe);
+    frame.bins = numBins_;
+    frame.re = buf_->re;
+    frame.im = buf_->im;
+    frame.mag = buf_->mag;
+    frame.phase = buf_->phase;
+    frame.temp = buf_->temp;
+    frame.tempIm = buf_->tempIm;
+    frame.smoothMag = buf_->smoothMag;
+    frame.freezeMag = buf_->freezeMag;
+
+    // Processor smoothing constants assume the default hop; rescale the time so
+    // decays keep their length in seconds at other FFT sizes.
+    const float frameTime = timeRatio * static_cast<float>(kSpectralHopSize) / static_cast<float>(hopSize_);
+    GetProcessor(static_cast<int>(process)).Process(frame, frameTime, vibe);
 
     // Phase continuity (phase vocoder) for time-stretched effects
     // Note: ApplyPhaseContinuity extracts mag/phase from re/im internally
@@ -194,62 +291,62 @@ void SpectralChannel::ProcessFrame(SpectralProcess process,
     }
     if (kEnableTimeSmoothing && process != SpectralProcess::Thru)
     {
-        ApplyTimeSmoothing(timeRatio);
+        ApplyTimeSmoothing(frameTime);
     }
     if (process != SpectralProcess::Thru)
     {
         if (normalizeSpectrum)
         {
-            NormalizeSpectrum(re_, im_, kNumBins, preRms);
+            NormalizeSpectrum(buf_->re, buf_->im, numBins_, preRms);
         }
         if (preserve > 0.0f)
         {
             const float keep = std::clamp(preserve, 0.0f, 1.0f);
             const float mix = 1.0f - keep;
-            for (size_t k = 0; k < kNumBins; ++k)
+            for (size_t k = 0; k < numBins_; ++k)
             {
-                re_[k] = re_[k] * mix + origRe_[k] * keep;
-                im_[k] = im_[k] * mix + origIm_[k] * keep;
+                buf_->re[k] = buf_->re[k] * mix + buf_->origRe[k] * keep;
+                buf_->im[k] = buf_->im[k] * mix + buf_->origIm[k] * keep;
             }
         }
     }
     if (spectralGain != 1.0f)
     {
         const float gain = std::clamp(spectralGain, 0.0f, 4.0f);
-        for (size_t k = 0; k < kNumBins; ++k)
+        for (size_t k = 0; k < numBins_; ++k)
         {
-            re_[k] *= gain;
-            im_[k] *= gain;
+            buf_->re[k] *= gain;
+            buf_->im[k] *= gain;
         }
     }
     if (limitSpectrum)
     {
-        LimitSpectrum(re_, im_, kNumBins);
+        LimitSpectrum(buf_->re, buf_->im, numBins_);
     }
     PackSpectrum();
 
-    fft_.Execute(fftRe_, fftIm_, true);
+    fft_.InverseReal(buf_->fftRe, buf_->fftIm, fftSize_);
     if (ifftGain != 1.0f)
     {
         const float gain = std::clamp(ifftGain, 0.0f, 4.0f);
-        for (size_t i = 0; i < kFftSize; ++i)
+        for (size_t i = 0; i < fftSize_; ++i)
         {
-            fftRe_[i] *= gain;
+            buf_->fftRe[i] *= gain;
         }
     }
 
     const size_t frameStart = outputWrite_;
     size_t destination = frameStart;
     const float ola = std::clamp(olaGain, 0.0f, 4.0f);
-    for (size_t i = 0; i < kFftSize; ++i)
+    for (size_t i = 0; i < fftSize_; ++i)
     {
-        const float norm = overlapInv_[(frameStart + i) % kHopSize];
-        const float sample = fftRe_[i] * window_[i] * norm * kWetGain * ola;
-        outputRing_[destination] += sample;
-        destination = (destination + 1) % kOutputBufferSize;
+        const float sample = buf_->fftRe[i] * window_[i * windowStride_] * kWetGain * ola;
+        buf_->outputRing[destination] += sample;
+        destination = (destination + 1) % kSpectralOutputBufferSize;
     }
+    AccumulateWindowSum(frameStart);
 
-    outputWrite_ = (outputWrite_ + kHopSize) % kOutputBufferSize;
+    outputWrite_ = (outputWrite_ + hopSize_) % kSpectralOutputBufferSize;
     if (!outputPrimed_)
     {
         outputRead_ = frameStart;
@@ -259,86 +356,84 @@ void SpectralChannel::ProcessFrame(SpectralProcess process,
 
 void SpectralChannel::UnpackSpectrum()
 {
-    re_[0] = fftRe_[0];
-    im_[0] = 0.0f;
-    re_[kNumBins - 1] = fftRe_[kFftSize / 2];
-    im_[kNumBins - 1] = 0.0f;
-    for (size_t k = 1; k < kNumBins - 1; ++k)
+    buf_->re[0] = buf_->fftRe[0];
+    buf_->im[0] = 0.0f;
+    buf_->re[numBins_ - 1] = buf_->fftRe[fftSize_ / 2];
+    buf_->im[numBins_ - 1] = 0.0f;
+    for (size_t k = 1; k < numBins_ - 1; ++k)
     {
-        re_[k] = fftRe_[k];
-        im_[k] = fftIm_[k];
+        buf_->re[k] = buf_->fftRe[k];
+        buf_->im[k] = buf_->fftIm[k];
     }
 }
 
 void SpectralChannel::PackSpectrum()
 {
-    fftRe_[0] = re_[0];
-    fftIm_[0] = 0.0f;
-    fftRe_[kFftSize / 2] = re_[kNumBins - 1];
-    fftIm_[kFftSize / 2] = 0.0f;
+    buf_->fftRe[0] = buf_->re[0];
+    buf_->fftIm[0] = 0.0f;
+    buf_->fftRe[fftSize_ / 2] = buf_->re[numBins_ - 1];
+    buf_->fftIm[fftSize_ / 2] = 0.0f;
 
-    for (size_t k = 1; k < kNumBins - 1; ++k)
+    // The upper half of the spectrum is the backend's business.
+    for (size_t k = 1; k < numBins_ - 1; ++k)
     {
-        fftRe_[k] = re_[k];
-        fftIm_[k] = im_[k];
-        const size_t mirror = kFftSize - k;
-        fftRe_[mirror] = re_[k];
-        fftIm_[mirror] = -im_[k];
+        buf_->fftRe[k] = buf_->re[k];
+        buf_->fftIm[k] = buf_->im[k];
     }
 }
 
 void SpectralChannel::ApplyPhaseContinuity()
 {
-    const float phaseAdvance = kTwoPi * static_cast<float>(kHopSize) / static_cast<float>(kFftSize);
-    for (size_t k = 1; k < kNumBins - 1; ++k)
+    const float phaseAdvance = kTwoPi * static_cast<float>(hopSize_) / static_cast<float>(fftSize_);
+    for (size_t k = 1; k < numBins_ - 1; ++k)
     {
-        const float mag = std::sqrt(re_[k] * re_[k] + im_[k] * im_[k]);
+        const float mag = std::sqrt(buf_->re[k] * buf_->re[k] + buf_->im[k] * buf_->im[k]);
         if (mag < kMinMag)
         {
-            re_[k] = 0.0f;
-            im_[k] = 0.0f;
+            buf_->re[k] = 0.0f;
+            buf_->im[k] = 0.0f;
             continue;
         }
 
-        const float phase = std::atan2(im_[k], re_[k]);
-        float delta = phase - prevPhase_[k] - phaseAdvance * static_cast<float>(k);
+        const float phase = std::atan2(buf_->im[k], buf_->re[k]);
+        float delta = phase - buf_->prevPhase[k] - phaseAdvance * static_cast<float>(k);
         while (delta > static_cast<float>(M_PI))
             delta -= kTwoPi;
         while (delta < -static_cast<float>(M_PI))
             delta += kTwoPi;
 
-        sumPhase_[k] += phaseAdvance * static_cast<float>(k) + delta;
-        prevPhase_[k] = phase;
+        buf_->sumPhase[k] += phaseAdvance * static_cast<float>(k) + delta;
+        buf_->prevPhase[k] = phase;
 
-        re_[k] = mag * std::cos(sumPhase_[k]);
-        im_[k] = mag * std::sin(sumPhase_[k]);
+        buf_->re[k] = mag * std::cos(buf_->sumPhase[k]);
+        buf_->im[k] = mag * std::sin(buf_->sumPhase[k]);
     }
-    re_[0] = re_[0];
-    im_[0] = 0.0f;
-    re_[kNumBins - 1] = re_[kNumBins - 1];
-    im_[kNumBins - 1] = 0.0f;
+    buf_->re[0] = buf_->re[0];
+    buf_->im[0] = 0.0f;
+    buf_->re[numBins_ - 1] = buf_->re[numBins_ - 1];
+    buf_->im[numBins_ - 1] = 0.0f;
 }
 
 void SpectralChannel::ApplyTimeSmoothing(float timeRatio)
 {
     const float clamped = std::clamp(timeRatio, 0.01f, 5.0f);
     const float alpha = std::clamp(0.00533f / clamped, 0.0005f, 0.95f);
-    for (size_t k = 0; k < kNumBins; ++k)
+    for (size_t k = 0; k < numBins_; ++k)
     {
-        const float mag = std::sqrt(re_[k] * re_[k] + im_[k] * im_[k]);
+        const float mag = std::sqrt(buf_->re[k] * buf_->re[k] + buf_->im[k] * buf_->im[k]);
         if (mag < kMinMag)
         {
-            smoothMag_[k] *= 0.95f;
-            if (smoothMag_[k] < kMinMag)
+            buf_->smoothMag[k] *= 0.95f;
+            if (buf_->smoothMag[k] < kMinMag)
             {
-                re_[k] = 0.0f;
-                im_[k] = 0.0f;
+                buf_->re[k] = 0.0f;
+                buf_->im[k] = 0.0f;
             }
             continue;
         }
-        smoothMag_[k] += alpha * (mag - smoothMag_[k]);
-        const float scale = std::min(smoothMag_[k] / (mag + kEps), kTimeSmoothMaxScale);
-        re_[k] *= scale;
-        im_[k] *= scale;
+        buf_->smoothMag[k] += alpha * (mag - buf_->smoothMag[k]);
+        const float scale = std::min(buf_->smoothMag[k] / (mag + kEps), kTimeSmoothMaxScale);
+        buf_->re[k] *= scale;
+        buf_->im[k] *= scale;
     }
 }
@@ -20,15 +20,47 @@ enum class SpectralProcess
     Count
 };
 
+constexpr size_t kSpectralOutputBufferSize = 2 * kSpectralMaxFftSize;
+
+// Working memory for one channel, sized for the largest FFT. Plain arrays with
+// no constructors so the firmware can place it in SDRAM (DSY_SDRAM_BSS).
+struct SpectralChannelBuffers
+{
+    float inputRing[kSpectralMaxFftSize];
+    float fftRe[kSpectralMaxFftSize];
+    float fftIm[kSpectralMaxFftSize];
+
+    float re[kSpectralMaxNumBins];
+    float im[kSpectralMaxNumBins];
+    float mag[kSpectralMaxNumBins];
+    float phase[kSpectralMaxNumBins];
+    float temp[kSpectralMaxNumBins];
+    float tempIm[kSpectralMaxNumBins];
+    float origRe[kSpectralMaxNumBins];
+    float origIm[kSpectralMaxNumBins];
+    float smoothMag[kSpectralMaxNumBins];
+    float freezeMag[kSpectralMaxNumBins];
+    float prevPhase[kSpectralMaxNumBins];
+    float sumPhase[kSpectralMaxNumBins];
+
+    float outputRing[kSpectralOutputBufferSize];
+    float windowSumRing[kSpectralOutputBufferSize];
+};
+
 class SpectralChannel
 {
   public:
-    static constexpr size_t kFftSize = kSpectralFftSize;
-    static constexpr size_t kHopSize = kSpectralHopSize;
-    static constexpr size_t kNumBins = kSpectralNumBins;
+    static constexpr size_t kMaxFftSize = kSpectralMaxFftSize;
+    static constexpr size_t kMaxNumBins = kSpectralMaxNumBins;
 
-    void Init(float sampleRate, const float *window);
+    // window holds kMaxFftSize samples; smaller frames read it at a stride.
+    void Init(float sampleRate, const float *window, SpectralChannelBuffers *buffers);
     void SetWindow(const float *window);
+    // Applied at the next hop boundary. Per-bin history (smear, freeze, phase
+    // accumulators) is cleared then since bin k means a different frequency.
+    void SetFftSize(size_t size);
+    size_t FftSize() const { return fftSize_; }
+    size_t HopSize() const { return hopSize_; }
     float ProcessSample(float input,
                         SpectralProcess process,
                         float timeRatio,
@@ -56,30 +88,24 @@ class SpectralChannel
     void PackSpectrum();
     void ApplyPhaseContinuity();
     void ApplyTimeSmoothing(float timeRatio);
+    bool CanSkipFrame(SpectralProcess process);
+    void ApplyPendingFftSize();
+    void AccumulateWindowSum(size_t frameStart);
+
+    SpectralChannelBuffers *buf_ = nullptr;
+    size_t fftSize_ = kSpectralFftSize;
+    size_t pendingFftSize_ = kSpectralFftSize;
+    size_t hopSize_ = kSpectralHopSize;
+    size_t numBins_ = kSpectralNumBins;
+    size_t windowStride_ = kSpectralMaxFftSize / kSpectralFftSize;
 
-    float inputRing_[kFftSize]{};
     size_t inputWrite_ = 0;
     size_t hopCounter_ = 0;
+    float hopPeak_ = 0.0f;
+    size_t silentHops_ = 0;
+    bool idle_ = false;
+    SpectralProcess idleProcess_ = SpectralProcess::Thru;
 
-    float fftRe_[kFftSize]{};
-    float fftIm_[kFftSize]{};
-
-    float re_[kNumBins]{};
-    float im_[kNumBins]{};
-    float mag_[kNumBins]{};
-    float phase_[kNumBins]{};
-    float temp_[kNumBins]{};
-    float tempIm_[kNumBins]{};
-    float origRe_[kNumBins]{};
-    float origIm_[kNumBins]{};
-    float smoothMag_[kNumBins]{};
-    float freezeMag_[kNumBins]{};
-    float prevPhase_[kNumBins]{};
-    float sumPhase_[kNumBins]{};
-    float overlapInv_[kHopSize]{};
-
-    static constexpr size_t kOutputBufferSize = 4096;
-    float outputRing_[kOutputBufferSize]{};
     size_t outputRead_ = 0;
     size_t outputWrite_ = 0;
     bool outputPrimed_ = false;
@@ -189,8 +189,16 @@ void FreezeProcessor::Process(SpectralFrame &frame, float time, float vibe) cons
     const float alpha = std::clamp(0.00533f / time, 0.0005f, 0.95f);
     const float decay = 1.0f - alpha;
 
-    // Vibe controls freeze threshold/sensitivity
-    const float threshold = vibe * 0.5f;
+    // Vibe sets how close to the frame's loudest bin a bin must come to be
+    // captured (up to half its level). Relative, so the strongest partials
+    // are held at any input level; an absolute threshold froze nothing on
+    // quiet material and left the output silent.
+    float peakSq = 0.0f;
+    for (size_t k = 0; k < frame.bins; ++k)
+    {
+        peakSq = std::max(peakSq, frame.re[k] * frame.re[k] + frame.im[k] * frame.im[k]);
+    }
+    const float threshold = vibe * 0.5f * std::sqrt(peakSq);
 
     for (size_t k = 0; k < frame.bins; ++k)
     {
@@ -22,6 +22,9 @@ constexpr float kInputGain = 1.4f;
 constexpr float kOutputGain = 0.9f;
 constexpr float kWetTrim = 0.8f;
 
+SpectralChannelBuffers s_buffers1;
+SpectralChannelBuffers s_buffers2;
+
 float SoftClipInput(float sample)
 {
     const float absSample = std::fabs(sample);
@@ -35,7 +38,7 @@ float SoftClip(float sample)
 
 void BuildWindow(std::vector<float> &window)
 {
-    window.resize(SpectralChannel::kFftSize);
+    window.resize(SpectralChannel::kMaxFftSize);
     for (size_t i = 0; i < window.size(); ++i)
     {
         const float phase = static_cast<float>(i) / static_cast<float>(window.size());
@@ -48,6 +51,8 @@ const char *ProcessName(SpectralProcess process)
 {
     switch (process)
     {
+    case SpectralProcess::Thru:
+        return "Thru";
     case SpectralProcess::Smear:
         return "Smear";
     case SpectralProcess::Shift:
@@ -76,7 +81,7 @@ int main()
     BuildWindow(window);
 
     const size_t totalSamples = static_cast<size_t>(kSampleRate * kDurationSec);
-    const size_t warmup = SpectralChannel::kFftSize * 4;
+    const size_t warmup = kSpectralFftSize * 4;
     bool ok = true;
 
     for (int p = 0; p < static_cast<int>(SpectralProcess::Count); ++p)
@@ -88,8 +93,8 @@ int main()
             {
                 SpectralChannel channel1;
                 SpectralChannel channel2;
-                channel1.Init(kSampleRate, window.data());
-                channel2.Init(kSampleRate, window.data());
+                channel1.Init(kSampleRate, window.data(), &s_buffers1);
+                channel2.Init(kSampleRate, window.data(), &s_buffers2);
 
                 float peak = 0.0f;
                 double sumSq = 0.0;
@@ -176,7 +181,7 @@ int main()
 
     if (!ok)
     {
-        std::fprintf(stderr, "Amplitude sanity check failed (peak > %.2f or non-finite output).\n",
+        std::fprintf(stderr, "Amplitude sanity check failed (peak > %.2f, silent or non-finite output).\n",
                      static_cast<double>(kPeakLimit));
         return 1;
     }
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "spectral_processor.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBenchSamples = 48000;
+constexpr int kPasses = 3;
+constexpr float kPi = 3.14159265358979323846f;
+constexpr float kFrequency = 440.0f;
+constexpr float kInputAmp = 0.25f;
+constexpr size_t kSwitchInterval = 12000;  // Samples between size changes
+constexpr size_t kRmsWindow = 480;         // 10 ms
+constexpr float kMinRmsRatio = 0.5f;       // Anything below counts as a dropout
+
+using Clock = std::chrono::steady_clock;
+
+SpectralChannelBuffers s_buffers1;
+SpectralChannelBuffers s_buffers2;
+
+void BuildWindow(std::vector<float> &window)
+{
+    window.resize(SpectralChannel::kMaxFftSize);
+    for (size_t i = 0; i < window.size(); ++i)
+    {
+        const float phase = static_cast<float>(i) / static_cast<float>(window.size());
+        const float hann = 0.5f - 0.5f * std::cos(2.0f * kPi * phase);
+        window[i] = std::sqrt(std::max(hann, 0.0f));
+    }
+}
+
+float Process(SpectralChannel &channel, float input)
+{
+    return channel.ProcessSample(input, SpectralProcess::Smear, 0.2f, 0.5f, 0.2f,
+                                 1.0f, 1.0f, 1.0f, true, true, true);
+}
+
+// Stereo Smear on noise, the same work the firmware does per second of audio.
+double BenchSize(const std::vector<float> &window, size_t size)
+{
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        SpectralChannel channel1;
+        SpectralChannel channel2;
+        channel1.Init(kSampleRate, window.data(), &s_buffers1);
+        channel2.Init(kSampleRate, window.data(), &s_buffers2);
+        channel1.SetFftSize(size);
+        channel2.SetFftSize(size);
+        srand(1);
+        float sink = 0.0f;
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kBenchSamples; ++n)
+        {
+            const float l = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 0.5f;
+            const float r = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 0.5f;
+            sink += Process(channel1, l) + Process(channel2, r);
+        }
+        best = std::min(best, std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        if (!std::isfinite(sink))
+            return -1.0;
+    }
+    return best;
+}
+
+// Steps through every size on a steady sine and reports the quietest 10 ms
+// window after warm-up relative to the average, so a dropout shows up as a
+// ratio near zero.
+float SwitchingMinRmsRatio(const std::vector<float> &window)
+{
+    SpectralChannel channel;
+    channel.Init(kSampleRate, window.data(), &s_buffers1);
+
+    const size_t warmup = kSpectralMaxFftSize * 2;
+    const size_t total = warmup + kSwitchInterval * (2 * kSpectralNumFftSizes);
+    double sumSq = 0.0;
+    double windowSq = 0.0;
+    size_t windowCount = 0;
+    size_t counted = 0;
+    float minRms = 1.0e30f;
+    int index = 0;
+    int direction = 1;
+    for (size_t n = 0; n < total; ++n)
+    {
+        if (n >= warmup && (n - warmup) % kSwitchInterval == 0)
+        {
+            if (index + direction < 0 || index + direction >= static_cast<int>(kSpectralNumFftSizes))
+                direction = -direction;
+            index += direction;
+            channel.SetFftSize(SpectralFftSizeAt(index));
+        }
+        const float phase = 2.0f * kPi * kFrequency * static_cast<float>(n) / kSampleRate;
+        const float out = channel.ProcessSample(kInputAmp * std::sin(phase), SpectralProcess::Thru,
+                                                0.2f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+                                                false, false, true);
+        if (n < warmup)
+            continue;
+        sumSq += static_cast<double>(out) * out;
+        windowSq += static_cast<double>(out) * out;
+        counted++;
+        if (++windowCount == kRmsWindow)
+        {
+            minRms = std::min(minRms, std::sqrt(static_cast<float>(windowSq / kRmsWindow)));
+            windowSq = 0.0;
+            windowCount = 0;
+        }
+    }
+    const float avgRms = std::sqrt(static_cast<float>(sumSq / static_cast<double>(counted)));
+    return avgRms > 0.0f ? minRms / avgRms : 0.0f;
+}
+} // namespace
+
+int main()
+{
+    std::vector<float> window;
+    BuildWindow(window);
+
+    const double secondsOfAudio = static_cast<double>(kBenchSamples) / kSampleRate;
+    std::printf("Stereo Smear, %zu samples, best of %d passes\n", kBenchSamples, kPasses);
+    std::printf("%6s%6s%12s%12s%12s\n", "fft", "hop", "latency ms", "us", "% realtime");
+
+    bool ok = true;
+    for (size_t i = 0; i < kSpectralNumFftSizes; ++i)
+    {
+        const size_t size = SpectralFftSizeAt(static_cast<int>(i));
+        const double us = BenchSize(window, size);
+        if (us < 0.0)
+            ok = false;
+        std::printf("%6zu%6zu%12.1f%12.0f%11.1f%%\n",
+                    size,
+                    size / kSpectralOverlap,
+                    1000.0 * static_cast<double>(size) / kSampleRate,
+                    us,
+                    100.0 * us * 1.0e-6 / secondsOfAudio);
+    }
+
+    const float ratio = SwitchingMinRmsRatio(window);
+    std::printf("Size switching: quietest 10 ms window is %.2f of average level\n",
+                static_cast<double>(ratio));
+    if (ratio < kMinRmsRatio)
+        ok = false;
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "FFT size bench failed (non-finite output or dropout on size change).\n");
+        return 1;
+    }
+    return 0;
+}
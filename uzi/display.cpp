@@ -1,5 +1,6 @@
 #include "display.h"
 
+#include <algorithm>
 #include <cstdio>
 
 using namespace kxmx;
@@ -17,7 +18,26 @@ void RenderDisplay(Bluemchen &hw, const DisplayData &data)
              data.heartbeatOn ? '.' : ' ');
     hw.display.WriteString(buf, Font_6x8, true);
 
-    if (data.debug)
+    if (data.status)
+    {
+        // Deadline misses share the title row, pinned at 99.
+        hw.display.SetCursor(40, 0);
+        snprintf(buf, sizeof(buf), "DM%2u", static_cast<unsigned>(std::min<uint32_t>(data.deadlineMisses, 99)));
+        hw.display.WriteString(buf, Font_6x8, true);
+
+        hw.display.SetCursor(0, 8);
+        snprintf(buf, sizeof(buf), "FFT %4d", data.fftSize);
+        hw.display.WriteString(buf, Font_6x8, true);
+
+        hw.display.SetCursor(0, 16);
+        snprintf(buf, sizeof(buf), "LAT %3dms", static_cast<int>(data.latencyMs + 0.5f));
+        hw.display.WriteString(buf, Font_6x8, true);
+
+        hw.display.SetCursor(0, 24);
+        snprintf(buf, sizeof(buf), "CPU %3d%%", static_cast<int>(data.cpuLoad * 100.0f + 0.5f));
+        hw.display.WriteString(buf, Font_6x8, true);
+    }
+    else if (data.debug)
     {
         if (data.debugPage == 0)
         {
@@ -10,6 +10,11 @@ struct DisplayData
     MenuLine lines[3]{};
     int lineCount = 0;
     bool heartbeatOn = false;
+    bool status = false;
+    int fftSize = 0;
+    float latencyMs = 0.0f;
+    float cpuLoad = 0.0f;
+    uint32_t deadlineMisses = 0;
     bool debug = false;
     int debugPage = 0;
     uint16_t rawK1 = 0;
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+// 2x/4x/8x oversampling around a per-sample nonlinearity. Each octave is a
+// polyphase half-band FIR: half of a half-band's taps are zero and the
+// centre tap is 0.5, so one phase is a short symmetric FIR and the other is
+// a pure delay. Histories are stored twice so every kernel reads one
+// contiguous window, which keeps the inner loops free of wrap checks.
+
+// One symmetric half-band kernel with `kSideTaps` distinct non-zero taps on
+// each side of the centre (4 * kSideTaps - 1 taps in total).
+template <int kSideTaps>
+class HalfBandKernel
+{
+public:
+    static constexpr int kLength = 2 * kSideTaps; // Input samples each output reads
+
+    // Kaiser-windowed sinc. beta trades stopband depth for transition width.
+    void Design(float beta)
+    {
+        const float centre = static_cast<float>(2 * kSideTaps - 1);
+        const double norm = BesselI0(beta);
+        float sum = 0.0f;
+        for (int j = 0; j < kSideTaps; ++j)
+        {
+            const float offset = static_cast<float>(2 * j + 1);
+            const float ratio = offset / centre;
+            const double window = BesselI0(beta * std::sqrt(std::fmax(0.0, 1.0 - ratio * ratio))) / norm;
+            const float sinc = ((j & 1) ? -1.0f : 1.0f) / (kPi * offset);
+            taps_[j] = sinc * static_cast<float>(window);
+            sum += 2.0f * taps_[j];
+        }
+        // The side taps of a half-band sum to 0.5, so DC gain is exactly one.
+        for (int j = 0; j < kSideTaps; ++j)
+            taps_[j] *= 0.5f / sum;
+    }
+
+    // newest[0] is the latest sample, newest[i] the one i samples older.
+    float Apply(const float *newest) const
+    {
+        float sum = 0.0f;
+        for (int j = 0; j < kSideTaps; ++j)
+            sum += taps_[j] * (newest[kSideTaps - 1 - j] + newest[kSideTaps + j]);
+        return sum;
+    }
+
+private:
+    static constexpr float kPi = 3.14159265358979323846f;
+    float taps_[kSideTaps]{};
+
+    static double BesselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x * 0.5 / k) * (x * 0.5 / k);
+            sum += term;
+        }
+        return sum;
+    }
+};
+
+// Linear history of `kLength` samples mirrored into a 2x buffer.
+template <int kLength>
+struct MirroredHistory
+{
+    float data[2 * kLength]{};
+    int pos = 0;
+
+    void Reset()
+    {
+        for (float &v : data)
+            v = 0.0f;
+        pos = 0;
+    }
+
+    const float *Push(float x)
+    {
+        pos = (pos == 0) ? kLength - 1 : pos - 1;
+        data[pos] = x;
+        data[pos + kLength] = x;
+        return &data[pos];
+    }
+};
+
+// One octave up and one octave down, sharing a kernel.
+template <int kSideTaps>
+class HalfBandStage
+{
+public:
+    using Kernel = HalfBandKernel<kSideTaps>;
+
+    void Design(float beta) { kernel_.Design(beta); }
+
+    void Reset()
+    {
+        up_.Reset();
+        downOdd_.Reset();
+        downEven_.Reset();
+    }
+
+    // Latency of the up + down pair, in samples at the stage's input rate:
+    // (2 * kSideTaps - 1) on the way up plus (2 * kSideTaps - 2) on the way
+    // down, both counted at the doubled rate.
+    static constexpr float Latency() { return static_cast<float>(2 * kSideTaps) - 1.5f; }
+
+    // count input samples -> 2 * count output samples.
+    void Up(const float *in, float *out, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float *h = up_.Push(in[i]);
+            out[2 * i] = 2.0f * kernel_.Apply(h);
+            out[2 * i + 1] = h[kSideTaps - 1];
+        }
+    }
+
+    // 2 * count input samples -> count output samples.
+    void Down(const float *in, float *out, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float *even = downEven_.Push(in[2 * i]);
+            const float *odd = downOdd_.Push(in[2 * i + 1]);
+            out[i] = kernel_.Apply(odd) + 0.5f * even[kSideTaps - 1];
+        }
+    }
+
+private:
+    Kernel kernel_{};
+    MirroredHistory<Kernel::kLength> up_{};
+    MirroredHistory<Kernel::kLength> downOdd_{};
+    MirroredHistory<Kernel::kLength> downEven_{};
+};
+
+class Oversampler
+{
+public:
+    static constexpr int kMaxFactorIndex = 3; // 0 = off, 1 = 2x, 2 = 4x, 3 = 8x
+    static constexpr size_t kChunk = 16;      // Base-rate samples per inner pass
+
+    void Init()
+    {
+        // The first octave has to hold the audio band right up to the old
+        // Nyquist; the later ones only guard images that are already an
+        // octave away, so they get by with a few taps.
+        first_.Design(kFirstBeta);
+        second_.Design(kInnerBeta);
+        third_.Design(kInnerBeta);
+        Reset();
+    }
+
+    void Reset()
+    {
+        first_.Reset();
+        second_.Reset();
+        third_.Reset();
+    }
+
+    // Clears the filter state when the factor changes, since the histories
+    // of a stage that was idle are stale.
+    void SetFactorIndex(int index)
+    {
+        index = index < 0 ? 0 : (index > kMaxFactorIndex ? kMaxFactorIndex : index);
+        if (index == factorIndex_)
+            return;
+        factorIndex_ = index;
+        Reset();
+    }
+
+    int FactorIndex() const { return factorIndex_; }
+    int Factor() const { return 1 << factorIndex_; }
+
+    // Delay added by the filters, in base-rate samples.
+    float Latency() const
+    {
+        float latency = 0.0f;
+        if (factorIndex_ >= 1)
+            latency += FirstStage::Latency();
+        if (factorIndex_ >= 2)
+            latency += InnerStage::Latency() * 0.5f;
+        if (factorIndex_ >= 3)
+            latency += InnerStage::Latency() * 0.25f;
+        return latency;
+    }
+
+    // Runs shaper(float) -> float at the oversampled rate over a block.
+    template <typename Shaper>
+    void Process(const float *in, float *out, size_t size, Shaper &&shaper)
+    {
+        if (factorIndex_ == 0)
+        {
+            for (size_t i = 0; i < size; ++i)
+                out[i] = shaper(in[i]);
+            return;
+        }
+
+        while (size > 0)
+        {
+            const size_t count = size < kChunk ? size : kChunk;
+            first_.Up(in, bufA_, count);
+            size_t rate = 2 * count;
+            if (factorIndex_ >= 2)
+            {
+                second_.Up(bufA_, bufB_, rate);
+                rate *= 2;
+                if (factorIndex_ >= 3)
+                {
+                    third_.Up(bufB_, bufA_, rate);
+                    rate *= 2;
+                }
+            }
+
+            float *top = (factorIndex_ == 2) ? bufB_ : bufA_;
+            for (size_t i = 0; i < rate; ++i)
+                top[i] = shaper(top[i]);
+
+            if (factorIndex_ >= 3)
+            {
+                rate /= 2;
+                third_.Down(bufA_, bufB_, rate);
+            }
+            if (factorIndex_ >= 2)
+            {
+                rate /= 2;
+                second_.Down(bufB_, bufA_, rate);
+            }
+            first_.Down(bufA_, out, count);
+
+            in += count;
+            out += count;
+            size -= count;
+        }
+    }
+
+    template <typename Shaper>
+    float ProcessSample(float in, Shaper &&shaper)
+    {
+        float out = 0.0f;
+        Process(&in, &out, 1, shaper);
+        return out;
+    }
+
+private:
+    static constexpr float kFirstBeta = 7.0f;
+    static constexpr float kInnerBeta = 6.0f;
+
+    using FirstStage = HalfBandStage<6>;
+    using InnerStage = HalfBandStage<3>;
+
+    FirstStage first_{};
+    InnerStage second_{};
+    InnerStage third_{};
+    int factorIndex_ = 0;
+    float bufA_[kChunk * 8]{};
+    float bufB_[kChunk * 8]{};
+};
@@ -2,10 +2,33 @@
 
 #include <cstddef>
 
+// FFT size is selectable at runtime from 256 to 4096 in powers of two; buffers
+// are sized for the largest frame. UZI_FFT_SIZE picks the power-on size.
 #ifndef UZI_FFT_SIZE
 #define UZI_FFT_SIZE 1024
 #endif
 
+constexpr size_t kSpectralMinFftSize = 256;
+constexpr size_t kSpectralMaxFftSize = 4096;
+constexpr size_t kSpectralNumFftSizes = 5;
 constexpr size_t kSpectralFftSize = UZI_FFT_SIZE;
 static_assert((kSpectralFftSize & (kSpectralFftSize - 1)) == 0, "FFT size must be a power of two.");
+static_assert(kSpectralFftSize >= kSpectralMinFftSize && kSpectralFftSize <= kSpectralMaxFftSize,
+              "FFT size must be between 256 and 4096.");
 constexpr size_t kSpectralNumBins = kSpectralFftSize / 2 + 1;
+constexpr size_t kSpectralMaxNumBins = kSpectralMaxFftSize / 2 + 1;
+
+constexpr size_t SpectralFftSizeAt(int index)
+{
+    return kSpectralMinFftSize << index;
+}
+
+constexpr int SpectralFftSizeIndex(size_t size)
+{
+    int index = 0;
+    while (index + 1 < static_cast<int>(kSpectralNumFftSizes) && SpectralFftSizeAt(index) < size)
+    {
+        ++index;
+    }
+    return index;
+}
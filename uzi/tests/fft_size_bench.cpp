@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#include "uzi_spectral.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr size_t kBenchSamples = 48000;
+constexpr int kPasses = 3;
+constexpr float kPi = 3.14159265358979323846f;
+constexpr size_t kOverlaps[] = {8, 4, 2};  // BLK 0, 1, 2
+constexpr size_t kSwitchInterval = 12000;  // Samples between size changes
+constexpr size_t kRmsWindow = 480;         // 10 ms
+constexpr float kMinRmsRatio = 0.5f;       // Anything below counts as a dropout
+
+using Clock = std::chrono::steady_clock;
+
+UziSpectralBuffers s_buffers;
+UziSpectralStereo s_spectral;
+
+UziRuntime BenchRuntime()
+{
+    UziRuntime runtime;
+    runtime.lfoDepth = 0.5f;
+    runtime.blur = 0.4f;
+    runtime.binRounding = 0.2f;
+    runtime.notchDistance = 0.5f;
+    runtime.xmix = 0.3f;
+    runtime.crossover = 0.2f;
+    return runtime;
+}
+
+double BenchSize(size_t fftSize, size_t overlap)
+{
+    const UziRuntime runtime = BenchRuntime();
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        s_spectral.Init(kSampleRate, &s_buffers);
+        s_spectral.SetFrameSize(fftSize, fftSize / overlap);
+        srand(1);
+        float sink = 0.0f;
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kBenchSamples; ++n)
+        {
+            const float l = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 0.5f;
+            const float r = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 0.5f;
+            const float lfo = std::sin(static_cast<float>(n) * 2.0e-4f);
+            float outL = 0.0f;
+            float outR = 0.0f;
+            s_spectral.ProcessSample(l, r, runtime, lfo, outL, outR);
+            sink += outL + outR;
+        }
+        best = std::min(best, std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        if (!std::isfinite(sink))
+            return -1.0;
+    }
+    return best;
+}
+
+// Steps through every size on a steady tone and reports the quietest 10 ms
+// window after warm-up relative to the average, so a dropout shows up as a
+// ratio near zero.
+float SwitchingMinRmsRatio()
+{
+    UziRuntime runtime;
+    // One narrow notch, half a spacing away from the tone, so the tone passes.
+    runtime.notchDistance = 3.0f;
+    runtime.phaseOffset = 0.5f;
+    runtime.blur = 0.0f;
+    s_spectral.Init(kSampleRate, &s_buffers);
+
+    const size_t warmup = kSpectralMaxFftSize * 2;
+    const size_t total = warmup + kSwitchInterval * (2 * kSpectralNumFftSizes);
+    double sumSq = 0.0;
+    double windowSq = 0.0;
+    size_t windowCount = 0;
+    size_t counted = 0;
+    float minRms = 1.0e30f;
+    int index = SpectralFftSizeIndex(kSpectralFftSize);
+    int direction = 1;
+    for (size_t n = 0; n < total; ++n)
+    {
+        if (n >= warmup && (n - warmup) % kSwitchInterval == 0)
+        {
+            if (index + direction < 0 || index + direction >= static_cast<int>(kSpectralNumFftSizes))
+                direction = -direction;
+            index += direction;
+            const size_t fftSize = SpectralFftSizeAt(index);
+            s_spectral.SetFrameSize(fftSize, fftSize / 4);
+        }
+        const float phase = 2.0f * kPi * 440.0f * static_cast<float>(n) / kSampleRate;
+        const float in = 0.25f * std::sin(phase);
+        float outL = 0.0f;
+        float outR = 0.0f;
+        s_spectral.ProcessSample(in, in, runtime, 0.0f, outL, outR);
+        if (n < warmup)
+            continue;
+        sumSq += static_cast<double>(outL) * outL;
+        windowSq += static_cast<double>(outL) * outL;
+        counted++;
+        if (++windowCount == kRmsWindow)
+        {
+            minRms = std::min(minRms, std::sqrt(static_cast<float>(windowSq / kRmsWindow)));
+            windowSq = 0.0;
+            windowCount = 0;
+        }
+    }
+    const float avgRms = std::sqrt(static_cast<float>(sumSq / static_cast<double>(counted)));
+    return avgRms > 0.0f ? minRms / avgRms : 0.0f;
+}
+} // namespace
+
+int main()
+{
+    const double secondsOfAudio = static_cast<double>(kBenchSamples) / kSampleRate;
+    std::printf("Stereo notch/xmix/crossover, %zu samples, best of %d passes\n", kBenchSamples, kPasses);
+    std::printf("%6s%6s%12s%12s%12s\n", "fft", "hop", "latency ms", "us", "% realtime");
+
+    bool ok = true;
+    for (size_t i = 0; i < kSpectralNumFftSizes; ++i)
+    {
+        const size_t fftSize = SpectralFftSizeAt(static_cast<int>(i));
+        for (size_t overlap : kOverlaps)
+        {
+            const double us = BenchSize(fftSize, overlap);
+            if (us < 0.0)
+                ok = false;
+            std::printf("%6zu%6zu%12.1f%12.0f%11.1f%%\n",
+                        fftSize,
+                        fftSize / overlap,
+                        1000.0 * static_cast<double>(fftSize) / kSampleRate,
+                        us,
+                        100.0 * us * 1.0e-6 / secondsOfAudio);
+        }
+    }
+
+    const float ratio = SwitchingMinRmsRatio();
+    std::printf("Size switching: quietest 10 ms window is %.2f of average level\n",
+                static_cast<double>(ratio));
+    if (ratio < kMinRmsRatio)
+        ok = false;
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "FFT size bench failed (non-finite output or dropout on size change).\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "distortion.h"
+#include "oversampler.h"
+
+namespace
+{
+constexpr float kSampleRate = 48000.0f;
+constexpr double kPi = 3.14159265358979323846;
+constexpr size_t kDftSize = 4096;
+constexpr size_t kToneBin = 427;        // ~5 kHz, odd so aliases never land on a harmonic
+constexpr size_t kTopBin = 1280;        // 15 kHz; above it the half-band transition dominates
+constexpr size_t kSettle = 1024;        // Samples discarded before the analysis frame
+constexpr size_t kBenchSamples = 48000;
+constexpr size_t kBlockSize = 48;
+constexpr int kPasses = 5;
+constexpr float kDelayTolerance = 2.0e-3f; // Passband error after removing Latency()
+constexpr double kMinFoldGainDb = 6.0;      // Each doubling must buy at least this much
+constexpr double kMinTanhDb = 60.0;         // Smooth curves should be clean once oversampled
+
+using Clock = std::chrono::steady_clock;
+
+float Fold(float x)
+{
+    return ApplyOverdrive(ApplyWavefolder(x, 1.0f, 4), 0.3f);
+}
+
+float Tanh(float x)
+{
+    return std::tanh(4.0f * x);
+}
+
+// Harmonic-to-alias power ratio in dB below 15 kHz for a 5 kHz sine. Every
+// harmonic sits on a multiple of kToneBin; anything else that is not DC is
+// aliasing.
+template <typename Shaper>
+double AliasRejectionDb(int factorIndex, Shaper shaper)
+{
+    Oversampler os;
+    os.Init();
+    os.SetFactorIndex(factorIndex);
+
+    std::vector<float> in(kSettle + kDftSize);
+    std::vector<float> out(in.size());
+    for (size_t n = 0; n < in.size(); ++n)
+        in[n] = 0.9f * static_cast<float>(std::sin(2.0 * kPi * kToneBin * n / kDftSize));
+    os.Process(in.data(), out.data(), in.size(), shaper);
+
+    std::vector<bool> harmonic(kTopBin + 1, false);
+    for (size_t bin = kToneBin; bin <= kTopBin; bin += kToneBin)
+        harmonic[bin] = true;
+
+    double harmonicPower = 0.0;
+    double aliasPower = 0.0;
+    const float *frame = out.data() + kSettle;
+    for (size_t k = 1; k <= kTopBin; ++k)
+    {
+        double re = 0.0;
+        double im = 0.0;
+        for (size_t n = 0; n < kDftSize; ++n)
+        {
+            const double phase = 2.0 * kPi * static_cast<double>((k * n) % kDftSize) / kDftSize;
+            re += frame[n] * std::cos(phase);
+            im -= frame[n] * std::sin(phase);
+        }
+        const double power = re * re + im * im;
+        (harmonic[k] ? harmonicPower : aliasPower) += power;
+    }
+    return 10.0 * std::log10(harmonicPower / std::max(aliasPower, 1.0e-30));
+}
+
+// With a linear shaper the oversampler should be a pure delay of Latency()
+// samples for in-band material.
+float PassbandError(int factorIndex)
+{
+    Oversampler os;
+    os.Init();
+    os.SetFactorIndex(factorIndex);
+    const double freq = 1000.0;
+    const double latency = os.Latency();
+    float maxErr = 0.0f;
+    for (size_t n = 0; n < 4 * kDftSize; ++n)
+    {
+        const float in = static_cast<float>(std::sin(2.0 * kPi * freq * n / kSampleRate));
+        const float out = os.ProcessSample(in, [](float x) { return x; });
+        if (n < kSettle)
+            continue;
+        const float expected = static_cast<float>(std::sin(2.0 * kPi * freq * (n - latency) / kSampleRate));
+        maxErr = std::max(maxErr, std::fabs(out - expected));
+    }
+    return maxErr;
+}
+
+double NsPerSample(int factorIndex)
+{
+    static float in[kBenchSamples];
+    static float out[kBenchSamples];
+    srand(1);
+    for (float &v : in)
+        v = (static_cast<float>(rand()) / RAND_MAX - 0.5f) * 1.6f;
+
+    double best = 1.0e30;
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        Oversampler os;
+        os.Init();
+        os.SetFactorIndex(factorIndex);
+        const auto start = Clock::now();
+        for (size_t n = 0; n < kBenchSamples; n += kBlockSize)
+            os.Process(in + n, out + n, kBlockSize, Fold);
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        if (!std::isfinite(out[kBenchSamples - 1]))
+            return -1.0;
+    }
+    return best / kBenchSamples;
+}
+} // namespace
+
+int main()
+{
+    std::printf("Wavefolder + overdrive on a %.0f Hz sine, %zu-sample blocks\n",
+                kToneBin * kSampleRate / kDftSize, kBlockSize);
+    std::printf("Harmonic/alias ratio below 15 kHz for the folder and for tanh(4x)\n");
+    std::printf("%6s%10s%10s%10s%14s%12s\n", "factor", "latency", "fold dB", "tanh dB", "passband err", "ns/sample");
+
+    bool ok = true;
+    double previousDb = -1.0e30;
+    for (int index = 0; index <= Oversampler::kMaxFactorIndex; ++index)
+    {
+        Oversampler os;
+        os.Init();
+        os.SetFactorIndex(index);
+        const double foldDb = AliasRejectionDb(index, Fold);
+        const double tanhDb = AliasRejectionDb(index, Tanh);
+        const float passErr = PassbandError(index);
+        const double ns = NsPerSample(index);
+        const bool pass = ns >= 0.0
+                          && passErr <= kDelayTolerance
+                          && foldDb >= previousDb + kMinFoldGainDb
+                          && (index == 0 || tanhDb >= kMinTanhDb);
+        ok = ok && pass;
+        previousDb = foldDb;
+        std::printf("%5dx%10.2f%10.1f%10.1f%14.2e%12.1f%s\n",
+                    os.Factor(), static_cast<double>(os.Latency()), foldDb, tanhDb,
+                    static_cast<double>(passErr), ns, pass ? "" : "  FAIL");
+    }
+
+    if (!ok)
+    {
+        std::fprintf(stderr, "Oversampler bench failed (alias rejection, passband delay or non-finite output).\n");
+        return 1;
+    }
+    return 0;
+}
@@ -1,12 +1,26 @@
 #include "uzi_app.h"
 
+#include <algorithm>
+
+namespace
+{
+constexpr float kLoadDecay = 0.95f;
+
+// Sized for the largest FFT, which does not fit internal SRAM.
+UziSpectralBuffers DSY_SDRAM_BSS s_spectralBuffers;
+} // namespace
+
 void UziApp::Init()
 {
     hw_.Init();
     hw_.StartAdc();
 
     const float sampleRate = hw_.AudioSampleRate();
-    dsp_.Init(sampleRate);
+    dsp_.Init(sampleRate, &s_spectralBuffers);
+    ticksToLoad_ = sampleRate / static_cast<float>(daisy::System::GetTickFreq());
+    scheduler_.Init(sampleRate, daisy::System::GetTickFreq());
+    dsp_.SetMakeupCoefficients(scheduler_.SmoothingCoefficient(DistortionChannel::kMakeupSettleSeconds),
+                               scheduler_.SmoothingCoefficient(DistortionChannel::kMakeupTrackSeconds));
     ui_.Init(hw_, state_);
 
     lastHeartbeatMs_ = daisy::System::GetNow();
@@ -17,12 +31,11 @@ void UziApp::StartAudio(daisy::AudioHandle::AudioCallback cb)
     hw_.StartAudio(cb);
 }
 
+// Main loop: the encoder and menus, then the display when a frame is due.
+// Knobs and CV are read by ControlTick().
 void UziApp::Update()
 {
-    hw_.ProcessAnalogControls();
     hw_.ProcessDigitalControls();
-
-    params_.Update(hw_, state_, runtime_);
     ui_.Update(hw_, state_);
 
     const uint32_t now = daisy::System::GetNow();
@@ -32,12 +45,38 @@ void UziApp::Update()
         lastHeartbeatMs_ = now;
     }
 
-    ui_.RenderIfNeeded(hw_, state_, runtime_, heartbeatOn_, now);
+    if (!scheduler_.UiDue(daisy::System::GetTick()))
+    {
+        return;
+    }
+
+    const size_t fftSize = dsp_.FftSize();
+    status_.fftSize = static_cast<int>(fftSize);
+    status_.latencyMs = 1000.0f * static_cast<float>(fftSize) / hw_.AudioSampleRate();
+    status_.cpuLoad = cpuLoad_;
+    status_.deadlineMisses = scheduler_.DeadlineMisses();
+    ui_.Render(hw_, state_, runtime_, status_, heartbeatOn_);
+}
+
+// Audio callback, at the control rate.
+void UziApp::ControlTick()
+{
+    hw_.ProcessAnalogControls();
+    params_.Update(hw_, state_, runtime_);
+    dsp_.ControlTick();
 }
 
 void UziApp::ProcessAudio(daisy::AudioHandle::InputBuffer in,
                           daisy::AudioHandle::OutputBuffer out,
                           size_t size)
 {
+    const uint32_t start = daisy::System::GetTick();
+    for (size_t ticks = scheduler_.BeginBlock(size, start); ticks > 0; --ticks)
+    {
+        ControlTick();
+    }
     dsp_.Process(in, out, size, runtime_);
+    const uint32_t ticks = daisy::System::GetTick() - start;
+    const float load = static_cast<float>(ticks) * ticksToLoad_ / static_cast<float>(size);
+    cpuLoad_ = std::max(load, cpuLoad_ * kLoadDecay);
 }
@@ -3,6 +3,7 @@
 #include "daisy_seed.h"
 #include "kxmx_bluemchen.h"
 
+#include "control_scheduler.h"
 #include "uzi_dsp.h"
 #include "uzi_params.h"
 #include "uzi_ui.h"
@@ -19,12 +20,18 @@ public:
                       size_t size);
 
 private:
+    void ControlTick();
+
     kxmx::Bluemchen hw_{};
     UziState state_{};
     UziRuntime runtime_{};
     UziParams params_{};
     UziUi ui_{};
     UziDsp dsp_{};
+    UziStatus status_{};
+    ControlScheduler scheduler_{};
+    float ticksToLoad_ = 0.0f;
+    float cpuLoad_ = 0.0f;
 
     bool heartbeatOn_ = false;
     uint32_t lastHeartbeatMs_ = 0;
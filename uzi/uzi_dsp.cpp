@@ -8,15 +8,35 @@ namespace
 constexpr float kTwoPi = 2.0f * 3.14159265358979323846f;
 }
 
-void UziDsp::Init(float sampleRate)
+void UziDsp::Init(float sampleRate, UziSpectralBuffers *spectralBuffers)
 {
     sampleRate_ = sampleRate;
     distortionLeft_.Reset();
     distortionRight_.Reset();
-    spectral_.Init(sampleRate_);
+    spectral_.Init(sampleRate_, spectralBuffers);
     lfoPhase_ = 0.0f;
     feedbackL_ = 0.0f;
     feedbackR_ = 0.0f;
+    inPeakL_ = 0.0f;
+    inPeakR_ = 0.0f;
+    outPeakL_ = 0.0f;
+    outPeakR_ = 0.0f;
+}
+
+void UziDsp::SetMakeupCoefficients(float settle, float track)
+{
+    distortionLeft_.SetMakeupCoefficients(settle, track);
+    distortionRight_.SetMakeupCoefficients(settle, track);
+}
+
+void UziDsp::ControlTick()
+{
+    distortionLeft_.UpdateMakeup(inPeakL_, outPeakL_);
+    distortionRight_.UpdateMakeup(inPeakR_, outPeakR_);
+    inPeakL_ = 0.0f;
+    inPeakR_ = 0.0f;
+    outPeakL_ = 0.0f;
+    outPeakR_ = 0.0f;
 }
 
 void UziDsp::Process(daisy::AudioHandle::InputBuffer in,
@@ -29,28 +49,30 @@ void UziDsp::Process(daisy::AudioHandle::InputBuffer in,
     settings.depth = std::clamp(wave * 1.5f, 0.0f, 2.0f);
     settings.folds = 1 + static_cast<int>(wave * 4.0f);
     settings.overdrive = runtime.overdrive;
-
-    float inPeakL = 0.0f;
-    float inPeakR = 0.0f;
-    float outPeakL = 0.0f;
-    float outPeakR = 0.0f;
+    settings.oversample = runtime.oversample;
+    settings.adaa = runtime.adaa != 0;
+    distortionLeft_.Prepare(settings);
+    distortionRight_.Prepare(settings);
 
     const float dryMix = std::clamp(1.0f - runtime.mix, 0.0f, 1.0f);
     const float wetMix = std::clamp(runtime.mix, 0.0f, 1.0f);
 
-    size_t hopSize = 256;
+    // Block picks the overlap: 8x, 4x or 2x of the selected FFT size.
+    const size_t fftSize = SpectralFftSizeAt(runtime.fftSizeIndex);
+    size_t hopSize = fftSize / 4;
     switch (runtime.blockSize)
     {
     case 0:
-        hopSize = 128;
+        hopSize = fftSize / 8;
         break;
     case 1:
-        hopSize = 256;
+        hopSize = fftSize / 4;
         break;
     default:
-        hopSize = 512;
+        hopSize = fftSize / 2;
         break;
     }
+    spectral_.SetFrameSize(fftSize, hopSize);
 
     const float lfoHz = 0.05f + runtime.lfoFreq * 5.0f;
     const float lfoInc = kTwoPi * lfoHz / sampleRate_;
@@ -64,8 +86,8 @@ void UziDsp::Process(daisy::AudioHandle::InputBuffer in,
         const float inputL = std::clamp(dryL + feedbackL_ * feedback, -1.2f, 1.2f);
         const float inputR = std::clamp(dryR + feedbackR_ * feedback, -1.2f, 1.2f);
 
-        const float distortedL = distortionLeft_.ProcessSample(inputL, settings, inPeakL, outPeakL);
-        const float distortedR = distortionRight_.ProcessSample(inputR, settings, inPeakR, outPeakR);
+        const float distortedL = distortionLeft_.ProcessSample(inputL, settings, inPeakL_, outPeakL_);
+        const float distortedR = distortionRight_.ProcessSample(inputR, settings, inPeakR_, outPeakR_);
 
         lfoPhase_ += lfoInc;
         if (lfoPhase_ > kTwoPi)
@@ -76,7 +98,7 @@ void UziDsp::Process(daisy::AudioHandle::InputBuffer in,
 
         float wetL = 0.0f;
         float wetR = 0.0f;
-        spectral_.ProcessSample(distortedL, distortedR, runtime, lfoValue, hopSize, wetL, wetR);
+        spectral_.ProcessSample(distortedL, distortedR, runtime, lfoValue, wetL, wetR);
 
         feedbackL_ = wetL;
         feedbackR_ = wetR;
@@ -84,7 +106,4 @@ void UziDsp::Process(daisy::AudioHandle::InputBuffer in,
         out[0][i] = dryL * dryMix + wetL * wetMix;
         out[1][i] = dryR * dryMix + wetR * wetMix;
     }
-
-    distortionLeft_.UpdateMakeup(inPeakL, outPeakL);
-    distortionRight_.UpdateMakeup(inPeakR, outPeakR);
 }
@@ -8,17 +8,27 @@
 class UziDsp
 {
 public:
-    void Init(float sampleRate);
+    void Init(float sampleRate, UziSpectralBuffers *spectralBuffers);
     void Process(daisy::AudioHandle::InputBuffer in,
                  daisy::AudioHandle::OutputBuffer out,
                  size_t size,
                  const UziRuntime &runtime);
+    // Once per control tick: the distortion makeup follows the levels seen
+    // since the last tick.
+    void ControlTick();
+    void SetMakeupCoefficients(float settle, float track);
+    // Current analysis frame length, which is also the wet path's latency.
+    size_t FftSize() const { return spectral_.FftSize(); }
 
 private:
     float sampleRate_ = 48000.0f;
     float lfoPhase_ = 0.0f;
     float feedbackL_ = 0.0f;
     float feedbackR_ = 0.0f;
+    float inPeakL_ = 0.0f;
+    float inPeakR_ = 0.0f;
+    float outPeakL_ = 0.0f;
+    float outPeakR_ = 0.0f;
     DistortionChannel distortionLeft_{};
     DistortionChannel distortionRight_{};
     UziSpectralStereo spectral_{};
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <cmath>
 
+#include "oversampler.h"
+
 namespace
 {
 constexpr float kNotchMin = 0.01f;
@@ -42,10 +44,13 @@ void UziParams::Update(kxmx::Bluemchen &hw, const UziState &state, UziRuntime &r
     runtime.cutoffHz = state.cutoffHz;
     runtime.wave = state.wave;
     runtime.overdrive = state.overdrive;
+    runtime.oversample = std::clamp(state.oversample, 0, Oversampler::kMaxFactorIndex);
+    runtime.adaa = std::clamp(state.adaa, 0, 1);
     runtime.crossover = state.crossover;
     runtime.blur = state.blur;
     runtime.binRounding = state.binRounding;
     runtime.blockSize = std::clamp(state.blockSize, 0, 2);
+    runtime.fftSizeIndex = std::clamp(state.fftSizeIndex, 0, static_cast<int>(kSpectralNumFftSizes) - 1);
 
     runtime.notchDistance = MapExpo(notchControl, kNotchMin, kNotchMax) * 4.0f;
     runtime.phaseOffset = (phaseControl * 2.0f - 1.0f) * 8.0f;
@@ -9,35 +9,31 @@
 
 namespace
 {
-constexpr float kEps = 1.0e-9f;
 constexpr float kTwoPi = 2.0f * static_cast<float>(M_PI);
 constexpr float kWetGain = 0.8f;
 constexpr float kNotchDepth = 0.98f;
+constexpr float kSilenceThreshold = 1.0e-4f;  // Hop peak below ~-80 dBFS counts as silent
+constexpr float kGaussLutRange = 6.0f;        // Notch shape in sigmas; exp(-18) beyond is ~0
+constexpr float kMinWindowSum = 1.0e-2f;      // Fades in the first frame instead of dividing by ~0
+constexpr float kMaskEpsilon = 1.0e-4f;       // Notch parameter change (in bins) that rebuilds the mask
 
 float Clamp01(float value)
 {
     return std::clamp(value, 0.0f, 1.0f);
 }
 
-size_t ClampHopSize(size_t hop)
+// Notch spacing and bin rounding are tuned in bins of a 1024-point frame and
+// scaled so the comb keeps its spacing in Hz at other sizes.
+constexpr float kNotchReferenceSize = 1024.0f;
+
+size_t ClampPow2(size_t value, size_t minVal, size_t maxVal)
 {
-    if (hop == 128 || hop == 256 || hop == 512 || hop == 1024)
-    {
-        return hop;
-    }
-    if (hop < 192)
-    {
-        return 128;
-    }
-    if (hop < 384)
+    size_t result = minVal;
+    while (result < value && result < maxVal)
     {
-        return 256;
+        result <<= 1;
     }
-    if (hop < 768)
-    {
-        return 512;
-    }
-    return 1024;
+    return result;
 }
 
 float ShortestPhaseDelta(float from, float to)
@@ -51,80 +47,67 @@ float ShortestPhaseDelta(float from, float to)
 }
 }
 
-void UziSpectralStereo::Init(float sampleRate)
+void UziSpectralStereo::Init(float sampleRate, UziSpectralBuffers *buffers)
 {
     sampleRate_ = sampleRate;
+    buf_ = buffers;
     fft_.Init();
     BuildHannWindow();
+    BuildGaussLut();
+    maskRoundBins_ = 0;
 
-    cutoffBin_ = static_cast<size_t>((100.0f * static_cast<float>(kFftSize)) / sampleRate_ + 0.5f);
-    cutoffBin_ = std::min(cutoffBin_, kNumBins - 1);
+    cutoffBin_ = static_cast<size_t>((100.0f * static_cast<float>(fftSize_)) / sampleRate_ + 0.5f);
+    cutoffBin_ = std::min(cutoffBin_, numBins_ - 1);
 
-    SetHopSize(hopSize_);
+    pendingFftSize_ = fftSize_;
+    pendingHopSize_ = hopSize_;
     Reset();
 }
 
 void UziSpectralStereo::Reset()
 {
-    std::fill(&inputRing_[0][0], &inputRing_[0][kFftSize], 0.0f);
-    std::fill(&inputRing_[1][0], &inputRing_[1][kFftSize], 0.0f);
-    std::fill(&outputRing_[0][0], &outputRing_[0][kOutputBufferSize], 0.0f);
-    std::fill(&outputRing_[1][0], &outputRing_[1][kOutputBufferSize], 0.0f);
+    std::fill(&buf_->inputRing[0][0], &buf_->inputRing[0][kMaxFftSize], 0.0f);
+    std::fill(&buf_->inputRing[1][0], &buf_->inputRing[1][kMaxFftSize], 0.0f);
+    std::fill(&buf_->outputRing[0][0], &buf_->outputRing[0][kOutputBufferSize], 0.0f);
+    std::fill(&buf_->outputRing[1][0], &buf_->outputRing[1][kOutputBufferSize], 0.0f);
+    std::fill(&buf_->windowSumRing[0], &buf_->windowSumRing[kOutputBufferSize], 0.0f);
     inputWrite_ = 0;
     hopCounter_ = 0;
+    hopPeak_ = 0.0f;
+    silentHops_ = 0;
     outputRead_ = 0;
     outputWrite_ = 0;
     outputPrimed_ = false;
 }
 
-void UziSpectralStereo::SetHopSize(size_t hopSize)
+void UziSpectralStereo::SetFrameSize(size_t fftSize, size_t hopSize)
 {
-    hopSize_ = ClampHopSize(hopSize);
-    const size_t overlap = kFftSize / hopSize_;
-    for (size_t i = 0; i < hopSize_; ++i)
-    {
-        float sum = 0.0f;
-        for (size_t m = 0; m < overlap; ++m)
-        {
-            const size_t idx = i + m * hopSize_;
-            const float w = window_[idx];
-            sum += w * w;
-        }
-        overlapInv_[i] = (sum > kEps) ? (1.0f / sum) : 1.0f;
-    }
-    for (size_t i = hopSize_; i < kFftSize; ++i)
-    {
-        overlapInv_[i] = overlapInv_[i % hopSize_];
-    }
-
-    Reset();
+    pendingFftSize_ = ClampPow2(fftSize, kSpectralMinFftSize, kMaxFftSize);
+    pendingHopSize_ = ClampPow2(hopSize, pendingFftSize_ / 8, pendingFftSize_ / 2);
 }
 
 void UziSpectralStereo::ProcessSample(float inL,
                                       float inR,
                                       const UziRuntime &runtime,
                                       float lfoValue,
-                                      size_t hopSize,
                                       float &outL,
                                       float &outR)
 {
-    if (hopSize != hopSize_)
-    {
-        SetHopSize(hopSize);
-    }
-
-    inputRing_[0][inputWrite_] = inL;
-    inputRing_[1][inputWrite_] = inR;
-    inputWrite_ = (inputWrite_ + 1) % kFftSize;
+    buf_->inputRing[0][inputWrite_] = inL;
+    buf_->inputRing[1][inputWrite_] = inR;
+    inputWrite_ = (inputWrite_ + 1) % kMaxFftSize;
+    hopPeak_ = std::max(hopPeak_, std::max(std::fabs(inL), std::fabs(inR)));
 
     outL = 0.0f;
     outR = 0.0f;
     if (outputPrimed_)
     {
-        outL = outputRing_[0][outputRead_];
-        outR = outputRing_[1][outputRead_];
-        outputRing_[0][outputRead_] = 0.0f;
-        outputRing_[1][outputRead_] = 0.0f;
+        const float norm = 1.0f / std::max(buf_->windowSumRing[outputRead_], kMinWindowSum);
+        outL = buf_->outputRing[0][outputRead_] * norm;
+        outR = buf_->outputRing[1][outputRead_] * norm;
+        buf_->outputRing[0][outputRead_] = 0.0f;
+        buf_->outputRing[1][outputRead_] = 0.0f;
+        buf_->windowSumRing[outputRead_] = 0.0f;
         outputRead_ = (outputRead_ + 1) % kOutputBufferSize;
     }
 
@@ -132,86 +115,188 @@ void UziSpectralStereo::ProcessSample(float inL,
     if (hopCounter_ >= hopSize_)
     {
         hopCounter_ = 0;
+
+        // A new hop starts with this frame. Frames already in the OLA ring
+        // simply finish; the ring is normalised by the window energy that
+        // actually landed on each sample, so mixed hops still sum to unity.
+        ApplyPendingFrameSize();
+
+        silentHops_ = (hopPeak_ < kSilenceThreshold) ? silentHops_ + 1 : 0;
+        hopPeak_ = 0.0f;
+
+        // The notch mask holds no state between frames, so once a whole window
+        // of input is silent the frame would synthesise nothing. Skip it and
+        // just advance the OLA write head; the ring keeps draining as before.
+        if (outputPrimed_ && silentHops_ >= fftSize_ / hopSize_)
+        {
+            AccumulateWindowSum(outputWrite_);
+            outputWrite_ = (outputWrite_ + hopSize_) % kOutputBufferSize;
+            return;
+        }
         ProcessFrame(runtime, lfoValue);
     }
 }
 
+void UziSpectralStereo::ApplyPendingFrameSize()
+{
+    if (pendingHopSize_ != hopSize_)
+    {
+        hopSize_ = pendingHopSize_;
+        silentHops_ = 0;
+    }
+    if (pendingFftSize_ == fftSize_)
+    {
+        return;
+    }
+
+    fftSize_ = pendingFftSize_;
+    numBins_ = fftSize_ / 2 + 1;
+    windowStride_ = kMaxFftSize / fftSize_;
+    maskRoundBins_ = 0;
+    silentHops_ = 0;
+
+    // Frames of the old size are still queued at the old latency. Fade them
+    // out over one new frame, scaling the window sum with them so they keep
+    // their level until the new frames take over.
+    size_t position = outputRead_;
+    const float fadeStep = 1.0f / static_cast<float>(fftSize_);
+    for (size_t i = 0; i < kMaxFftSize; ++i)
+    {
+        const float gain = (i < fftSize_) ? 1.0f - static_cast<float>(i) * fadeStep : 0.0f;
+        buf_->outputRing[0][position] *= gain;
+        buf_->outputRing[1][position] *= gain;
+        buf_->windowSumRing[position] *= gain;
+        position = (position + 1) % kOutputBufferSize;
+    }
+}
+
 void UziSpectralStereo::BuildHannWindow()
 {
-    for (size_t i = 0; i < kFftSize; ++i)
+    for (size_t i = 0; i < kMaxFftSize; ++i)
     {
-        const float phase = static_cast<float>(i) / static_cast<float>(kFftSize);
-        window_[i] = 0.5f - 0.5f * std::cos(kTwoPi * phase);
+        const float phase = static_cast<float>(i) / static_cast<float>(kMaxFftSize);
+        buf_->window[i] = 0.5f - 0.5f * std::cos(kTwoPi * phase);
+        buf_->windowSq[i] = buf_->window[i] * buf_->window[i];
     }
 }
 
-void UziSpectralStereo::ProcessFrame(const UziRuntime &runtime, float lfoValue)
+void UziSpectralStereo::AccumulateWindowSum(size_t frameStart)
 {
-    size_t source = inputWrite_;
-    const size_t frameStart = outputWrite_;
-    for (int ch = 0; ch < 2; ++ch)
+    size_t destination = frameStart;
+    for (size_t i = 0; i < fftSize_; ++i)
     {
-        size_t idx = source;
-        for (size_t i = 0; i < kFftSize; ++i)
-        {
-            fftRe_[ch][i] = window_[i] * inputRing_[ch][idx];
-            fftIm_[ch][i] = 0.0f;
-            idx = (idx + 1) % kFftSize;
-        }
-        fft_.Execute(fftRe_[ch], fftIm_[ch], false);
-        UnpackSpectrum(ch);
-        for (size_t k = 0; k < kNumBins; ++k)
-        {
-            origRe_[ch][k] = re_[ch][k];
-            origIm_[ch][k] = im_[ch][k];
-        }
+        buf_->windowSumRing[destination] += buf_->windowSq[i * windowStride_];
+        destination = (destination + 1) % kOutputBufferSize;
+    }
+}
+
+void UziSpectralStereo::BuildGaussLut()
+{
+    for (size_t i = 0; i <= kGaussLutSize; ++i)
+    {
+        const float x = kGaussLutRange * static_cast<float>(i) / static_cast<float>(kGaussLutSize);
+        gaussLut_[i] = std::exp(-0.5f * x * x);
     }
+}
 
-    const float spacing = std::max(1.0f, runtime.notchDistance * 240.0f);
+void UziSpectralStereo::UpdateNotchMask(const UziRuntime &runtime, float lfoValue)
+{
+    const float binScale = static_cast<float>(fftSize_) / kNotchReferenceSize;
+    const float spacing = std::max(1.0f, runtime.notchDistance * 240.0f * binScale);
     const float phaseShift = (runtime.phaseOffset + lfoValue * runtime.lfoDepth * 4.0f) * spacing;
-    const int roundBins = 1 + static_cast<int>(runtime.binRounding * 24.0f);
+    const int roundBins = std::max(1, static_cast<int>(std::round(
+        static_cast<float>(1 + static_cast<int>(runtime.binRounding * 24.0f)) * binScale)));
     const float sigma = std::clamp(0.3f + runtime.blur * (spacing * 0.7f), 0.3f, spacing);
 
     const float cutoffHz = std::clamp(runtime.cutoffHz, 0.0f, 300.0f);
-    size_t cutoffBin = static_cast<size_t>((cutoffHz * static_cast<float>(kFftSize)) / sampleRate_ + 0.5f);
-    cutoffBin = std::min(cutoffBin, kNumBins - 1);
+    size_t cutoffBin = static_cast<size_t>((cutoffHz * static_cast<float>(fftSize_)) / sampleRate_ + 0.5f);
+    cutoffBin = std::min(cutoffBin, numBins_ - 1);
 
-    for (size_t k = 0; k < kNumBins; ++k)
+    const bool patternChanged = roundBins != maskRoundBins_;
+    if (patternChanged)
+    {
+        for (size_t k = 0; k < numBins_; ++k)
+        {
+            buf_->binPattern[k] = std::round(static_cast<float>(k) / static_cast<float>(roundBins))
+                             * static_cast<float>(roundBins);
+        }
+        maskRoundBins_ = roundBins;
+    }
+
+    if (!patternChanged
+        && cutoffBin == maskCutoffBin_
+        && std::fabs(spacing - maskSpacing_) < kMaskEpsilon
+        && std::fabs(phaseShift - maskPhaseShift_) < kMaskEpsilon
+        && std::fabs(sigma - maskSigma_) < kMaskEpsilon)
+    {
+        return;
+    }
+    maskSpacing_ = spacing;
+    maskPhaseShift_ = phaseShift;
+    maskSigma_ = sigma;
+    maskCutoffBin_ = cutoffBin;
+
+    // Distance to the nearest notch centre, in sigmas, indexes the gaussian
+    // table; with the bin pattern cached this is all that moves with the LFO.
+    const float invSpacing = 1.0f / spacing;
+    const float lutScale = (spacing / sigma) * (static_cast<float>(kGaussLutSize) / kGaussLutRange);
+    for (size_t k = 0; k <= cutoffBin; ++k)
+    {
+        buf_->notchMask[k] = 1.0f;
+    }
+    for (size_t k = cutoffBin + 1; k < numBins_; ++k)
     {
-        if (k <= cutoffBin)
+        const float cycles = (buf_->binPattern[k] + phaseShift) * invSpacing;
+        const float pos = std::fabs(cycles - std::floor(cycles + 0.5f)) * lutScale;
+        float notchShape = 0.0f;
+        if (pos < static_cast<float>(kGaussLutSize))
         {
-            re_[0][k] = origRe_[0][k];
-            im_[0][k] = origIm_[0][k];
-            re_[1][k] = origRe_[1][k];
-            im_[1][k] = origIm_[1][k];
-            continue;
+            const size_t i0 = static_cast<size_t>(pos);
+            const float frac = pos - static_cast<float>(i0);
+            notchShape = gaussLut_[i0] + (gaussLut_[i0 + 1] - gaussLut_[i0]) * frac;
         }
+        buf_->notchMask[k] = 1.0f - kNotchDepth * notchShape;
+    }
+}
 
-        const float binForPattern = std::round(static_cast<float>(k) / static_cast<float>(roundBins))
-                                    * static_cast<float>(roundBins);
-        const float binPhase = binForPattern + phaseShift;
-        const float notchIndex = std::round(binPhase / spacing);
-        const float center = notchIndex * spacing;
-        const float dist = std::fabs(binPhase - center);
-        const float notchShape = std::exp(-(dist * dist) / (2.0f * sigma * sigma));
-        const float scale = 1.0f - kNotchDepth * notchShape;
+void UziSpectralStereo::ProcessFrame(const UziRuntime &runtime, float lfoValue)
+{
+    // The input ring always holds kMaxFftSize samples; analyse the newest
+    // fftSize_ of them.
+    const size_t source = (inputWrite_ + kMaxFftSize - fftSize_) % kMaxFftSize;
+    const size_t frameStart = outputWrite_;
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        size_t idx = source;
+        for (size_t i = 0; i < fftSize_; ++i)
+        {
+            buf_->fftRe[ch][i] = buf_->window[i * windowStride_] * buf_->inputRing[ch][idx];
+            idx = (idx + 1) % kMaxFftSize;
+        }
+        fft_.ForwardReal(buf_->fftRe[ch], buf_->fftIm[ch], fftSize_);
+        UnpackSpectrum(ch);
+    }
 
-        for (int ch = 0; ch < 2; ++ch)
+    UpdateNotchMask(runtime, lfoValue);
+    const size_t cutoffBin = maskCutoffBin_;
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        for (size_t k = 0; k < numBins_; ++k)
         {
-            re_[ch][k] *= scale;
-            im_[ch][k] *= scale;
+            buf_->re[ch][k] *= buf_->notchMask[k];
+            buf_->im[ch][k] *= buf_->notchMask[k];
         }
     }
 
     const float xmix = Clamp01(runtime.xmix);
     if (xmix > 0.0f)
     {
-        for (size_t k = cutoffBin + 1; k < kNumBins; ++k)
+        for (size_t k = cutoffBin + 1; k < numBins_; ++k)
         {
-            const float reL = re_[0][k];
-            const float imL = im_[0][k];
-            const float reR = re_[1][k];
-            const float imR = im_[1][k];
+            const float reL = buf_->re[0][k];
+            const float imL = buf_->im[0][k];
+            const float reR = buf_->re[1][k];
+            const float imR = buf_->im[1][k];
 
             const float magL = std::sqrt(reL * reL + imL * imL);
             const float magR = std::sqrt(reR * reR + imR * imR);
@@ -223,44 +308,45 @@ void UziSpectralStereo::ProcessFrame(const UziRuntime &runtime, float lfoValue)
             const float phaseLNew = phaseL + ShortestPhaseDelta(phaseL, phaseR) * xmix;
             const float phaseRNew = phaseR + ShortestPhaseDelta(phaseR, phaseL) * xmix;
 
-            re_[0][k] = magLNew * std::cos(phaseLNew);
-            im_[0][k] = magLNew * std::sin(phaseLNew);
-            re_[1][k] = magRNew * std::cos(phaseRNew);
-            im_[1][k] = magRNew * std::sin(phaseRNew);
+            buf_->re[0][k] = magLNew * std::cos(phaseLNew);
+            buf_->im[0][k] = magLNew * std::sin(phaseLNew);
+            buf_->re[1][k] = magRNew * std::cos(phaseRNew);
+            buf_->im[1][k] = magRNew * std::sin(phaseRNew);
         }
     }
 
     const float crossover = Clamp01(runtime.crossover);
     if (crossover > 0.0f)
     {
-        for (size_t k = cutoffBin + 1; k < kNumBins; ++k)
+        for (size_t k = cutoffBin + 1; k < numBins_; ++k)
         {
-            const float reL = re_[0][k];
-            const float imL = im_[0][k];
-            const float reR = re_[1][k];
-            const float imR = im_[1][k];
-            re_[0][k] = reL * (1.0f - crossover) + reR * crossover;
-            im_[0][k] = imL * (1.0f - crossover) + imR * crossover;
-            re_[1][k] = reR * (1.0f - crossover) + reL * crossover;
-            im_[1][k] = imR * (1.0f - crossover) + imL * crossover;
+            const float reL = buf_->re[0][k];
+            const float imL = buf_->im[0][k];
+            const float reR = buf_->re[1][k];
+            const float imR = buf_->im[1][k];
+            buf_->re[0][k] = reL * (1.0f - crossover) + reR * crossover;
+            buf_->im[0][k] = imL * (1.0f - crossover) + imR * crossover;
+            buf_->re[1][k] = reR * (1.0f - crossover) + reL * crossover;
+            buf_->im[1][k] = imR * (1.0f - crossover) + imL * crossover;
         }
     }
 
     for (int ch = 0; ch < 2; ++ch)
     {
         PackSpectrum(ch);
-        fft_.Execute(fftRe_[ch], fftIm_[ch], true);
+        fft_.InverseReal(buf_->fftRe[ch], buf_->fftIm[ch], fftSize_);
 
         size_t destination = frameStart;
-        for (size_t i = 0; i < kFftSize; ++i)
+        for (size_t i = 0; i < fftSize_; ++i)
         {
-            const float norm = overlapInv_[(frameStart + i) % hopSize_];
-            const float sample = fftRe_[ch][i] * window_[i] * norm * kWetGain;
-            outputRing_[ch][destination] += sample;
+            const float sample = buf_->fftRe[ch][i] * buf_->window[i * windowStride_] * kWetGain;
+            buf_->outputRing[ch][destination] += sample;
             destination = (destination + 1) % kOutputBufferSize;
         }
     }
 
+    AccumulateWindowSum(frameStart);
+
     outputWrite_ = (outputWrite_ + hopSize_) % kOutputBufferSize;
     if (!outputPrimed_)
     {
@@ -271,30 +357,28 @@ void UziSpectralStereo::ProcessFrame(const UziRuntime &runtime, float lfoValue)
 
 void UziSpectralStereo::UnpackSpectrum(int ch)
 {
-    re_[ch][0] = fftRe_[ch][0];
-    im_[ch][0] = 0.0f;
-    re_[ch][kNumBins - 1] = fftRe_[ch][kFftSize / 2];
-    im_[ch][kNumBins - 1] = 0.0f;
-    for (size_t k = 1; k < kNumBins - 1; ++k)
+    buf_->re[ch][0] = buf_->fftRe[ch][0];
+    buf_->im[ch][0] = 0.0f;
+    buf_->re[ch][numBins_ - 1] = buf_->fftRe[ch][fftSize_ / 2];
+    buf_->im[ch][numBins_ - 1] = 0.0f;
+    for (size_t k = 1; k < numBins_ - 1; ++k)
     {
-        re_[ch][k] = fftRe_[ch][k];
-        im_[ch][k] = fftIm_[ch][k];
+        buf_->re[ch][k] = buf_->fftRe[ch][k];
+        buf_->im[ch][k] = buf_->fftIm[ch][k];
     }
 }
 
 void UziSpectralStereo::PackSpectrum(int ch)
 {
-    fftRe_[ch][0] = re_[ch][0];
-    fftIm_[ch][0] = 0.0f;
-    fftRe_[ch][kFftSize / 2] = re_[ch][kNumBins - 1];
-    fftIm_[ch][kFftSize / 2] = 0.0f;
+    buf_->fftRe[ch][0] = buf_->re[ch][0];
+    buf_->fftIm[ch][0] = 0.0f;
+    buf_->fftRe[ch][fftSize_ / 2] = buf_->re[ch][numBins_ - 1];
+    buf_->fftIm[ch][fftSize_ / 2] = 0.0f;
 
-    for (size_t k = 1; k < kNumBins - 1; ++k)
+    // The upper half of the spectrum is the backend's business.
+    for (size_t k = 1; k < numBins_ - 1; ++k)
     {
-        fftRe_[ch][k] = re_[ch][k];
-        fftIm_[ch][k] = im_[ch][k];
-        const size_t mirror = kFftSize - k;
-        fftRe_[ch][mirror] = re_[ch][k];
-        fftIm_[ch][mirror] = -im_[ch][k];
+        buf_->fftRe[ch][k] = buf_->re[ch][k];
+        buf_->fftIm[ch][k] = buf_->im[ch][k];
     }
 }
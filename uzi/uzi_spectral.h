@@ -7,49 +7,83 @@
 #include "spectral_fft.h"
 #include "uzi_state.h"
 
+constexpr size_t kUziOutputBufferSize = 2 * kSpectralMaxFftSize;
+
+// Working memory sized for the largest FFT. Plain arrays with no constructors
+// so the firmware can place it in SDRAM (DSY_SDRAM_BSS).
+struct UziSpectralBuffers
+{
+    float window[kSpectralMaxFftSize];
+    float windowSq[kSpectralMaxFftSize];
+
+    float inputRing[2][kSpectralMaxFftSize];
+    float fftRe[2][kSpectralMaxFftSize];
+    float fftIm[2][kSpectralMaxFftSize];
+
+    float re[2][kSpectralMaxNumBins];
+    float im[2][kSpectralMaxNumBins];
+
+    float notchMask[kSpectralMaxNumBins];
+    float binPattern[kSpectralMaxNumBins];
+
+    float outputRing[2][kUziOutputBufferSize];
+    float windowSumRing[kUziOutputBufferSize];
+};
+
 class UziSpectralStereo
 {
 public:
-    void Init(float sampleRate);
+    void Init(float sampleRate, UziSpectralBuffers *buffers);
     void Reset();
-    void SetHopSize(size_t hopSize);
+    // Takes effect at the next frame boundary; the OLA rings are not cleared.
+    // hopSize is clamped to fftSize / 8 .. fftSize / 2.
+    void SetFrameSize(size_t fftSize, size_t hopSize);
+    size_t FftSize() const { return fftSize_; }
 
     void ProcessSample(float inL,
                        float inR,
                        const UziRuntime &runtime,
                        float lfoValue,
-                       size_t hopSize,
                        float &outL,
                        float &outR);
 
 private:
     void BuildHannWindow();
+    void ApplyPendingFrameSize();
+    void AccumulateWindowSum(size_t frameStart);
+    void BuildGaussLut();
     void ProcessFrame(const UziRuntime &runtime, float lfoValue);
+    void UpdateNotchMask(const UziRuntime &runtime, float lfoValue);
     void UnpackSpectrum(int ch);
     void PackSpectrum(int ch);
 
+    UziSpectralBuffers *buf_ = nullptr;
+
     float sampleRate_ = 48000.0f;
-    size_t hopSize_ = 256;
+    size_t fftSize_ = kSpectralFftSize;
+    size_t numBins_ = kSpectralNumBins;
+    size_t windowStride_ = kSpectralMaxFftSize / kSpectralFftSize;
+    size_t hopSize_ = kSpectralFftSize / 4;
+    size_t pendingFftSize_ = kSpectralFftSize;
+    size_t pendingHopSize_ = kSpectralFftSize / 4;
     size_t hopCounter_ = 0;
     size_t inputWrite_ = 0;
+    float hopPeak_ = 0.0f;
+    size_t silentHops_ = 0;
 
-    static constexpr size_t kFftSize = kSpectralFftSize;
-    static constexpr size_t kNumBins = kSpectralNumBins;
-    static constexpr size_t kOutputBufferSize = 4096;
-
-    float window_[kFftSize]{};
-    float overlapInv_[kFftSize]{};
-
-    float inputRing_[2][kFftSize]{};
-    float fftRe_[2][kFftSize]{};
-    float fftIm_[2][kFftSize]{};
+    static constexpr size_t kMaxFftSize = kSpectralMaxFftSize;
+    static constexpr size_t kMaxNumBins = kSpectralMaxNumBins;
+    static constexpr size_t kOutputBufferSize = kUziOutputBufferSize;
 
-    float re_[2][kNumBins]{};
-    float im_[2][kNumBins]{};
-    float origRe_[2][kNumBins]{};
-    float origIm_[2][kNumBins]{};
+    // Notch comb gain per bin, rebuilt only when its inputs move.
+    static constexpr size_t kGaussLutSize = 512;
+    float gaussLut_[kGaussLutSize + 1]{};
+    int maskRoundBins_ = 0;
+    float maskSpacing_ = 0.0f;
+    float maskPhaseShift_ = 0.0f;
+    float maskSigma_ = 0.0f;
+    size_t maskCutoffBin_ = 0;
 
-    float outputRing_[2][kOutputBufferSize]{};
     size_t outputRead_ = 0;
     size_t outputWrite_ = 0;
     bool outputPrimed_ = false;
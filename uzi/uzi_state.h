@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+
+#include "spectral_constants.h"
+
 struct UziState
 {
     float mix = 1.0f;
@@ -11,11 +15,14 @@ struct UziState
 
     float wave = 0.0f;
     float overdrive = 0.0f;
+    int oversample = 0;
+    int adaa = 0;
 
     float crossover = 0.0f;
     float blur = 0.5f;
     float binRounding = 0.0f;
     int blockSize = 0;
+    int fftSizeIndex = SpectralFftSizeIndex(kSpectralFftSize);
 
     float notchDistance = 0.5f;
     float phaseOffset = 0.0f;
@@ -32,11 +39,14 @@ struct UziRuntime
 
     float wave = 0.0f;
     float overdrive = 0.0f;
+    int oversample = 0;
+    int adaa = 0;
 
     float crossover = 0.0f;
     float blur = 0.5f;
     float binRounding = 0.0f;
     int blockSize = 0;
+    int fftSizeIndex = SpectralFftSizeIndex(kSpectralFftSize);
 
     float notchDistance = 0.5f;
     float phaseOffset = 0.0f;
@@ -46,3 +56,12 @@ struct UziRuntime
     uint16_t rawCv1 = 0;
     uint16_t rawCv2 = 0;
 };
+
+// Audio-side figures for the status page.
+struct UziStatus
+{
+    int fftSize = static_cast<int>(kSpectralFftSize);
+    float latencyMs = 0.0f;
+    float cpuLoad = 0.0f;
+    uint32_t deadlineMisses = 0; // Control ticks run late, since boot
+};
@@ -1,9 +1,14 @@
 #include "uzi_ui.h"
 
-#include "daisy_seed.h"
+#include "oversampler.h"
 
 #include <algorithm>
 
+namespace
+{
+constexpr int kStatusPage = 3;
+}
+
 void UziUi::Init(kxmx::Bluemchen &hw, UziState &state)
 {
     cutoffHzInt_ = static_cast<int>(state.cutoffHz + 0.5f);
@@ -16,18 +21,23 @@ void UziUi::Init(kxmx::Bluemchen &hw, UziState &state)
 
     distortionItems_[0] = {"WAVE", MenuItemType::Percent, &state.wave, nullptr, 0.0f, 1.0f, 0.02f};
     distortionItems_[1] = {"ODRV", MenuItemType::Percent, &state.overdrive, nullptr, 0.0f, 1.0f, 0.02f};
+    distortionItems_[2] = {"OS", MenuItemType::Int, nullptr, &state.oversample, 0.0f,
+                           static_cast<float>(Oversampler::kMaxFactorIndex), 1.0f};
+    distortionItems_[3] = {"ADAA", MenuItemType::Int, nullptr, &state.adaa, 0.0f, 1.0f, 1.0f};
 
     fftItems_[0] = {"XOVR", MenuItemType::Percent, &state.crossover, nullptr, 0.0f, 1.0f, 0.02f};
     fftItems_[1] = {"BLUR", MenuItemType::Percent, &state.blur, nullptr, 0.0f, 1.0f, 0.02f};
     fftItems_[2] = {"BINS", MenuItemType::Percent, &state.binRounding, nullptr, 0.0f, 1.0f, 0.02f};
     fftItems_[3] = {"BLK", MenuItemType::Int, nullptr, &state.blockSize, 0.0f, 2.0f, 1.0f};
+    fftItems_[4] = {"SIZE", MenuItemType::Int, nullptr, &state.fftSizeIndex, 0.0f,
+                    static_cast<float>(kSpectralNumFftSizes - 1), 1.0f};
 
     pages_[0] = {"Master", masterItems_, sizeof(masterItems_) / sizeof(masterItems_[0])};
     pages_[1] = {"Dist", distortionItems_, sizeof(distortionItems_) / sizeof(distortionItems_[0])};
     pages_[2] = {"FFT", fftItems_, sizeof(fftItems_) / sizeof(fftItems_[0])};
+    pages_[3] = {"Stat", nullptr, 0};
 
     MenuInit(menuState_);
-    lastDisplayUpdateMs_ = daisy::System::GetNow();
 
     (void)hw;
 }
@@ -50,24 +60,31 @@ void UziUi::Update(kxmx::Bluemchen &hw, UziState &state)
     state.cutoffHz = std::clamp(static_cast<float>(cutoffHzInt_), 0.0f, 300.0f);
 }
 
-void UziUi::RenderIfNeeded(kxmx::Bluemchen &hw, const UziState &state, const UziRuntime &runtime, bool heartbeatOn, uint32_t nowMs)
+void UziUi::Render(kxmx::Bluemchen &hw,
+                   const UziState &state,
+                   const UziRuntime &runtime,
+                   const UziStatus &status,
+                   bool heartbeatOn)
 {
     (void)state;
 
-    if (nowMs - lastDisplayUpdateMs_ < 33)
-    {
-        return;
-    }
-
     const MenuPage &page = pages_[menuState_.pageIndex];
     DisplayData data;
     data.pageTitle = page.title;
     data.heartbeatOn = heartbeatOn;
     MenuBuildVisibleLines(menuState_, page, data.lines, 3, data.lineCount, data.titleSelected);
-    if (menuState_.pageIndex >= 3)
+    if (menuState_.pageIndex == kStatusPage)
+    {
+        data.status = true;
+        data.fftSize = status.fftSize;
+        data.latencyMs = status.latencyMs;
+        data.cpuLoad = status.cpuLoad;
+        data.deadlineMisses = status.deadlineMisses;
+    }
+    else if (menuState_.pageIndex > kStatusPage)
     {
         data.debug = true;
-        data.debugPage = menuState_.pageIndex - 3;
+        data.debugPage = menuState_.pageIndex - kStatusPage - 1;
         data.rawK1 = runtime.rawK1;
         data.rawK2 = runtime.rawK2;
         data.rawCv1 = runtime.rawCv1;
@@ -76,6 +93,4 @@ void UziUi::RenderIfNeeded(kxmx::Bluemchen &hw, const UziState &state, const Uzi
         data.phaseOffset = runtime.phaseOffset;
     }
     RenderDisplay(hw, data);
-
-    lastDisplayUpdateMs_ = nowMs;
 }
@@ -10,17 +10,20 @@ class UziUi
 public:
     void Init(kxmx::Bluemchen &hw, UziState &state);
     void Update(kxmx::Bluemchen &hw, UziState &state);
-    void RenderIfNeeded(kxmx::Bluemchen &hw, const UziState &state, const UziRuntime &runtime, bool heartbeatOn, uint32_t nowMs);
+    void Render(kxmx::Bluemchen &hw,
+                const UziState &state,
+                const UziRuntime &runtime,
+                const UziStatus &status,
+                bool heartbeatOn);
 
 private:
     MenuState menuState_{};
     EncoderState encoderState_{};
 
     MenuItem masterItems_[6]{};
-    MenuItem distortionItems_[2]{};
-    MenuItem fftItems_[4]{};
-    MenuPage pages_[3]{};
+    MenuItem distortionItems_[4]{};
+    MenuItem fftItems_[5]{};
+    MenuPage pages_[4]{};
 
-    uint32_t lastDisplayUpdateMs_ = 0;
     int cutoffHzInt_ = 100;
 };